@@ -35,3 +35,8 @@ AbstractCliFormatter::AbstractCliFormatter(AbstractCliIO* io)
 AbstractCliFormatter::~AbstractCliFormatter()
 {
 }
+
+QString AbstractCliFormatter::getRequestId() const
+{
+  return QString();
+}
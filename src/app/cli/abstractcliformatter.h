@@ -128,6 +128,12 @@ public:
    */
   virtual void finishWriting() = 0;
 
+  /**
+   * Get the ID of the request which is currently processed.
+   * @return request ID, empty if the request format does not have IDs.
+   */
+  virtual QString getRequestId() const;
+
 protected:
   /**
    * Access to CLI I/O.
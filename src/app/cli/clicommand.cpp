@@ -51,6 +51,7 @@
 #include "batchimporter.h"
 #include "downloadclient.h"
 #include "dirrenamer.h"
+#include "performancestatistics.h"
 
 namespace {
 
@@ -608,7 +609,9 @@ void GetCommand::startCommand()
       ? Frame::getNameForTranslatedFrameName(args().at(1))
       : QLatin1String("all");
   Frame::TagVersion tagMask = getTagMaskParameter(2);
-  if (name == QLatin1String("all")) {
+  if (cli()->isJsonLines()) {
+    cli()->writeFileInformationLines(tagMask, name);
+  } else if (name == QLatin1String("all")) {
     cli()->writeFileInformation(tagMask);
   } else {
     for (Frame::TagNumber tagNr : Frame::tagNumbersFromMask(tagMask)) {
@@ -875,8 +878,12 @@ void ExportCommand::startCommand()
         return;
       }
     }
-    if (Frame::TagVersion tagMask = getTagMaskParameter(3);
-        !cli()->app()->exportTags(tagMask, path, fmtIdx)) {
+    Frame::TagVersion tagMask = getTagMaskParameter(3);
+    if (cli()->isJsonLines() && path == QLatin1String("-")) {
+      if (!cli()->writeExportLines(tagMask, fmtIdx)) {
+        setError(tr("Error"));
+      }
+    } else if (!cli()->app()->exportTags(tagMask, path, fmtIdx)) {
       setError(tr("Error"));
     }
   } else {
@@ -1141,6 +1148,72 @@ void FilterCommand::onFileFiltered(int type, const QString& fileName)
 }
 
 
+ReplaceCommand::ReplaceCommand(Kid3Cli* processor)
+  : CliCommand(processor, QLatin1String("replace"),
+               tr("Replace text in all files"),
+               QLatin1String("S S [S]\nS = ") + tr("Find") +
+               QLatin1Char(' ') + tr("Replace") +
+               QLatin1String(" [\"case\" | \"regexp\" | \"case,regexp\"]"))
+{
+  // The duration depends on the number of files, a bulk replace must not
+  // be stopped after some of the files have been modified.
+  setTimeout(-1);
+}
+
+void ReplaceCommand::startCommand()
+{
+  if (args().size() > 2) {
+    TagSearcher::SearchFlags flags = TagSearcher::AllFrames;
+    if (args().size() > 3) {
+      const QStringList flagNames = args().at(3).split(QLatin1Char(','));
+      for (const QString& flagName : flagNames) {
+        if (flagName == QLatin1String("case")) {
+          flags |= TagSearcher::CaseSensitive;
+        } else if (flagName == QLatin1String("regexp")) {
+          flags |= TagSearcher::RegExp;
+        } else {
+          showUsage();
+          terminate();
+          return;
+        }
+      }
+    }
+    TagSearcher::Parameters params;
+    params.setSearchText(args().at(1));
+    params.setReplaceText(args().at(2));
+    params.setFlags(flags);
+    cli()->app()->bulkReplace(params);
+  } else {
+    showUsage();
+    terminate();
+  }
+}
+
+void ReplaceCommand::connectResultSignal()
+{
+  connect(cli()->app(), &Kid3Application::bulkReplaceFinished,
+          this, &ReplaceCommand::onBulkReplaceFinished);
+}
+
+void ReplaceCommand::disconnectResultSignal()
+{
+  cli()->app()->getTagSearcher()->abort();
+  disconnect(cli()->app(), &Kid3Application::bulkReplaceFinished,
+             this, &ReplaceCommand::onBulkReplaceFinished);
+}
+
+void ReplaceCommand::onBulkReplaceFinished(int numReplacements, int numFiles)
+{
+  cli()->writeResult(QVariantMap{
+    {QLatin1String("replaced"), QVariantMap{
+       {QLatin1String("count"), numReplacements},
+       {QLatin1String("files"), numFiles}
+     }}
+  });
+  terminate();
+}
+
+
 ToId3v24Command::ToId3v24Command(Kid3Cli* processor)
   : CliCommand(processor, QLatin1String("to24"), tr("Convert ID3v2.3 to ID3v2.4"))
 {
@@ -1407,6 +1480,37 @@ void ConfigCommand::startCommand()
 }
 
 
+StatsCommand::StatsCommand(Kid3Cli* processor)
+  : CliCommand(processor, QLatin1String("stats"),
+               tr("Show performance statistics"),
+               QLatin1String("[S]\nS = \"on\" | \"off\" | \"reset\""))
+{
+}
+
+void StatsCommand::startCommand()
+{
+  if (args().size() > 1) {
+    if (const QString& val = args().at(1); val == QLatin1String("on")) {
+      PerformanceStatistics::setEnabled(true);
+    } else if (val == QLatin1String("off")) {
+      PerformanceStatistics::setEnabled(false);
+    } else if (val == QLatin1String("reset")) {
+      PerformanceStatistics::reset();
+    } else {
+      showUsage();
+      return;
+    }
+  }
+  cli()->writeResult(QVariantMap{
+    {QLatin1String("statistics"), QVariantMap{
+       {QLatin1String("enabled"), PerformanceStatistics::isEnabled()},
+       {QLatin1String("operations"), PerformanceStatistics::statistics()},
+       {QLatin1String("counters"), PerformanceStatistics::counters()}
+     }}
+  });
+}
+
+
 ExecuteCommand::ExecuteCommand(Kid3Cli* processor)
   : CliCommand(processor, QLatin1String("execute"), tr("Execute command"),
                QLatin1String("S\nS = [@qml] ") + tr("Executable [arguments]"))
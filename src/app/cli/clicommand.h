@@ -508,6 +508,22 @@ private slots:
   void onFileFiltered(int type, const QString& fileName);
 };
 
+/** Replace text in all files. */
+class ReplaceCommand : public CliCommand {
+  Q_OBJECT
+public:
+  /** Constructor. */
+  explicit ReplaceCommand(Kid3Cli* processor);
+
+protected:
+  void startCommand() override;
+  void connectResultSignal() override;
+  void disconnectResultSignal() override;
+
+private slots:
+  void onBulkReplaceFinished(int numReplacements, int numFiles);
+};
+
 /** Convert ID3v2.3 to ID3v2.4. */
 class ToId3v24Command : public CliCommand {
   Q_OBJECT
@@ -607,6 +623,17 @@ protected:
   void startCommand() override;
 };
 
+/** Show performance statistics. */
+class StatsCommand : public CliCommand {
+  Q_OBJECT
+public:
+  /** Constructor. */
+  explicit StatsCommand(Kid3Cli* processor);
+
+protected:
+  void startCommand() override;
+};
+
 /** Execute command. */
 class ExecuteCommand : public CliCommand,
                        public ExternalProcess::IOutputViewer {
@@ -246,6 +246,11 @@ void JsonCliFormatter::writeResult(bool result)
   m_response.insert(QLatin1String("result"), result);
 }
 
+QString JsonCliFormatter::getRequestId() const
+{
+  return m_jsonId;
+}
+
 void JsonCliFormatter::finishWriting()
 {
   if (m_response.isEmpty()) {
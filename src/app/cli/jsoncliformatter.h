@@ -128,6 +128,12 @@ public:
    */
   void finishWriting() override;
 
+  /**
+   * Get the ID of the request which is currently processed.
+   * @return JSON-RPC ID of request, empty if not a JSON request.
+   */
+  QString getRequestId() const override;
+
 private:
   void writeErrorMessage(const QString& msg, int code);
 
@@ -26,16 +26,24 @@
 
 #include "kid3cli.h"
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
 #include <QCoreApplication>
 #include <QItemSelectionModel>
 #include <QTimer>
 #include <QStringBuilder>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include "kid3application.h"
 #include "icoreplatformtools.h"
 #include "coretaggedfileiconprovider.h"
 #include "fileproxymodel.h"
 #include "frametablemodel.h"
 #include "taggedfileselection.h"
+#include "modeliterator.h"
+#include "trackdata.h"
+#include "exportconfig.h"
 #include "clicommand.h"
 #include "cliconfig.h"
 #include "clierror.h"
@@ -177,7 +185,9 @@ Kid3Cli::Kid3Cli(Kid3Application* app,
                  AbstractCliIO* io, const QStringList& args, QObject* parent) :
   AbstractCli(io, parent),
   m_app(app), m_args(args),
-  m_tagMask(Frame::TagV2V1), m_timeoutMs(0), m_fileNameChanged(false)
+  m_tagMask(Frame::TagV2V1), m_timeoutMs(0), m_fileNameChanged(false),
+  m_jsonLines(false), m_scatterMode(false),
+  m_serverMode(false)
 {
   m_formatters << new JsonCliFormatter(io)
                << new TextCliFormatter(io);
@@ -210,6 +220,7 @@ Kid3Cli::Kid3Cli(Kid3Application* app,
          << new RenameDirectoryCommand(this)
          << new NumberTracksCommand(this)
          << new FilterCommand(this)
+         << new ReplaceCommand(this)
          << new ToId3v24Command(this)
          << new ToId3v23Command(this)
          << new TagToFilenameCommand(this)
@@ -219,7 +230,8 @@ Kid3Cli::Kid3Cli(Kid3Application* app,
          << new PasteCommand(this)
          << new RemoveCommand(this)
          << new ConfigCommand(this)
-         << new ExecuteCommand(this);
+         << new ExecuteCommand(this)
+         << new StatsCommand(this);
   connect(m_app, &Kid3Application::fileSelectionUpdateRequested,
           this, &Kid3Cli::updateSelectedFiles);
   connect(m_app, &Kid3Application::selectedFilesUpdated,
@@ -541,6 +553,18 @@ void Kid3Cli::setTagMask(Frame::TagVersion tagMask)
  */
 void Kid3Cli::writeFileList()
 {
+  if (m_jsonLines) {
+    m_app->updateCurrentSelection();
+    const QList<QPersistentModelIndex>& selLst = m_app->getCurrentSelection();
+#if QT_VERSION >= 0x050e00
+    QSet selection(selLst.constBegin(), selLst.constEnd());
+#else
+    QSet selection = selLst.toSet();
+#endif
+    writeLinesDone(writeFileListLines(m_app->getFileProxyModel(),
+                                      m_app->getRootIndex(), selection));
+    return;
+  }
   writeResult(QVariantMap{
     {QLatin1String("files"),
      listFiles(m_app->getFileProxyModel(), m_app->getRootIndex())}
@@ -597,6 +621,207 @@ QVariantList Kid3Cli::listFiles(const FileProxyModel* model,
   return lst;
 }
 
+/**
+ * Write a JSON line for each file, the tags of files which have not been
+ * read before are released after writing their line.
+ *
+ * @param model file proxy model
+ * @param parent index of parent item
+ * @param selection selected indexes
+ *
+ * @return number of lines written.
+ */
+int Kid3Cli::writeFileListLines(const FileProxyModel* model,
+                                const QModelIndex& parent,
+                                const QSet<QPersistentModelIndex>& selection)
+{
+  int count = 0;
+  for (int row = 0; row < model->rowCount(parent); ++row) {
+    QModelIndex idx(model->index(row, 0, parent));
+    QVariantMap map;
+    map.insert(QLatin1String("selected"), selection.contains(idx));
+    map.insert(QLatin1String("path"), model->filePath(idx));
+    if (TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(idx)) {
+      bool tagsRead;
+      taggedFile = readTagsTemporarily(taggedFile, tagsRead);
+      map.insert(QLatin1String("changed"), taggedFile->isChanged());
+      QVariantList tags;
+      FOR_ALL_TAGS(tagNr) {
+        if (taggedFile->hasTag(tagNr)) {
+          tags.append(1 + tagNr);
+        }
+      }
+      map.insert(QLatin1String("tags"), tags);
+      map.insert(QLatin1String("fileName"), taggedFile->getFilename());
+      if (tagsRead) {
+        taggedFile->clearTags(false);
+      }
+    } else {
+      if (QVariant value(model->data(idx)); value.isValid()) {
+        map.insert(QLatin1String("fileName"), value.toString());
+      }
+    }
+    writeResultLine(map);
+    ++count;
+    if (model->hasChildren(idx)) {
+      count += writeFileListLines(model, idx, selection);
+    }
+  }
+  return count;
+}
+
+/**
+ * Write a JSON line with the frames of each selected file,
+ * all files if no file is selected.
+ * @param tagMask tag bits (1 for tag 1, 2 for tag 2)
+ * @param name name of frame, "all" for all frames
+ */
+void Kid3Cli::writeFileInformationLines(int tagMask, const QString& name)
+{
+  // Changes in the frame tables have to be applied to the files first.
+  updateSelectedFiles();
+  m_app->updateCurrentSelection();
+  QList<TaggedFile*> taggedFiles;
+  const QList<QPersistentModelIndex>& selection =
+      m_app->getCurrentSelection();
+  for (const QPersistentModelIndex& index : selection) {
+    if (TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index)) {
+      taggedFiles.append(taggedFile);
+    }
+  }
+  if (taggedFiles.isEmpty()) {
+    TaggedFileIterator it(m_app->getRootIndex());
+    while (it.hasNext()) {
+      taggedFiles.append(it.next());
+    }
+  }
+
+  const bool allFrames = name == QLatin1String("all");
+  for (TaggedFile* taggedFile : std::as_const(taggedFiles)) {
+    bool tagsRead;
+    taggedFile = readTagsTemporarily(taggedFile, tagsRead);
+    QVariantMap map;
+    map.insert(QLatin1String("path"), taggedFile->getAbsFilename());
+    map.insert(QLatin1String("fileName"), taggedFile->getFilename());
+    FOR_TAGS_IN_MASK(tagNr, tagMask) {
+      FrameCollection frames;
+      taggedFile->getAllFrames(tagNr, frames);
+      if (allFrames) {
+        QVariantList frameList;
+        for (const Frame& frame : std::as_const(frames)) {
+          if (const QString value = frame.getValue();
+              !(tagNr == Frame::Tag_1 ? value.isEmpty() : value.isNull())) {
+            frameList.append(QVariantMap{
+              {QLatin1String("changed"), frame.isValueChanged()},
+              {QLatin1String("name"), frame.getName()},
+              {QLatin1String("value"), value},
+            });
+          }
+        }
+        if (!frameList.isEmpty()) {
+          map.insert(QLatin1String("tag") + Frame::tagNumberToString(tagNr),
+                     QVariantMap{
+                       {QLatin1String("format"),
+                        taggedFile->getTagFormat(tagNr)},
+                       {QLatin1String("frames"), frameList}
+                     });
+        }
+      } else if (auto it = frames.findByName(name); it != frames.cend()) {
+        if (const QString value = it->getValue();
+            !(tagNr == Frame::Tag_1 ? value.isEmpty() : value.isNull())) {
+          map.insert(QLatin1String("value"), value);
+          break;
+        }
+      }
+    }
+    if (tagsRead) {
+      taggedFile->clearTags(false);
+    }
+    writeResultLine(map);
+  }
+  writeLinesDone(static_cast<int>(taggedFiles.size()));
+}
+
+/**
+ * Write a JSON line with the exported text of each file in the current
+ * directory.
+ * @param tagVersion tags to export
+ * @param fmtIdx index of export format
+ * @return true if ok.
+ */
+bool Kid3Cli::writeExportLines(Frame::TagVersion tagVersion, int fmtIdx)
+{
+  const QStringList trackFmts = ExportConfig::instance().exportFormatTracks();
+  if (fmtIdx < 0 || fmtIdx >= trackFmts.size()) {
+    return false;
+  }
+  const QString& trackFmt = trackFmts.at(fmtIdx);
+  int count = 0;
+  TaggedFileOfDirectoryIterator it(m_app->currentOrRootIndex());
+  while (it.hasNext()) {
+    bool tagsRead;
+    TaggedFile* taggedFile = readTagsTemporarily(it.next(), tagsRead);
+    QString text = TrackData(*taggedFile, tagVersion).formatString(trackFmt);
+    QVariantMap map{
+      {QLatin1String("path"), taggedFile->getAbsFilename()},
+      {QLatin1String("text"), text}
+    };
+    if (tagsRead) {
+      taggedFile->clearTags(false);
+    }
+    writeResultLine(map);
+    ++count;
+  }
+  writeLinesDone(count);
+  return true;
+}
+
+/**
+ * Read the tags of a file if they have not been read yet.
+ * @param taggedFile tagged file
+ * @param tagsRead set to true if the tags had to be read, they can then be
+ * released with clearTags() when no longer needed, always false in server
+ * mode, where the tags are kept for later requests
+ * @return tagged file, can be different from @a taggedFile.
+ */
+TaggedFile* Kid3Cli::readTagsTemporarily(TaggedFile* taggedFile,
+                                         bool& tagsRead) const
+{
+  tagsRead = !m_serverMode && !taggedFile->isTagInformationRead();
+  return FileProxyModel::readTagsFromTaggedFile(taggedFile);
+}
+
+/**
+ * Write a result as a compact JSON object on a single line.
+ * The ID of the request is added as "id", so that the lines of concurrent
+ * requests to a server can be told apart.
+ * The output is flushed, so that a consumer can process it immediately.
+ * @param map result
+ */
+void Kid3Cli::writeResultLine(const QVariantMap& map)
+{
+  QJsonObject obj = QJsonObject::fromVariantMap(map);
+  if (const QString id = m_formatter->getRequestId(); !id.isEmpty()) {
+    obj.insert(QLatin1String("id"), id);
+  }
+  writeLine(QString::fromUtf8(QJsonDocument(obj)
+                              .toJson(QJsonDocument::Compact)));
+  flushStandardOutput();
+}
+
+/**
+ * Write the JSON line terminating the lines of a command, so that a
+ * consumer knows that no more lines follow, even if no file was processed.
+ * @param count number of lines written for the files
+ */
+void Kid3Cli::writeLinesDone(int count)
+{
+  writeResultLine(QVariantMap{
+    {QLatin1String("done"), true},
+    {QLatin1String("count"), count}
+  });
+}
+
 /**
  * Respond with an error message
  * @param errorCode error code
@@ -725,6 +950,13 @@ void Kid3Cli::onArgCommandFinished() {
     if (!cmd->hasError()) {
       cmd->clear();
       executeNextArgCommand();
+    } else if (m_scatterMode) {
+      m_scatterError = cmd->getErrorMessage();
+      if (m_scatterError.startsWith(QLatin1Char('_'))) {
+        m_scatterError = tr("Error");
+      }
+      cmd->clear();
+      finishScatterPath();
     } else {
       if (QString msg(cmd->getErrorMessage());
           !msg.startsWith(QLatin1Char('_'))) {
@@ -741,18 +973,37 @@ bool Kid3Cli::parseOptions()
 {
   const QStringList args = m_args.mid(1);
   QStringList paths;
+  QString pathListFile;
   bool isCommand = false;
+  bool isPathList = false;
   for (const QString& arg : args) {
     if (isCommand) {
       m_argCommands.append(arg);
       isCommand = false;
+    } else if (isPathList) {
+      pathListFile = arg;
+      isPathList = false;
     } else if (arg == QLatin1String("-c")) {
       isCommand = true;
+    } else if (arg == QLatin1String("--paths-from")) {
+      isPathList = true;
+    } else if (arg == QLatin1String("--json-lines")) {
+      m_jsonLines = true;
+    } else if (arg == QLatin1String("--serve")) {
+      // main() removes --serve together with a valid socket name, so the
+      // socket is missing or starts with '-'.
+      writeError(tr("Usage:") + QLatin1String(
+                   " kid3-cli --serve socket [--json-lines]"),
+                 CliError::Usage);
+      setReturnCode(1);
+      terminate();
+      return true;
     } else if (arg == QLatin1String("-h") || arg == QLatin1String("--help")) {
       writeLine(QLatin1String("kid3-cli " VERSION " (c) " RELEASE_YEAR
                               " Urs Fleisch"));
       writeLine(tr("Usage:") + QLatin1String(
-          " kid3-cli [-c command1] [-c command2 ...] [path ...]"));
+          " kid3-cli [--serve socket] [--json-lines] [--paths-from file]"
+          " [-c command1] [-c command2 ...] [path ...]"));
       writeHelp();
       flushStandardOutput();
       terminate();
@@ -762,6 +1013,39 @@ bool Kid3Cli::parseOptions()
     }
   }
 
+  if (!pathListFile.isEmpty()) {
+    QFile file(pathListFile);
+    if (pathListFile == QLatin1String("-")
+        ? file.open(stdin, QIODevice::ReadOnly)
+        : file.open(QIODevice::ReadOnly)) {
+      // Relative paths are resolved now because opening a path changes
+      // the current directory.
+      QTextStream stream(&file);
+      QString line;
+      while (stream.readLineInto(&line)) {
+        if (!line.isEmpty()) {
+          m_scatterPaths.append(QFileInfo(line).absoluteFilePath());
+        }
+      }
+    } else {
+      writeErrorLine(tr("%1 does not exist").arg(pathListFile));
+      setReturnCode(1);
+      terminate();
+      return true;
+    }
+    // The paths from the command line are processed after those from
+    // the list.
+    const QStringList expandedPaths = expandWildcards(paths);
+    for (const QString& path : expandedPaths) {
+      m_scatterPaths.append(QFileInfo(path).absoluteFilePath());
+    }
+    m_scatterCommands = m_argCommands;
+    m_scatterMode = true;
+    m_app->readConfig();
+    processNextScatterPath();
+    return true;
+  }
+
   if (paths.isEmpty()) {
     paths.append(QDir::currentPath());
   }
@@ -782,8 +1066,8 @@ void Kid3Cli::onInitialDirectoryOpened()
 {
   disconnect(m_app, &Kid3Application::directoryOpened,
     this, &Kid3Cli::onInitialDirectoryOpened);
-  if (!m_argCommands.isEmpty()) {
-    if (!m_app->getRootIndex().isValid()) {
+  if (!m_argCommands.isEmpty() || m_scatterMode) {
+    if (!m_app->getRootIndex().isValid() || !m_scatterError.isEmpty()) {
       // Do not execute commands if directory could not be opened.
       m_argCommands.clear();
     }
@@ -791,6 +1075,55 @@ void Kid3Cli::onInitialDirectoryOpened()
   }
 }
 
+/**
+ * Open the next path in scatter mode and execute the commands on it,
+ * terminate if all paths are processed.
+ */
+void Kid3Cli::processNextScatterPath()
+{
+  if (m_scatterPaths.isEmpty()) {
+    terminate();
+    return;
+  }
+  m_scatterPath = m_scatterPaths.takeFirst();
+  m_scatterError.clear();
+  m_argCommands = m_scatterCommands;
+  connect(m_app, &Kid3Application::directoryOpened,
+    this, &Kid3Cli::onInitialDirectoryOpened);
+  if (!openDirectory({m_scatterPath})) {
+    // directoryOpened() is nevertheless emitted.
+    m_scatterError = tr("%1 does not exist").arg(m_scatterPath);
+  }
+}
+
+/**
+ * Write the result line for the current path in scatter mode and continue
+ * with the next path.
+ */
+void Kid3Cli::finishScatterPath()
+{
+  if (!m_scatterError.isEmpty()) {
+    // Do not let changes of the failed commands be saved with the
+    // next path.
+    TaggedFileIterator it(m_app->getRootIndex());
+    while (it.hasNext()) {
+      if (TaggedFile* taggedFile = it.next(); taggedFile->isChanged()) {
+        taggedFile->readTags(true);
+      }
+    }
+    setReturnCode(1);
+  }
+  QVariantMap map{
+    {QLatin1String("path"), m_scatterPath},
+    {QLatin1String("ok"), m_scatterError.isEmpty()}
+  };
+  if (!m_scatterError.isEmpty()) {
+    map.insert(QLatin1String("error"), m_scatterError);
+  }
+  writeResultLine(map);
+  processNextScatterPath();
+}
+
 void Kid3Cli::executeNextArgCommand()
 {
   if (m_argCommands.isEmpty()) {
@@ -799,6 +1132,14 @@ void Kid3Cli::executeNextArgCommand()
       QStringList errorDescriptions;
       if (const QStringList errorFiles = m_app->saveDirectory(&errorDescriptions);
           !errorFiles.isEmpty()) {
+        if (m_scatterMode) {
+          m_scatterError = tr("Error while writing file:\n") +
+              Kid3Application::mergeStringLists(
+                errorFiles, errorDescriptions, QLatin1String(": "))
+              .join(QLatin1String("\n"));
+          finishScatterPath();
+          return;
+        }
         writeErrorLine(tr("Error while writing file:\n") +
                        Kid3Application::mergeStringLists(
                          errorFiles, errorDescriptions, QLatin1String(": "))
@@ -807,6 +1148,10 @@ void Kid3Cli::executeNextArgCommand()
         setReturnCode(1);
       }
     }
+    if (m_scatterMode) {
+      finishScatterPath();
+      return;
+    }
     terminate();
     return;
   }
@@ -820,6 +1165,12 @@ void Kid3Cli::executeNextArgCommand()
     if (errorMsg.isEmpty()) {
       errorMsg = tr("Unknown command '%1', -h for help.").arg(line);
     }
+    if (m_scatterMode) {
+      m_scatterError = errorMsg;
+      m_formatter->clear();
+      finishScatterPath();
+      return;
+    }
     writeErrorLine(errorMsg);
     finishWriting();
     setReturnCode(1);
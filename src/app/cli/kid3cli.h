@@ -26,6 +26,8 @@
 
 #pragma once
 
+#include <QSet>
+#include <QPersistentModelIndex>
 #include "abstractcli.h"
 #include "frame.h"
 #include "cliconfig.h"
@@ -36,6 +38,7 @@
 class QTimer;
 class Kid3Application;
 class FileProxyModel;
+class TaggedFile;
 class CliCommand;
 class AbstractCliFormatter;
 enum class CliError : int;
@@ -150,6 +153,41 @@ public:
    */
   void writeFileList();
 
+  /**
+   * Check if results of file commands are written as JSON lines.
+   * In this mode, which is set with the --json-lines option, commands
+   * working on multiple files write a compact JSON object for each file
+   * as soon as it is processed instead of a single result.
+   * @return true if JSON lines are written.
+   */
+  bool isJsonLines() const { return m_jsonLines; }
+
+  /**
+   * Set server mode.
+   * In server mode, requests are received from clients of a local socket
+   * (--serve option) and tags read by commands are kept in memory to answer
+   * subsequent requests faster.
+   * @param serverMode true if requests are served from a local socket
+   */
+  void setServerMode(bool serverMode) { m_serverMode = serverMode; }
+
+  /**
+   * Write a JSON line with the frames of each selected file,
+   * all files if no file is selected.
+   * @param tagMask tag bits (1 for tag 1, 2 for tag 2)
+   * @param name name of frame, "all" for all frames
+   */
+  void writeFileInformationLines(int tagMask, const QString& name);
+
+  /**
+   * Write a JSON line with the exported text of each file in the current
+   * directory.
+   * @param tagVersion tags to export
+   * @param fmtIdx index of export format
+   * @return true if ok.
+   */
+  bool writeExportLines(Frame::TagVersion tagVersion, int fmtIdx);
+
   /**
    * Respond with an error message.
    * @param errorCode error code
@@ -241,8 +279,16 @@ private:
 
   QVariantList listFiles(const FileProxyModel* model,
                            const QModelIndex& parent);
+  int writeFileListLines(const FileProxyModel* model,
+                         const QModelIndex& parent,
+                         const QSet<QPersistentModelIndex>& selection);
+  void writeResultLine(const QVariantMap& map);
+  void writeLinesDone(int count);
+  TaggedFile* readTagsTemporarily(TaggedFile* taggedFile, bool& tagsRead) const;
   bool parseOptions();
   void executeNextArgCommand();
+  void processNextScatterPath();
+  void finishScatterPath();
 
   Kid3Application* m_app;
   QStringList m_args;
@@ -253,6 +299,12 @@ private:
   QList<AbstractCliFormatter*> m_formatters;
   QList<CliCommand*> m_cmds;
   QStringList m_argCommands;
+  /** Paths to process in scatter mode (--paths-from) */
+  QStringList m_scatterPaths;
+  /** Commands executed for each path in scatter mode */
+  QStringList m_scatterCommands;
+  QString m_scatterPath;
+  QString m_scatterError;
   QString m_detailInfo;
   QString m_filename;
   QString m_tagFormat[Frame::Tag_NumValues];
@@ -260,4 +312,7 @@ private:
   /** Overwrites command timeout, -1 to switch off, 0 for defaults, else ms. */
   int m_timeoutMs;
   bool m_fileNameChanged;
+  bool m_jsonLines;
+  bool m_scatterMode;
+  bool m_serverMode;
 };
@@ -0,0 +1,178 @@
+/**
+ * \file localsocketiohandler.cpp
+ * CLI I/O Handler for clients connected to a local socket.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "localsocketiohandler.h"
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTimer>
+#include <QTextStream>
+
+/**
+ * Constructor.
+ * @param serverName path of Unix domain socket or name of named pipe
+ */
+LocalSocketIOHandler::LocalSocketIOHandler(const QString& serverName)
+  : m_serverName(serverName), m_server(nullptr), m_lineRequested(false)
+{
+}
+
+/**
+ * Start listening for clients.
+ */
+void LocalSocketIOHandler::start()
+{
+  m_server = new QLocalServer(this);
+  m_server->setSocketOptions(QLocalServer::UserAccessOption);
+  connect(m_server, &QLocalServer::newConnection,
+          this, &LocalSocketIOHandler::acceptConnections);
+  if (!m_server->listen(m_serverName) &&
+      m_server->serverError() == QAbstractSocket::AddressInUseError) {
+    // Only remove a socket file left over from a server which was not shut
+    // down, do not take over the socket of a running server.
+    QLocalSocket socket;
+    socket.connectToServer(m_serverName);
+    if (!socket.waitForConnected(1000) &&
+        socket.error() == QLocalSocket::ConnectionRefusedError) {
+      QLocalServer::removeServer(m_serverName);
+      m_server->listen(m_serverName);
+    }
+  }
+  if (!m_server->isListening()) {
+    QTextStream(stderr) << m_server->errorString() << QLatin1Char('\n');
+    emit lineReady(QString());
+    return;
+  }
+  m_lineRequested = true;
+}
+
+/**
+ * Stop the server, disconnect all clients and finally delete this object.
+ */
+void LocalSocketIOHandler::stop()
+{
+  if (m_server) {
+    const auto sockets = m_server->findChildren<QLocalSocket*>();
+    for (QLocalSocket* socket : sockets) {
+      socket->flush();
+      socket->disconnectFromServer();
+    }
+    m_server->close();
+  }
+  m_requests.clear();
+  deleteLater();
+}
+
+/**
+ * Accept new client connections.
+ */
+void LocalSocketIOHandler::acceptConnections()
+{
+  while (QLocalSocket* socket = m_server->nextPendingConnection()) {
+    connect(socket, &QLocalSocket::readyRead,
+            this, &LocalSocketIOHandler::receiveLines);
+    connect(socket, &QLocalSocket::disconnected,
+            socket, &QObject::deleteLater);
+  }
+}
+
+/**
+ * Queue complete lines received from a client.
+ */
+void LocalSocketIOHandler::receiveLines()
+{
+  auto socket = qobject_cast<QLocalSocket*>(sender());
+  if (!socket) {
+    return;
+  }
+  while (socket->canReadLine()) {
+    QString line = QString::fromUtf8(socket->readLine());
+    while (line.endsWith(QLatin1Char('\n')) ||
+           line.endsWith(QLatin1Char('\r'))) {
+      line.chop(1);
+    }
+    m_requests.enqueue({socket, line});
+  }
+  processNextRequest();
+}
+
+/**
+ * Read the next line.
+ */
+void LocalSocketIOHandler::readLine()
+{
+  m_lineRequested = true;
+  // Continue asynchronously like the standard I/O handler.
+  QTimer::singleShot(0, this, &LocalSocketIOHandler::processNextRequest);
+}
+
+/**
+ * Emit lineReady() for the next queued request if a line is requested.
+ */
+void LocalSocketIOHandler::processNextRequest()
+{
+  while (m_lineRequested && !m_requests.isEmpty()) {
+    Request request = m_requests.dequeue();
+    if (!request.socket) {
+      // Client has disconnected in the meantime.
+      continue;
+    }
+    m_currentSocket = request.socket;
+    m_lineRequested = false;
+    // A null string would be treated as end of input.
+    emit lineReady(request.line.isNull() ? QLatin1String("") : request.line);
+  }
+}
+
+/**
+ * Write a line to the client of the current request.
+ * @param line line to write
+ */
+void LocalSocketIOHandler::writeLine(const QString& line)
+{
+  if (m_currentSocket) {
+    m_currentSocket->write(line.toUtf8() + '\n');
+  }
+}
+
+/**
+ * Write a line to the client of the current request.
+ * @param line line to write
+ */
+void LocalSocketIOHandler::writeErrorLine(const QString& line)
+{
+  writeLine(line);
+}
+
+/**
+ * Flush the output to the client of the current request.
+ */
+void LocalSocketIOHandler::flushStandardOutput()
+{
+  if (m_currentSocket) {
+    m_currentSocket->flush();
+  }
+}
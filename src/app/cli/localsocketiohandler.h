@@ -0,0 +1,124 @@
+/**
+ * \file localsocketiohandler.h
+ * CLI I/O Handler for clients connected to a local socket.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QQueue>
+#include <QPointer>
+#include "abstractcli.h"
+
+class QLocalServer;
+class QLocalSocket;
+
+/**
+ * CLI I/O Handler serving clients connected to a local socket.
+ *
+ * Each client sends requests terminated by a newline, the output of a
+ * request is sent to the client from which it was received. Requests from
+ * multiple clients are processed one after the other in the order in which
+ * they arrive.
+ */
+class LocalSocketIOHandler : public AbstractCliIO {
+  Q_OBJECT
+public:
+  /**
+   * Constructor.
+   * @param serverName path of Unix domain socket or name of named pipe
+   */
+  explicit LocalSocketIOHandler(const QString& serverName);
+
+  /**
+   * Destructor.
+   */
+  ~LocalSocketIOHandler() override = default;
+
+  /**
+   * Write a line to the client of the current request.
+   * @param line line to write
+   */
+  void writeLine(const QString& line) override;
+
+  /**
+   * Write a line to the client of the current request.
+   * @param line line to write
+   */
+  void writeErrorLine(const QString& line) override;
+
+  /**
+   * Flush the output to the client of the current request.
+   */
+  void flushStandardOutput() override;
+
+  /**
+   * Read the next line.
+   * lineReady() is emitted when a request from a client is available.
+   */
+  void readLine() override;
+
+public slots:
+  /**
+   * Start listening for clients.
+   * If the server cannot be started, an error is written to standard error
+   * and lineReady() is emitted with a null string.
+   */
+  void start() override;
+
+  /**
+   * Stop the server, disconnect all clients and finally delete this object.
+   */
+  void stop() override;
+
+private slots:
+  /**
+   * Accept new client connections.
+   */
+  void acceptConnections();
+
+  /**
+   * Queue complete lines received from a client.
+   */
+  void receiveLines();
+
+  /**
+   * Emit lineReady() for the next queued request if a line is requested.
+   */
+  void processNextRequest();
+
+private:
+  /** Request received from a client. */
+  struct Request {
+    QPointer<QLocalSocket> socket;
+    QString line;
+  };
+
+  const QString m_serverName;
+  QLocalServer* m_server;
+  QQueue<Request> m_requests;
+  /** Client of the request which is currently processed */
+  QPointer<QLocalSocket> m_currentSocket;
+  bool m_lineRequested;
+};
@@ -32,6 +32,7 @@
 #include "kid3cli.h"
 #include "loadtranslation.h"
 #include "standardiohandler.h"
+#include "localsocketiohandler.h"
 #include "coreplatformtools.h"
 #include "kid3application.h"
 
@@ -88,7 +89,28 @@ int main(int argc, char* argv[])
     kid3App->activateDbusInterface();
   }
 #endif
-  Kid3Cli kid3cli(kid3App, new StandardIOHandler("kid3-cli> "), args);
+  // Remove --serve together with its socket name, the values of -c and
+  // --paths-from are skipped. Without a valid socket name, --serve is left in
+  // the arguments and reported as a usage error by Kid3Cli.
+  QString serverName;
+  for (int i = 1; i < args.size(); ++i) {
+    if (const QString& arg = args.at(i);
+        arg == QLatin1String("-c") || arg == QLatin1String("--paths-from")) {
+      ++i;
+    } else if (arg == QLatin1String("--serve")) {
+      if (i + 1 < args.size() && !args.at(i + 1).isEmpty() &&
+          !args.at(i + 1).startsWith(QLatin1Char('-'))) {
+        serverName = args.at(i + 1);
+        args.erase(args.begin() + i, args.begin() + i + 2);
+      }
+      break;
+    }
+  }
+  AbstractCliIO* io = serverName.isEmpty()
+      ? static_cast<AbstractCliIO*>(new StandardIOHandler("kid3-cli> "))
+      : new LocalSocketIOHandler(serverName);
+  Kid3Cli kid3cli(kid3App, io, args);
+  kid3cli.setServerMode(!serverName.isEmpty());
   QTimer::singleShot(0, &kid3cli, &Kid3Cli::execute);
   int rc = QCoreApplication::exec();
   delete kid3App;
@@ -294,6 +294,57 @@ void TextCliFormatter::writeResult(const QVariantMap& map)
       }
     } else if (key == QLatin1String("files")) {
       printFiles(io(), it.value().toList(), 1);
+    } else if (key == QLatin1String("replaced")) {
+      QVariantMap value = it.value().toMap();
+      io()->writeLine(tr("Replaced") % QLatin1String(": ") %
+                      value.value(QLatin1String("count")).toString() %
+                      QLatin1String(", ") % tr("Files") % QLatin1String(": ") %
+                      value.value(QLatin1String("files")).toString());
+    } else if (key == QLatin1String("statistics")) {
+      QVariantMap value = it.value().toMap();
+      io()->writeLine(tr("Statistics") % QLatin1String(": ") %
+                      (value.value(QLatin1String("enabled")).toBool()
+                       ? QLatin1String("on") : QLatin1String("off")));
+      const QVariantMap operations =
+          value.value(QLatin1String("operations")).toMap();
+      for (auto opIt = operations.constBegin();
+           opIt != operations.constEnd();
+           ++opIt) {
+        const QVariantMap op = opIt.value().toMap();
+        io()->writeLine(
+              QLatin1String("  ") % opIt.key() %
+              QLatin1String(": count=") %
+              op.value(QLatin1String("count")).toString() %
+              QLatin1String(" total=") %
+              QString::number(op.value(QLatin1String("totalMs")).toDouble(),
+                              'f', 1) %
+              QLatin1String("ms mean=") %
+              QString::number(op.value(QLatin1String("meanUs")).toDouble(),
+                              'f', 1) %
+              QLatin1String("us p50<") %
+              op.value(QLatin1String("p50Us")).toString() %
+              QLatin1String("us p90<") %
+              op.value(QLatin1String("p90Us")).toString() %
+              QLatin1String("us p99<") %
+              op.value(QLatin1String("p99Us")).toString() %
+              QLatin1String("us max=") %
+              op.value(QLatin1String("maxUs")).toString() %
+              QLatin1String("us"));
+      }
+      const QVariantMap counters =
+          value.value(QLatin1String("counters")).toMap();
+      for (auto cntIt = counters.constBegin();
+           cntIt != counters.constEnd();
+           ++cntIt) {
+        QStringList values;
+        const QVariantMap cnt = cntIt.value().toMap();
+        for (auto valIt = cnt.constBegin(); valIt != cnt.constEnd(); ++valIt) {
+          values.append(valIt.key() + QLatin1Char('=') +
+                        valIt.value().toString());
+        }
+        io()->writeLine(QLatin1String("  ") % cntIt.key() %
+                        QLatin1String(": ") % values.join(QLatin1Char(' ')));
+      }
     } else if (key == QLatin1String("timeout")) {
       QString value = it.value().toString();
       io()->writeLine(tr("Timeout") % QLatin1String(": ") % value);
@@ -60,11 +60,13 @@ int ImportConfig::s_index = -1;
 ImportConfig::ImportConfig()
   : StoredConfig(QLatin1String("Import")), m_importServer(0),
     m_importDest(Frame::TagV1), m_importFormatIdx(0),
-    m_maxTimeDifference(3),
+    m_maxTimeDifference(3), m_fingerprintWorkers(0),
+    m_fingerprintLength(120),
     m_importVisibleColumns(0x2000000000ULL),
     m_importTagsIdx(0),
     m_pictureSourceIdx(0),
-    m_enableTimeDifferenceCheck(true)
+    m_enableTimeDifferenceCheck(true),
+    m_fingerprintCacheEnabled(true)
 {
   /**
    * Preset import format regular expressions.
@@ -302,6 +304,12 @@ void ImportConfig::writeToConfig(ISettings* config) const
                    QVariant(m_enableTimeDifferenceCheck));
   config->setValue(QLatin1String("MaxTimeDifference"),
                    QVariant(m_maxTimeDifference));
+  config->setValue(QLatin1String("FingerprintWorkers"),
+                   QVariant(m_fingerprintWorkers));
+  config->setValue(QLatin1String("FingerprintLength"),
+                   QVariant(m_fingerprintLength));
+  config->setValue(QLatin1String("FingerprintCacheEnabled"),
+                   QVariant(m_fingerprintCacheEnabled));
 #ifdef Q_OS_MAC
   // Convince Mac OS X to store a 64-bit value.
   config->setValue(QLatin1String("ImportVisibleColumns"),
@@ -375,6 +383,15 @@ void ImportConfig::readFromConfig(ISettings* config)
                     m_enableTimeDifferenceCheck).toBool();
   m_maxTimeDifference = config->value(QLatin1String("MaxTimeDifference"),
                                       m_maxTimeDifference).toInt();
+  m_fingerprintWorkers = config->value(QLatin1String("FingerprintWorkers"),
+                                       m_fingerprintWorkers).toInt();
+  m_fingerprintLength = qBound(MIN_FINGERPRINT_LENGTH,
+      config->value(QLatin1String("FingerprintLength"),
+                    m_fingerprintLength).toInt(),
+      MAX_FINGERPRINT_LENGTH);
+  m_fingerprintCacheEnabled =
+      config->value(QLatin1String("FingerprintCacheEnabled"),
+                    m_fingerprintCacheEnabled).toBool();
   m_importVisibleColumns = config->value(QLatin1String("ImportVisibleColumns"),
                                          m_importVisibleColumns).toULongLong();
 #ifdef Q_OS_MAC
@@ -579,6 +596,32 @@ void ImportConfig::setMaxTimeDifference(int maxTimeDifference)
   }
 }
 
+void ImportConfig::setFingerprintWorkers(int fingerprintWorkers)
+{
+  if (m_fingerprintWorkers != fingerprintWorkers) {
+    m_fingerprintWorkers = fingerprintWorkers;
+    emit fingerprintWorkersChanged(m_fingerprintWorkers);
+  }
+}
+
+void ImportConfig::setFingerprintLength(int fingerprintLength)
+{
+  fingerprintLength = qBound(MIN_FINGERPRINT_LENGTH, fingerprintLength,
+                             MAX_FINGERPRINT_LENGTH);
+  if (m_fingerprintLength != fingerprintLength) {
+    m_fingerprintLength = fingerprintLength;
+    emit fingerprintLengthChanged(m_fingerprintLength);
+  }
+}
+
+void ImportConfig::setFingerprintCacheEnabled(bool fingerprintCacheEnabled)
+{
+  if (m_fingerprintCacheEnabled != fingerprintCacheEnabled) {
+    m_fingerprintCacheEnabled = fingerprintCacheEnabled;
+    emit fingerprintCacheEnabledChanged(m_fingerprintCacheEnabled);
+  }
+}
+
 void ImportConfig::setImportVisibleColumns(quint64 importVisibleColumns)
 {
   if (m_importVisibleColumns != importVisibleColumns) {
@@ -60,6 +60,16 @@ class KID3_CORE_EXPORT ImportConfig : public StoredConfig<ImportConfig> {
   /** maximum allowable time difference */
   Q_PROPERTY(int maxTimeDifference READ maxTimeDifference
              WRITE setMaxTimeDifference NOTIFY maxTimeDifferenceChanged)
+  /** number of files decoded concurrently for fingerprints, 0 for automatic */
+  Q_PROPERTY(int fingerprintWorkers READ fingerprintWorkers
+             WRITE setFingerprintWorkers NOTIFY fingerprintWorkersChanged)
+  /** number of seconds decoded from the start of a file for fingerprints */
+  Q_PROPERTY(int fingerprintLength READ fingerprintLength
+             WRITE setFingerprintLength NOTIFY fingerprintLengthChanged)
+  /** true to store calculated fingerprints in the cache directory */
+  Q_PROPERTY(bool fingerprintCacheEnabled READ fingerprintCacheEnabled
+             WRITE setFingerprintCacheEnabled
+             NOTIFY fingerprintCacheEnabledChanged)
   /** visible optional columns in import table */
   Q_PROPERTY(quint64 importVisibleColumns READ importVisibleColumns
              WRITE setImportVisibleColumns NOTIFY importVisibleColumnsChanged)
@@ -104,6 +114,14 @@ class KID3_CORE_EXPORT ImportConfig : public StoredConfig<ImportConfig> {
              WRITE setEnableTimeDifferenceCheck NOTIFY enableTimeDifferenceCheckChanged)
 
 public:
+  /** Minimum number of seconds decoded to calculate fingerprints. */
+  static constexpr int MIN_FINGERPRINT_LENGTH = 10;
+  /**
+   * Maximum number of seconds decoded to calculate fingerprints, keeps the
+   * number of samples of a multichannel file in a reasonable range.
+   */
+  static constexpr int MAX_FINGERPRINT_LENGTH = 3600;
+
   /**
    * Constructor.
    */
@@ -179,6 +197,38 @@ public:
   /** Set maximum allowable time difference. */
   void setMaxTimeDifference(int maxTimeDifference);
 
+  /**
+   * Get number of files decoded concurrently to calculate fingerprints.
+   * @return number of workers, 0 to use the number of processor cores.
+   */
+  int fingerprintWorkers() const { return m_fingerprintWorkers; }
+
+  /** Set number of files decoded concurrently to calculate fingerprints. */
+  void setFingerprintWorkers(int fingerprintWorkers);
+
+  /**
+   * Get number of seconds decoded from the start of a file to calculate
+   * its fingerprint.
+   * @return length in seconds.
+   */
+  int fingerprintLength() const { return m_fingerprintLength; }
+
+  /**
+   * Set number of seconds decoded to calculate fingerprints.
+   * The value is limited to the range from MIN_FINGERPRINT_LENGTH to
+   * MAX_FINGERPRINT_LENGTH.
+   */
+  void setFingerprintLength(int fingerprintLength);
+
+  /**
+   * Check if calculated fingerprints are stored in the cache directory.
+   * @return true if fingerprints are kept for later sessions.
+   */
+  bool fingerprintCacheEnabled() const { return m_fingerprintCacheEnabled; }
+
+  /** Set if calculated fingerprints are stored in the cache directory. */
+  void setFingerprintCacheEnabled(bool fingerprintCacheEnabled);
+
   /** Get visible optional columns in import table. */
   quint64 importVisibleColumns() const { return m_importVisibleColumns; }
 
@@ -298,6 +348,15 @@ signals:
   /** Emitted when @a maxTimeDifference changed. */
   void maxTimeDifferenceChanged(int maxTimeDifference);
 
+  /** Emitted when @a fingerprintWorkers changed. */
+  void fingerprintWorkersChanged(int fingerprintWorkers);
+
+  /** Emitted when @a fingerprintLength changed. */
+  void fingerprintLengthChanged(int fingerprintLength);
+
+  /** Emitted when @a fingerprintCacheEnabled changed. */
+  void fingerprintCacheEnabledChanged(bool fingerprintCacheEnabled);
+
   /** Emitted when @a importVisibleColumns changed. */
   void importVisibleColumnsChanged(quint64 importVisibleColumns);
 
@@ -354,6 +413,8 @@ private:
   QStringList m_importFormatTracks;
   int m_importFormatIdx;
   int m_maxTimeDifference;
+  int m_fingerprintWorkers;
+  int m_fingerprintLength;
   quint64 m_importVisibleColumns;
   QByteArray m_importWindowGeometry;
 
@@ -374,6 +435,7 @@ private:
 
   QStringList m_availablePlugins;
   bool m_enableTimeDifferenceCheck;
+  bool m_fingerprintCacheEnabled;
 
   /** Index in configuration storage */
   static int s_index;
@@ -47,7 +47,10 @@ int NetworkConfig::s_index = -1;
 NetworkConfig::NetworkConfig()
   : StoredConfig(QLatin1String("Network")),
     m_useProxy(false),
-    m_useProxyAuthentication(false)
+    m_useProxyAuthentication(false),
+    m_responseCacheEnabled(true),
+    m_responseCacheDays(30),
+    m_responseCacheSize(100)
 {
 }
 
@@ -66,6 +69,12 @@ void NetworkConfig::writeToConfig(ISettings* config) const
   config->setValue(QLatin1String("ProxyUserName"), QVariant(m_proxyUserName));
   config->setValue(QLatin1String("ProxyPassword"), QVariant(m_proxyPassword));
   config->setValue(QLatin1String("Browser"), QVariant(m_browser));
+  config->setValue(QLatin1String("ResponseCacheEnabled"),
+                   QVariant(m_responseCacheEnabled));
+  config->setValue(QLatin1String("ResponseCacheDays"),
+                   QVariant(m_responseCacheDays));
+  config->setValue(QLatin1String("ResponseCacheSize"),
+                   QVariant(m_responseCacheSize));
   config->endGroup();
 }
 
@@ -89,6 +98,12 @@ void NetworkConfig::readFromConfig(ISettings* config)
   if (m_browser.isEmpty()) {
     setDefaultBrowser();
   }
+  m_responseCacheEnabled = config->value(QLatin1String("ResponseCacheEnabled"),
+                                         m_responseCacheEnabled).toBool();
+  m_responseCacheDays = config->value(QLatin1String("ResponseCacheDays"),
+                                      m_responseCacheDays).toInt();
+  m_responseCacheSize = config->value(QLatin1String("ResponseCacheSize"),
+                                      m_responseCacheSize).toInt();
   config->endGroup();
 }
 
@@ -151,3 +166,27 @@ void NetworkConfig::setUseProxyAuthentication(bool useProxyAuthentication)
     emit useProxyAuthenticationChanged(m_useProxyAuthentication);
   }
 }
+
+void NetworkConfig::setResponseCacheEnabled(bool responseCacheEnabled)
+{
+  if (m_responseCacheEnabled != responseCacheEnabled) {
+    m_responseCacheEnabled = responseCacheEnabled;
+    emit responseCacheEnabledChanged(m_responseCacheEnabled);
+  }
+}
+
+void NetworkConfig::setResponseCacheDays(int responseCacheDays)
+{
+  if (m_responseCacheDays != responseCacheDays) {
+    m_responseCacheDays = responseCacheDays;
+    emit responseCacheDaysChanged(m_responseCacheDays);
+  }
+}
+
+void NetworkConfig::setResponseCacheSize(int responseCacheSize)
+{
+  if (m_responseCacheSize != responseCacheSize) {
+    m_responseCacheSize = responseCacheSize;
+    emit responseCacheSizeChanged(m_responseCacheSize);
+  }
+}
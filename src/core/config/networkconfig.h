@@ -49,6 +49,15 @@ class KID3_CORE_EXPORT NetworkConfig : public StoredConfig<NetworkConfig> {
   /** true to use proxy authentication */
   Q_PROPERTY(bool useProxyAuthentication READ useProxyAuthentication
              WRITE setUseProxyAuthentication NOTIFY useProxyAuthenticationChanged)
+  /** true to store responses of import servers in a cache */
+  Q_PROPERTY(bool responseCacheEnabled READ responseCacheEnabled
+             WRITE setResponseCacheEnabled NOTIFY responseCacheEnabledChanged)
+  /** number of days a cached response is used */
+  Q_PROPERTY(int responseCacheDays READ responseCacheDays
+             WRITE setResponseCacheDays NOTIFY responseCacheDaysChanged)
+  /** maximum size of response cache in MiB */
+  Q_PROPERTY(int responseCacheSize READ responseCacheSize
+             WRITE setResponseCacheSize NOTIFY responseCacheSizeChanged)
 
 public:
   /**
@@ -111,6 +120,24 @@ public:
   /** Set if proxy authentication is used. */
   void setUseProxyAuthentication(bool useProxyAuthentication);
 
+  /** Check if responses of import servers are stored in a cache. */
+  bool responseCacheEnabled() const { return m_responseCacheEnabled; }
+
+  /** Set if responses of import servers are stored in a cache. */
+  void setResponseCacheEnabled(bool responseCacheEnabled);
+
+  /** Get number of days a cached response is used. */
+  int responseCacheDays() const { return m_responseCacheDays; }
+
+  /** Set number of days a cached response is used. */
+  void setResponseCacheDays(int responseCacheDays);
+
+  /** Get maximum size of response cache in MiB. */
+  int responseCacheSize() const { return m_responseCacheSize; }
+
+  /** Set maximum size of response cache in MiB. */
+  void setResponseCacheSize(int responseCacheSize);
+
   /**
    * Set default web browser.
    */
@@ -135,6 +162,15 @@ signals:
   /** Emitted when @a useProxyAuthentication changed. */
   void useProxyAuthenticationChanged(bool useProxyAuthentication);
 
+  /** Emitted when @a responseCacheEnabled changed. */
+  void responseCacheEnabledChanged(bool responseCacheEnabled);
+
+  /** Emitted when @a responseCacheDays changed. */
+  void responseCacheDaysChanged(int responseCacheDays);
+
+  /** Emitted when @a responseCacheSize changed. */
+  void responseCacheSizeChanged(int responseCacheSize);
+
 private:
   friend NetworkConfig& StoredConfig<NetworkConfig>::instance();
 
@@ -144,6 +180,9 @@ private:
   QString m_browser;
   bool m_useProxy;
   bool m_useProxyAuthentication;
+  bool m_responseCacheEnabled;
+  int m_responseCacheDays;
+  int m_responseCacheSize;
 
   /** Index in configuration storage */
   static int s_index;
@@ -31,6 +31,9 @@
 #include "taggedfile.h"
 #include "frame.h"
 #include "isettings.h"
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#endif
 
 namespace {
 
@@ -237,13 +240,16 @@ TagConfig::TagConfig()
     m_trackNumberDigits(1),
     m_taggedFileFeatures(0),
     m_maximumPictureSize(131072),
+    m_maximumOpenFiles(0),
     m_markOversizedPictures(false),
     m_markStandardViolations(true),
     m_onlyCustomGenres(false),
     m_markTruncations(true),
     m_enableTotalNumberOfTracks(false),
     m_genreNotNumeric(true),
-    m_lowercaseId3RiffChunk(false)
+    m_lowercaseId3RiffChunk(false),
+    m_tagCacheEnabled(false),
+    m_tagSnapshotsEnabled(false)
 {
   m_disabledPlugins << QLatin1String("Id3libMetadata")
                     << QLatin1String("Mp4v2Metadata");
@@ -279,6 +285,12 @@ void TagConfig::writeToConfig(ISettings* config) const
                    QVariant(m_genreNotNumeric));
   config->setValue(QLatin1String("LowercaseId3RiffChunk"),
                    QVariant(m_lowercaseId3RiffChunk));
+  config->setValue(QLatin1String("TagCacheEnabled"),
+                   QVariant(m_tagCacheEnabled));
+  config->setValue(QLatin1String("TagSnapshotsEnabled"),
+                   QVariant(m_tagSnapshotsEnabled));
+  config->setValue(QLatin1String("MaximumOpenFiles"),
+                   QVariant(m_maximumOpenFiles));
   config->setValue(QLatin1String("CommentName"),
                    QVariant(m_commentName));
   config->setValue(QLatin1String("PictureNameItem"),
@@ -342,6 +354,12 @@ void TagConfig::readFromConfig(ISettings* config)
                                     m_genreNotNumeric).toBool();
   m_lowercaseId3RiffChunk = config->value(QLatin1String("LowercaseId3RiffChunk"),
                                           m_lowercaseId3RiffChunk).toBool();
+  m_tagCacheEnabled = config->value(QLatin1String("TagCacheEnabled"),
+                                    m_tagCacheEnabled).toBool();
+  m_tagSnapshotsEnabled = config->value(QLatin1String("TagSnapshotsEnabled"),
+                                        m_tagSnapshotsEnabled).toBool();
+  m_maximumOpenFiles = config->value(QLatin1String("MaximumOpenFiles"),
+                                     m_maximumOpenFiles).toInt();
   m_commentName =
       config->value(QLatin1String("CommentName"),
                     QString::fromLatin1(defaultCommentName)).toString();
@@ -494,6 +512,54 @@ void TagConfig::setLowercaseId3RiffChunk(bool lowercaseId3RiffChunk)
   }
 }
 
+/** Set true to keep tags of read files in a persistent cache. */
+void TagConfig::setTagCacheEnabled(bool tagCacheEnabled)
+{
+  if (m_tagCacheEnabled != tagCacheEnabled) {
+    m_tagCacheEnabled = tagCacheEnabled;
+    emit tagCacheEnabledChanged(m_tagCacheEnabled);
+  }
+}
+
+/** Set true to release parsed files and keep only snapshots of read tags. */
+void TagConfig::setTagSnapshotsEnabled(bool tagSnapshotsEnabled)
+{
+  if (m_tagSnapshotsEnabled != tagSnapshotsEnabled) {
+    m_tagSnapshotsEnabled = tagSnapshotsEnabled;
+    emit tagSnapshotsEnabledChanged(m_tagSnapshotsEnabled);
+  }
+}
+
+/** Set maximum number of open file handles, 0 to derive from system limit. */
+void TagConfig::setMaximumOpenFiles(int maximumOpenFiles)
+{
+  if (m_maximumOpenFiles != maximumOpenFiles) {
+    m_maximumOpenFiles = maximumOpenFiles;
+    emit maximumOpenFilesChanged(m_maximumOpenFiles);
+  }
+}
+
+/**
+ * Get the maximum number of open file handles to use.
+ * @return maximumOpenFiles() if set, else a part of the limit for open
+ * file descriptors of the process.
+ */
+int TagConfig::effectiveMaximumOpenFiles() const
+{
+  if (m_maximumOpenFiles > 0) {
+    return m_maximumOpenFiles;
+  }
+  int maxOpenFiles = 256;
+#ifdef Q_OS_UNIX
+  // Leave most descriptors for the application, network and plugins.
+  if (struct rlimit rl; getrlimit(RLIMIT_NOFILE, &rl) == 0 &&
+      rl.rlim_cur != RLIM_INFINITY) {
+    maxOpenFiles = static_cast<int>(qMin<rlim_t>(rl.rlim_cur / 4, 1024));
+  }
+#endif
+  return qMax(maxOpenFiles, 16);
+}
+
 /** Set field name used for Vorbis comment entries. */
 void TagConfig::setCommentName(const QString& commentName)
 {
@@ -63,6 +63,15 @@ class KID3_CORE_EXPORT TagConfig : public StoredConfig<TagConfig> {
   /** true to use "id3 " instead of "ID3 " chunk names in WAV files */
   Q_PROPERTY(bool lowercaseId3RiffChunk READ lowercaseId3RiffChunk
              WRITE setLowercaseId3RiffChunk NOTIFY lowercaseId3RiffChunkChanged)
+  /** true to keep tags of read files in a persistent cache */
+  Q_PROPERTY(bool tagCacheEnabled READ tagCacheEnabled
+             WRITE setTagCacheEnabled NOTIFY tagCacheEnabledChanged)
+  /** true to release parsed files and keep only snapshots of read tags */
+  Q_PROPERTY(bool tagSnapshotsEnabled READ tagSnapshotsEnabled
+             WRITE setTagSnapshotsEnabled NOTIFY tagSnapshotsEnabledChanged)
+  /** maximum number of open file handles, 0 to derive from system limit */
+  Q_PROPERTY(int maximumOpenFiles READ maximumOpenFiles
+             WRITE setMaximumOpenFiles NOTIFY maximumOpenFilesChanged)
   /** field name used for Vorbis comment entries */
   Q_PROPERTY(QString commentName READ commentName WRITE setCommentName
              NOTIFY commentNameChanged)
@@ -222,6 +231,34 @@ public:
   /** Set true to use "id3 " instead of "ID3 " chunk names in WAV files */
   void setLowercaseId3RiffChunk(bool lowercaseId3RiffChunk);
 
+  /** true to keep tags of read files in a persistent cache */
+  bool tagCacheEnabled() const { return m_tagCacheEnabled; }
+
+  /** Set true to keep tags of read files in a persistent cache. */
+  void setTagCacheEnabled(bool tagCacheEnabled);
+
+  /** true to release parsed files and keep only snapshots of read tags */
+  bool tagSnapshotsEnabled() const { return m_tagSnapshotsEnabled; }
+
+  /** Set true to release parsed files and keep only snapshots of read tags. */
+  void setTagSnapshotsEnabled(bool tagSnapshotsEnabled);
+
+  /** maximum number of open file handles, 0 to derive from system limit */
+  int maximumOpenFiles() const { return m_maximumOpenFiles; }
+
+  /**
+   * Set maximum number of open file handles.
+   * @param maximumOpenFiles maximum number, 0 to derive from system limit
+   */
+  void setMaximumOpenFiles(int maximumOpenFiles);
+
+  /**
+   * Get the maximum number of open file handles to use.
+   * @return maximumOpenFiles() if set, else a part of the limit for open
+   * file descriptors of the process.
+   */
+  int effectiveMaximumOpenFiles() const;
+
   /** field name used for Vorbis comment entries */
   QString commentName() const { return m_commentName; }
 
@@ -488,6 +525,15 @@ signals:
   /** Emitted when @a lowercaseId3RiffChunk changed. */
   void lowercaseId3RiffChunkChanged(bool lowercaseId3RiffChunk);
 
+  /** Emitted when @a tagCacheEnabled changed. */
+  void tagCacheEnabledChanged(bool tagCacheEnabled);
+
+  /** Emitted when @a tagSnapshotsEnabled changed. */
+  void tagSnapshotsEnabledChanged(bool tagSnapshotsEnabled);
+
+  /** Emitted when @a maximumOpenFiles changed. */
+  void maximumOpenFilesChanged(int maximumOpenFiles);
+
   /** Emitted when @a commentName changed. */
   void commentNameChanged(const QString& commentName);
 
@@ -557,6 +603,7 @@ private:
   QStringList m_availablePlugins;
   int m_taggedFileFeatures;
   int m_maximumPictureSize;
+  int m_maximumOpenFiles;
   bool m_markOversizedPictures;
   bool m_markStandardViolations;
   bool m_onlyCustomGenres;
@@ -564,6 +611,8 @@ private:
   bool m_enableTotalNumberOfTracks;
   bool m_genreNotNumeric;
   bool m_lowercaseId3RiffChunk;
+  bool m_tagCacheEnabled;
+  bool m_tagSnapshotsEnabled;
 
   /** Index in configuration storage */
   static int s_index;
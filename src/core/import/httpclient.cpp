@@ -30,36 +30,10 @@
 #include <QNetworkProxy>
 #include <QByteArray>
 #include <QTimer>
-#include <QDateTime>
 #include "networkconfig.h"
-
-
-/** Time when last request was sent to server */
-QMap<QString, QDateTime> HttpClient::s_lastRequestTime;
-/** Minimum interval between two requests to server in ms */
-QMap<QString, int> HttpClient::s_minimumRequestInterval;
-
-/**
- * Used to initialize the minimum interval for some servers
- * at static initialization time.
- *
- * Rate limit requests to servers, MusicBrainz and Discogs impose a limit of
- * one request per second
- * http://musicbrainz.org/doc/XML_Web_Service/Rate_Limiting#Source_IP_address
- * http://www.discogs.com/developers/accessing.html#rate-limiting
- */
-static struct MinimumRequestIntervalInitializer {
-  MinimumRequestIntervalInitializer() {
-    HttpClient::s_minimumRequestInterval[QLatin1String("musicbrainz.org")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("api.discogs.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("www.discogs.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("www.amazon.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("images.amazon.com")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("www.gnudb.org")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("gnudb.gnudb.org")] = 1000;
-    HttpClient::s_minimumRequestInterval[QLatin1String("api.acoustid.org")] = 1000;
-  }
-} minimumRequestIntervalInitializer;
+#include "httprequestscheduler.h"
+#include "httpresponsecache.h"
+#include "performancestatistics.h"
 
 /**
  * Constructor.
@@ -68,11 +42,11 @@ static struct MinimumRequestIntervalInitializer {
  */
 HttpClient::HttpClient(QNetworkAccessManager* netMgr)
   : QObject(netMgr), m_netMgr(netMgr), m_rcvBodyLen(0),
-    m_requestTimer(new QTimer(this))
+    m_scheduler(HttpRequestScheduler::instance(netMgr)),
+    m_hasRequestSlot(false), m_responseCacheEnabled(false),
+    m_hasCachedResponse(false)
 {
   setObjectName(QLatin1String("HttpClient"));
-  m_requestTimer->setSingleShot(true);
-  connect(m_requestTimer, &QTimer::timeout, this, &HttpClient::delayedSendRequest);
 }
 
 /**
@@ -80,6 +54,10 @@ HttpClient::HttpClient(QNetworkAccessManager* netMgr)
  */
 HttpClient::~HttpClient()
 {
+  if (m_scheduler) {
+    m_scheduler->cancel(this);
+  }
+  releaseRequestSlot();
   if (m_reply) {
     m_reply->close();
     m_reply->disconnect();
@@ -116,6 +94,8 @@ void HttpClient::networkReplyFinished()
           reply->deleteLater();
 
           QNetworkRequest request(redirectUrl);
+          request.setAttribute(QNetworkRequest::User,
+                               reply->request().attribute(QNetworkRequest::User));
           reply = m_netMgr->get(request);
           m_reply = reply;
           connect(reply, &QNetworkReply::finished,
@@ -135,6 +115,23 @@ void HttpClient::networkReplyFinished()
         }
       }
     }
+    if (m_requestElapsed.isValid()) {
+      PerformanceStatistics::record(PerformanceStatistics::HttpRequest,
+                                    m_requestElapsed.nsecsElapsed());
+      m_requestElapsed.invalidate();
+    }
+    if (reply == m_reply) {
+      releaseRequestSlot();
+    }
+    if (reply->error() == QNetworkReply::NoError &&
+        reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt()
+        == 200) {
+      if (QByteArray cacheKey =
+            reply->request().attribute(QNetworkRequest::User).toByteArray();
+          !cacheKey.isEmpty()) {
+        HttpResponseCache::instance().insert(cacheKey, data, m_rcvBodyType);
+      }
+    }
     emit bytesReceived(data);
     emitProgress(msg, data.size(), data.size());
     reply->deleteLater();
@@ -170,22 +167,44 @@ void HttpClient::networkReplyError(QNetworkReply::NetworkError)
  */
 void HttpClient::sendRequest(const QUrl& url, const RawHeaderMap& headers)
 {
-  QString host = url.host();
-  qint64 msSinceLastRequest;
-  int minimumRequestInterval;
-  QDateTime now = QDateTime::currentDateTime();
-  QDateTime lastRequestTime = s_lastRequestTime.value(host);
-  if (lastRequestTime.isValid() &&
-      (minimumRequestInterval = s_minimumRequestInterval.value(host)) > 0 &&
-      (msSinceLastRequest = lastRequestTime.msecsTo(now)) <
-      minimumRequestInterval) {
-    // Delay request to comply with minimum interval
-    m_delayedSendRequestContext.url = url;
-    m_delayedSendRequestContext.headers = headers;
-    m_requestTimer->start(minimumRequestInterval -
-                          static_cast<int>(msSinceLastRequest));
-    return;
+  m_hasCachedResponse = false;
+  m_cachedResponse.clear();
+  m_cacheKey.clear();
+  if (m_responseCacheEnabled && HttpResponseCache::isEnabled()) {
+    m_cacheKey = HttpResponseCache::cacheKey(url, headers);
+    if (HttpResponseCache::instance().find(m_cacheKey, m_cachedResponse,
+                                           m_rcvBodyType)) {
+      if (m_scheduler) {
+        m_scheduler->cancel(this);
+      }
+      // Emit asynchronously like a network reply.
+      m_hasCachedResponse = true;
+      QTimer::singleShot(0, this, &HttpClient::deliverCachedResponse);
+      return;
+    }
   }
+  if (m_scheduler) {
+    m_scheduler->enqueue(this, url, headers);
+  } else {
+    startRequest(QString(), url, headers);
+  }
+}
+
+/**
+ * Send a HTTP GET request when it is allowed by the scheduler.
+ *
+ * @param host host name of server, used to release the request slot
+ * @param url URL
+ * @param headers raw headers to send
+ */
+void HttpClient::startRequest(const QString& host, const QUrl& url,
+                              const RawHeaderMap& headers)
+{
+  // A slot still held by a previous request is given back, the reply of
+  // the previous request will no longer release it.
+  releaseRequestSlot();
+  m_requestSlotHost = host;
+  m_hasRequestSlot = !m_scheduler.isNull();
 
   m_rcvBodyLen = 0;
   m_rcvBodyType = QLatin1String("");
@@ -201,14 +220,25 @@ void HttpClient::sendRequest(const QUrl& url, const RawHeaderMap& headers)
     username = networkCfg.proxyUserName();
     password = networkCfg.proxyPassword();
   }
-  m_netMgr->setProxy(QNetworkProxy(proxyType, proxy,
-                                   static_cast<quint16>(proxyPort),
-                                   username, password));
+  if (QNetworkProxy networkProxy(proxyType, proxy,
+                                 static_cast<quint16>(proxyPort),
+                                 username, password);
+      m_netMgr->proxy() != networkProxy) {
+    m_netMgr->setProxy(networkProxy);
+  }
 
   QNetworkRequest request(url);
   for (auto it = headers.constBegin(); it != headers.constEnd(); ++it) {
     request.setRawHeader(it.key(), it.value());
   }
+  if (!m_cacheKey.isEmpty()) {
+    request.setAttribute(QNetworkRequest::User, m_cacheKey);
+  }
+  if (PerformanceStatistics::isEnabled()) {
+    m_requestElapsed.start();
+  } else {
+    m_requestElapsed.invalidate();
+  }
   QNetworkReply* reply = m_netMgr->get(request);
   m_reply = reply;
   connect(reply, &QNetworkReply::finished,
@@ -224,7 +254,6 @@ void HttpClient::sendRequest(const QUrl& url, const RawHeaderMap& headers)
             &QNetworkReply::error),
           this, &HttpClient::networkReplyError);
 #endif
-  s_lastRequestTime[host] = now;
   emitProgress(tr("Request sent..."), 0, 0);
 }
 
@@ -249,12 +278,32 @@ void HttpClient::sendRequest(const QString& server, const QString& path,
 }
 
 /**
- * Called to start delayed sendRequest().
+ * Called to emit a response found in the cache.
  */
-void HttpClient::delayedSendRequest()
+void HttpClient::deliverCachedResponse()
 {
-  sendRequest(m_delayedSendRequestContext.url,
-              m_delayedSendRequestContext.headers);
+  if (!m_hasCachedResponse) {
+    return;
+  }
+  m_hasCachedResponse = false;
+  const QByteArray data = m_cachedResponse;
+  m_cachedResponse.clear();
+  m_rcvBodyLen = static_cast<unsigned long>(data.size());
+  emit bytesReceived(data);
+  emitProgress(tr("Ready."), data.size(), data.size());
+}
+
+/**
+ * Tell the scheduler that the current request is finished.
+ */
+void HttpClient::releaseRequestSlot()
+{
+  if (m_hasRequestSlot) {
+    m_hasRequestSlot = false;
+    if (m_scheduler) {
+      m_scheduler->release(m_requestSlotHost);
+    }
+  }
 }
 
 /**
@@ -262,6 +311,12 @@ void HttpClient::delayedSendRequest()
  */
 void HttpClient::abort()
 {
+  // A cached response which has not yet been delivered is discarded.
+  m_hasCachedResponse = false;
+  m_cachedResponse.clear();
+  if (m_scheduler) {
+    m_scheduler->cancel(this);
+  }
   if (m_reply) {
     m_reply->abort();
   }
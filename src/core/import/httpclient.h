@@ -31,12 +31,12 @@
 #include <QNetworkReply>
 #include <QPointer>
 #include <QMap>
+#include <QElapsedTimer>
 #include "kid3api.h"
 
 class QByteArray;
 class QNetworkAccessManager;
-class QDateTime;
-class QTimer;
+class HttpRequestScheduler;
 
 /**
  * Client to connect to HTTP server.
@@ -61,6 +61,8 @@ public:
 
   /**
    * Send a HTTP GET request.
+   * The request is queued if it would exceed the limits for the server,
+   * see HttpRequestScheduler.
    *
    * @param url URL
    * @param headers optional raw headers to send
@@ -85,6 +87,16 @@ public:
    */
   void abort();
 
+  /**
+   * Enable use of the response cache.
+   * If enabled and the cache is not disabled in the configuration,
+   * successful responses are stored in the HttpResponseCache and
+   * later requests with the same URL and headers are answered from the cache.
+   *
+   * @param enable true to enable
+   */
+  void setResponseCacheEnabled(bool enable) { m_responseCacheEnabled = enable; }
+
   /**
    * Get content length.
    * @return size of body in bytes, 0 if unknown.
@@ -142,11 +154,28 @@ private slots:
   void networkReplyError(QNetworkReply::NetworkError code);
 
   /**
-   * Called to start delayed sendRequest().
+   * Called to emit a response found in the cache.
    */
-  void delayedSendRequest();
+  void deliverCachedResponse();
 
 private:
+  friend class HttpRequestScheduler;
+
+  /**
+   * Send a HTTP GET request when it is allowed by the scheduler.
+   *
+   * @param host host name of server, used to release the request slot
+   * @param url URL
+   * @param headers raw headers to send
+   */
+  void startRequest(const QString& host, const QUrl& url,
+                    const RawHeaderMap& headers);
+
+  /**
+   * Tell the scheduler that the current request is finished.
+   */
+  void releaseRequestSlot();
+
   /**
    * Emit a progress signal with step/total steps.
    *
@@ -186,18 +215,20 @@ private:
   unsigned long m_rcvBodyLen;
   /** content type */
   QString m_rcvBodyType;
-  /** Timer used to delay requests */
-  QTimer* m_requestTimer;
-  /** Context for delayedSendRequest() */
-  struct {
-    QUrl url;
-    RawHeaderMap headers;
-  } m_delayedSendRequestContext;
-
-  friend struct MinimumRequestIntervalInitializer;
-
-  /** Time when last request was sent to server */
-  static QMap<QString, QDateTime> s_lastRequestTime;
-  /** Minimum interval between two requests to server in ms */
-  static QMap<QString, int> s_minimumRequestInterval;
+  /** Scheduler for requests */
+  QPointer<HttpRequestScheduler> m_scheduler;
+  /** Host of request sent by the scheduler */
+  QString m_requestSlotHost;
+  /** Time since request was sent, invalid if statistics are disabled */
+  QElapsedTimer m_requestElapsed;
+  /** Key of current request in response cache, empty if not cached */
+  QByteArray m_cacheKey;
+  /** Response from cache to be emitted by deliverCachedResponse() */
+  QByteArray m_cachedResponse;
+  /** true if the current request holds a slot of the scheduler */
+  bool m_hasRequestSlot;
+  /** true if the response cache is used */
+  bool m_responseCacheEnabled;
+  /** true if m_cachedResponse has to be delivered */
+  bool m_hasCachedResponse;
 };
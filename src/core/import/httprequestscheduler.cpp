@@ -0,0 +1,253 @@
+/**
+ * \file httprequestscheduler.cpp
+ * Scheduler for HTTP requests with rate limits per server.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "httprequestscheduler.h"
+#include <QNetworkAccessManager>
+#include <QTimer>
+#include <QtMath>
+
+namespace {
+
+/**
+ * Maximum number of concurrent requests to servers without limits,
+ * this is the number of connections QNetworkAccessManager opens per server.
+ */
+constexpr int DEFAULT_MAX_CONCURRENT = 6;
+
+}
+
+/** Limits for servers with restrictions */
+QMap<QString, HttpRequestScheduler::HostLimits>
+HttpRequestScheduler::s_hostLimits;
+
+/**
+ * Used to initialize the limits for some servers at static initialization
+ * time.
+ *
+ * Rate limit requests to servers, MusicBrainz and Discogs impose a limit of
+ * one request per second
+ * http://musicbrainz.org/doc/XML_Web_Service/Rate_Limiting#Source_IP_address
+ * http://www.discogs.com/developers/accessing.html#rate-limiting
+ */
+static struct HostLimitsInitializer {
+  HostLimitsInitializer() {
+    static const char* const rateLimitedHosts[] = {
+      "musicbrainz.org",
+      "api.discogs.com",
+      "www.discogs.com",
+      "www.amazon.com",
+      "images.amazon.com",
+      "www.gnudb.org",
+      "gnudb.gnudb.org",
+      "api.acoustid.org"
+    };
+    for (const char* host : rateLimitedHosts) {
+      HttpRequestScheduler::setHostLimits(QString::fromLatin1(host), 1000);
+    }
+  }
+} hostLimitsInitializer;
+
+/**
+ * Constructor.
+ * @param netMgr network access manager, parent of scheduler
+ */
+HttpRequestScheduler::HttpRequestScheduler(QNetworkAccessManager* netMgr)
+  : QObject(netMgr), m_timer(new QTimer(this))
+{
+  setObjectName(QLatin1String("HttpRequestScheduler"));
+  m_timer->setSingleShot(true);
+  connect(m_timer, &QTimer::timeout, this, &HttpRequestScheduler::dispatch);
+}
+
+/**
+ * Get scheduler for a network access manager.
+ * The scheduler is created as a child of @a netMgr if it does not exist.
+ *
+ * @param netMgr network access manager
+ * @return request scheduler.
+ */
+HttpRequestScheduler* HttpRequestScheduler::instance(
+    QNetworkAccessManager* netMgr)
+{
+  auto scheduler = netMgr->findChild<HttpRequestScheduler*>(
+        QString(), Qt::FindDirectChildrenOnly);
+  if (!scheduler) {
+    scheduler = new HttpRequestScheduler(netMgr);
+  }
+  return scheduler;
+}
+
+/**
+ * Set limits for requests to a server.
+ *
+ * @param host host name of server
+ * @param minimumInterval minimum interval between two requests in ms
+ * on average, 0 if not rate limited
+ * @param burst number of requests which can be sent without delay after
+ * a period without requests
+ * @param maxConcurrent maximum number of concurrent requests
+ */
+void HttpRequestScheduler::setHostLimits(const QString& host,
+                                         int minimumInterval, int burst,
+                                         int maxConcurrent)
+{
+  s_hostLimits[host] = {qMax(minimumInterval, 0), qMax(burst, 1),
+                        qMax(maxConcurrent, 1)};
+}
+
+/**
+ * Get limits for a server.
+ * @param host host name of server
+ * @return limits.
+ */
+HttpRequestScheduler::HostLimits HttpRequestScheduler::hostLimits(
+    const QString& host)
+{
+  return s_hostLimits.value(host, {0, 1, DEFAULT_MAX_CONCURRENT});
+}
+
+/**
+ * Get state of a server, create it if it does not exist.
+ * The tokens of the server are refilled.
+ * @param host host name of server
+ * @param limits limits of server
+ * @return host state.
+ */
+HttpRequestScheduler::HostState& HttpRequestScheduler::hostState(
+    const QString& host, const HostLimits& limits)
+{
+  HostState& state = m_hosts[host];
+  if (!state.refillTimer.isValid() || limits.minimumInterval <= 0) {
+    state.tokens = limits.burst;
+    state.refillTimer.start();
+  } else if (state.tokens < limits.burst) {
+    state.tokens = qMin<double>(
+          limits.burst, state.tokens +
+          static_cast<double>(state.refillTimer.restart()) /
+          limits.minimumInterval);
+  } else {
+    state.refillTimer.restart();
+  }
+  return state;
+}
+
+/**
+ * Send a request as soon as the limits of its server allow it.
+ * If the client has already a queued request, it is replaced.
+ *
+ * @param client HTTP client which will send the request
+ * @param url URL
+ * @param headers raw headers to send
+ */
+void HttpRequestScheduler::enqueue(HttpClient* client, const QUrl& url,
+                                   const HttpClient::RawHeaderMap& headers)
+{
+  cancel(client);
+  m_hosts[url.host()].queue.append({client, url, headers});
+  dispatch();
+}
+
+/**
+ * Remove queued request of a client.
+ * @param client HTTP client
+ */
+void HttpRequestScheduler::cancel(HttpClient* client)
+{
+  for (auto it = m_hosts.begin(); it != m_hosts.end(); ++it) {
+    auto& queue = it->queue;
+    for (auto qit = queue.begin(); qit != queue.end();) {
+      if (!qit->client || qit->client == client) {
+        qit = queue.erase(qit);
+      } else {
+        ++qit;
+      }
+    }
+  }
+}
+
+/**
+ * Called when a request sent by a client is finished.
+ * @param host host name of server
+ */
+void HttpRequestScheduler::release(const QString& host)
+{
+  if (auto it = m_hosts.find(host); it != m_hosts.end() && it->active > 0) {
+    --it->active;
+  }
+  dispatch();
+}
+
+/**
+ * Send the queued requests which are allowed by the limits.
+ */
+void HttpRequestScheduler::dispatch()
+{
+  QList<QPair<QString, PendingRequest>> ready;
+  int waitMs = -1;
+  const QStringList hosts = m_hosts.keys();
+  for (const QString& host : hosts) {
+    const HostLimits limits = hostLimits(host);
+    HostState& state = hostState(host, limits);
+    while (!state.queue.isEmpty() && state.active < limits.maxConcurrent) {
+      if (!state.queue.first().client) {
+        state.queue.removeFirst();
+        continue;
+      }
+      if (limits.minimumInterval > 0) {
+        if (state.tokens < 1.0) {
+          const int ms = qCeil((1.0 - state.tokens) * limits.minimumInterval);
+          if (waitMs < 0 || ms < waitMs) {
+            waitMs = ms;
+          }
+          break;
+        }
+        state.tokens -= 1.0;
+      }
+      ++state.active;
+      ready.append({host, state.queue.takeFirst()});
+    }
+    if (state.queue.isEmpty() && state.active == 0 &&
+        state.tokens >= limits.burst) {
+      // Nothing to remember for this server.
+      m_hosts.remove(host);
+    }
+  }
+  if (waitMs >= 0) {
+    m_timer->start(waitMs);
+  }
+
+  // Send the requests after the state has been updated because
+  // enqueue() or release() can be called while a request is sent.
+  for (const auto& hostRequest : ready) {
+    const PendingRequest& request = hostRequest.second;
+    if (request.client) {
+      request.client->startRequest(hostRequest.first, request.url,
+                                   request.headers);
+    } else {
+      release(hostRequest.first);
+    }
+  }
+}
@@ -0,0 +1,155 @@
+/**
+ * \file httprequestscheduler.h
+ * Scheduler for HTTP requests with rate limits per server.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QPointer>
+#include <QUrl>
+#include <QMap>
+#include <QList>
+#include <QElapsedTimer>
+#include "httpclient.h"
+
+class QTimer;
+
+/**
+ * Schedules the requests of all HTTP clients using the same network access
+ * manager.
+ *
+ * The requests to a server are rate limited with a token bucket: A request
+ * consumes a token, tokens are added with a fixed interval up to the burst
+ * size. In addition, the number of concurrent requests to a server is
+ * limited. Requests which cannot be sent immediately are queued per server,
+ * so that requests to different servers do not wait for each other.
+ * As all requests are sent using the same network access manager,
+ * its connections are kept alive and reused for subsequent requests.
+ */
+class KID3_CORE_EXPORT HttpRequestScheduler : public QObject {
+  Q_OBJECT
+public:
+  /**
+   * Get scheduler for a network access manager.
+   * The scheduler is created as a child of @a netMgr if it does not exist.
+   *
+   * @param netMgr network access manager
+   * @return request scheduler.
+   */
+  static HttpRequestScheduler* instance(QNetworkAccessManager* netMgr);
+
+  /**
+   * Set limits for requests to a server.
+   *
+   * @param host host name of server
+   * @param minimumInterval minimum interval between two requests in ms
+   * on average, 0 if not rate limited
+   * @param burst number of requests which can be sent without delay after
+   * a period without requests
+   * @param maxConcurrent maximum number of concurrent requests
+   */
+  static void setHostLimits(const QString& host, int minimumInterval,
+                            int burst = 1, int maxConcurrent = 1);
+
+  /**
+   * Send a request as soon as the limits of its server allow it.
+   * If the client has already a queued request, it is replaced.
+   *
+   * @param client HTTP client which will send the request
+   * @param url URL
+   * @param headers raw headers to send
+   */
+  void enqueue(HttpClient* client, const QUrl& url,
+               const HttpClient::RawHeaderMap& headers);
+
+  /**
+   * Remove queued request of a client.
+   * @param client HTTP client
+   */
+  void cancel(HttpClient* client);
+
+  /**
+   * Called when a request sent by a client is finished.
+   * @param host host name of server
+   */
+  void release(const QString& host);
+
+private slots:
+  /**
+   * Send the queued requests which are allowed by the limits.
+   */
+  void dispatch();
+
+private:
+  /** Request waiting to be sent. */
+  struct PendingRequest {
+    QPointer<HttpClient> client;
+    QUrl url;
+    HttpClient::RawHeaderMap headers;
+  };
+
+  /** Limits for requests to a server. */
+  struct HostLimits {
+    int minimumInterval;
+    int burst;
+    int maxConcurrent;
+  };
+
+  /** Request state of a server. */
+  struct HostState {
+    QList<PendingRequest> queue;
+    QElapsedTimer refillTimer;
+    double tokens = 0.0;
+    int active = 0;
+  };
+
+  /**
+   * Constructor.
+   * @param netMgr network access manager, parent of scheduler
+   */
+  explicit HttpRequestScheduler(QNetworkAccessManager* netMgr);
+
+  /**
+   * Get limits for a server.
+   * @param host host name of server
+   * @return limits.
+   */
+  static HostLimits hostLimits(const QString& host);
+
+  /**
+   * Get state of a server, create it if it does not exist.
+   * The tokens of the server are refilled.
+   * @param host host name of server
+   * @param limits limits of server
+   * @return host state.
+   */
+  HostState& hostState(const QString& host, const HostLimits& limits);
+
+  QMap<QString, HostState> m_hosts;
+  QTimer* m_timer;
+
+  /** Limits for servers with restrictions */
+  static QMap<QString, HostLimits> s_hostLimits;
+};
@@ -0,0 +1,259 @@
+/**
+ * \file httpresponsecache.cpp
+ * Persistent cache for responses of import servers.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "httpresponsecache.h"
+#include <QUrl>
+#include <QFile>
+#include <QFileInfo>
+#include <QDir>
+#include <QDataStream>
+#include <QDateTime>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QCryptographicHash>
+#include "networkconfig.h"
+
+namespace {
+
+/** Magic number at the start of an entry file. */
+constexpr quint32 ENTRY_MAGIC = 0x4b334852;
+/** Version of the entry file format, increment when the format changes. */
+constexpr quint32 ENTRY_VERSION = 2;
+/** Suffix of entry files. */
+const char* const ENTRY_SUFFIX = ".resp";
+
+}
+
+/**
+ * Get cache instance.
+ * @return response cache.
+ */
+HttpResponseCache& HttpResponseCache::instance()
+{
+  static HttpResponseCache cache;
+  return cache;
+}
+
+/**
+ * Check if the cache is enabled in the configuration.
+ * @return true if enabled.
+ */
+bool HttpResponseCache::isEnabled()
+{
+  const NetworkConfig& networkCfg = NetworkConfig::instance();
+  return networkCfg.responseCacheEnabled() &&
+      networkCfg.responseCacheDays() > 0 && networkCfg.responseCacheSize() > 0;
+}
+
+/**
+ * Get key of a request.
+ *
+ * @param url URL
+ * @param headers raw headers sent with request
+ *
+ * @return key, a hash of the URL and the headers except User-Agent, which
+ * does not change the response. Only the hash is stored in the cache, so
+ * that credentials in the headers, e.g. an Authorization token, are not
+ * written to the disk.
+ */
+QByteArray HttpResponseCache::cacheKey(
+    const QUrl& url, const QMap<QByteArray, QByteArray>& headers)
+{
+  QByteArray request = url.toEncoded();
+  for (auto it = headers.constBegin(); it != headers.constEnd(); ++it) {
+    if (it.key().compare("User-Agent", Qt::CaseInsensitive) != 0) {
+      request += '\n';
+      request += it.key();
+      request += ": ";
+      request += it.value();
+    }
+  }
+  return QCryptographicHash::hash(request, QCryptographicHash::Sha256).toHex();
+}
+
+/**
+ * Get path to cache directory.
+ * @return path in cache directory, empty if not available.
+ */
+QString HttpResponseCache::cacheDirPath()
+{
+  const QString dirPath =
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return dirPath.isEmpty()
+      ? QString() : dirPath + QLatin1String("/responses");
+}
+
+/**
+ * Get path to entry file.
+ * @param key key from cacheKey()
+ * @return path to file, empty if not available.
+ */
+QString HttpResponseCache::entryFilePath(const QByteArray& key)
+{
+  const QString dirPath = cacheDirPath();
+  return dirPath.isEmpty()
+      ? QString()
+      : dirPath + QLatin1Char('/') + QString::fromLatin1(
+          QCryptographicHash::hash(key, QCryptographicHash::Sha1).toHex()) +
+        QLatin1String(ENTRY_SUFFIX);
+}
+
+/**
+ * Get a cached response.
+ *
+ * @param key key from cacheKey()
+ * @param data the response body is returned here
+ * @param contentType the MIME type of the response is returned here
+ *
+ * @return true if an entry which is not expired was found.
+ */
+bool HttpResponseCache::find(const QByteArray& key, QByteArray& data,
+                             QString& contentType)
+{
+  if (!isEnabled()) {
+    return false;
+  }
+  const QString filePath = entryFilePath(key);
+  QFile file(filePath);
+  if (filePath.isEmpty() || !file.open(QIODevice::ReadOnly)) {
+    return false;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  quint32 magic, version;
+  QByteArray storedKey;
+  qint64 storedMs;
+  stream >> magic >> version;
+  if (stream.status() != QDataStream::Ok ||
+      magic != ENTRY_MAGIC || version != ENTRY_VERSION) {
+    if (stream.status() == QDataStream::Ok && magic == ENTRY_MAGIC &&
+        version < ENTRY_VERSION) {
+      // Entries of version 1 contain the request headers in plain text.
+      file.close();
+      file.remove();
+    }
+    return false;
+  }
+  stream >> storedKey >> storedMs >> contentType >> data;
+  if (stream.status() != QDataStream::Ok || storedKey != key) {
+    data.clear();
+    contentType.clear();
+    return false;
+  }
+  const qint64 maxAgeMs = static_cast<qint64>(
+        NetworkConfig::instance().responseCacheDays()) * 24 * 3600 * 1000;
+  if (QDateTime::currentMSecsSinceEpoch() - storedMs > maxAgeMs) {
+    file.close();
+    const qint64 size = file.size();
+    if (file.remove() && m_totalSize >= size) {
+      m_totalSize -= size;
+    }
+    data.clear();
+    contentType.clear();
+    return false;
+  }
+  return true;
+}
+
+/**
+ * Store a response.
+ *
+ * @param key key from cacheKey()
+ * @param data response body
+ * @param contentType MIME type of response
+ */
+void HttpResponseCache::insert(const QByteArray& key, const QByteArray& data,
+                               const QString& contentType)
+{
+  if (!isEnabled()) {
+    return;
+  }
+  const QString filePath = entryFilePath(key);
+  if (filePath.isEmpty() || !QDir().mkpath(QFileInfo(filePath).path())) {
+    return;
+  }
+  const qint64 oldSize = QFileInfo(filePath).size();
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << ENTRY_MAGIC << ENTRY_VERSION << key
+         << QDateTime::currentMSecsSinceEpoch() << contentType << data;
+  if (stream.status() == QDataStream::Ok && file.commit()) {
+    if (m_totalSize >= 0) {
+      m_totalSize += QFileInfo(filePath).size() - oldSize;
+    }
+    limitSize();
+  }
+}
+
+/**
+ * Remove all entries.
+ */
+void HttpResponseCache::clear()
+{
+  if (const QString dirPath = cacheDirPath(); !dirPath.isEmpty()) {
+    QDir(dirPath).removeRecursively();
+  }
+  m_totalSize = 0;
+}
+
+/**
+ * Remove the least recently stored entries until the cache size is below
+ * the configured maximum size.
+ */
+void HttpResponseCache::limitSize()
+{
+  const qint64 maxSize =
+      static_cast<qint64>(NetworkConfig::instance().responseCacheSize())
+      * 1024 * 1024;
+  if (m_totalSize >= 0 && m_totalSize <= maxSize) {
+    return;
+  }
+  QDir dir(cacheDirPath());
+  const QFileInfoList fileInfos = dir.entryInfoList(
+        {QLatin1Char('*') + QLatin1String(ENTRY_SUFFIX)}, QDir::Files,
+        QDir::Time);
+  m_totalSize = 0;
+  for (const QFileInfo& fi : fileInfos) {
+    m_totalSize += fi.size();
+  }
+  if (m_totalSize <= maxSize) {
+    return;
+  }
+  // Remove the oldest entries until 90% of the maximum size are reached
+  // to avoid scanning the directory for each stored response.
+  const qint64 targetSize = maxSize - maxSize / 10;
+  for (auto it = fileInfos.crbegin();
+       it != fileInfos.crend() && m_totalSize > targetSize;
+       ++it) {
+    if (QFile::remove(it->filePath())) {
+      m_totalSize -= it->size();
+    }
+  }
+}
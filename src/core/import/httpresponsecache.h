@@ -0,0 +1,128 @@
+/**
+ * \file httpresponsecache.h
+ * Persistent cache for responses of import servers.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QMap>
+#include "kid3api.h"
+
+class QUrl;
+
+/**
+ * Cache for responses of HTTP GET requests stored in the cache directory.
+ *
+ * The responses are stored in a file per request, named after a hash of the
+ * URL and the request headers. An entry is used for the number of days
+ * configured in NetworkConfig::responseCacheDays(). If the total size
+ * of the entries exceeds NetworkConfig::responseCacheSize(), the least
+ * recently stored entries are removed. Servers are not asked for newer
+ * data, so a cached response has no rate limit delay.
+ * Only used from the main thread.
+ */
+class KID3_CORE_EXPORT HttpResponseCache {
+public:
+  /**
+   * Get cache instance.
+   * @return response cache.
+   */
+  static HttpResponseCache& instance();
+
+  /**
+   * Check if the cache is enabled in the configuration.
+   * @return true if enabled.
+   */
+  static bool isEnabled();
+
+  /**
+   * Get key of a request.
+   *
+   * @param url URL
+   * @param headers raw headers sent with request
+   *
+   * @return key, a hash of the URL and the headers except User-Agent, which
+   * does not change the response. Only the hash is stored in the cache, so
+   * that credentials in the headers, e.g. an Authorization token, are not
+   * written to the disk.
+   */
+  static QByteArray cacheKey(const QUrl& url,
+                             const QMap<QByteArray, QByteArray>& headers);
+
+  /**
+   * Get a cached response.
+   *
+   * @param key key from cacheKey()
+   * @param data the response body is returned here
+   * @param contentType the MIME type of the response is returned here
+   *
+   * @return true if an entry which is not expired was found.
+   */
+  bool find(const QByteArray& key, QByteArray& data, QString& contentType);
+
+  /**
+   * Store a response.
+   *
+   * @param key key from cacheKey()
+   * @param data response body
+   * @param contentType MIME type of response
+   */
+  void insert(const QByteArray& key, const QByteArray& data,
+              const QString& contentType);
+
+  /**
+   * Remove all entries.
+   */
+  void clear();
+
+private:
+  HttpResponseCache() = default;
+  ~HttpResponseCache() = default;
+  HttpResponseCache(const HttpResponseCache&) = delete;
+  HttpResponseCache& operator=(const HttpResponseCache&) = delete;
+
+  /**
+   * Get path to cache directory.
+   * @return path in cache directory, empty if not available.
+   */
+  static QString cacheDirPath();
+
+  /**
+   * Get path to entry file.
+   * @param key key from cacheKey()
+   * @return path to file, empty if not available.
+   */
+  static QString entryFilePath(const QByteArray& key);
+
+  /**
+   * Remove the least recently stored entries until the cache size is below
+   * the configured maximum size.
+   */
+  void limitSize();
+
+  /** Total size of entry files in bytes, -1 if not yet determined */
+  qint64 m_totalSize = -1;
+};
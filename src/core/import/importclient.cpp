@@ -39,6 +39,7 @@ ImportClient::ImportClient(QNetworkAccessManager* netMgr)
   : HttpClient(netMgr), m_requestType(RT_None)
 {
   setObjectName(QLatin1String("ImportClient"));
+  setResponseCacheEnabled(true);
   connect(this, &HttpClient::bytesReceived,
           this, &ImportClient::requestFinished);
 }
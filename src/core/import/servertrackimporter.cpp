@@ -39,6 +39,7 @@ ServerTrackImporter::ServerTrackImporter(QNetworkAccessManager* netMgr,
   : QObject(netMgr),
     m_httpClient(new HttpClient(netMgr)),
     m_trackDataModel(trackDataModel) {
+  m_httpClient->setResponseCacheEnabled(true);
 }
 
 /** NULL-terminated array of server strings, 0 if not used */
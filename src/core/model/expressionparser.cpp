@@ -31,15 +31,30 @@
 
 namespace {
 
+/**
+ * Convert a boolean to a string.
+ *
+ * @param b boolean to convert
+ *
+ * @return "1" or "0".
+ */
+QString boolToString(bool b)
+{
+  return b ? QLatin1String("1") : QLatin1String("0");
+}
+
+}
+
 /**
  * Convert a string to a boolean.
+ * Accepted values are 1, true, on, yes and 0, false, off, no.
  *
  * @param str string
  * @param b   the boolean is returned here
  *
  * @return true if ok.
  */
-bool stringToBool(const QString& str, bool& b)
+bool ExpressionParser::stringToBool(const QString& str, bool& b)
 {
   if (str == QLatin1String("1") || str == QLatin1String("true") ||
       str == QLatin1String("on") || str == QLatin1String("yes")) {
@@ -54,20 +69,6 @@ bool stringToBool(const QString& str, bool& b)
   return false;
 }
 
-/**
- * Convert a boolean to a string.
- *
- * @param b boolean to convert
- *
- * @return "1" or "0".
- */
-QString boolToString(bool b)
-{
-  return b ? QLatin1String("1") : QLatin1String("0");
-}
-
-}
-
 /**
  * Constructor.
  *
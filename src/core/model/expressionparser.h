@@ -102,6 +102,38 @@ public:
    */
   bool popBool(bool& var);
 
+  /**
+   * Get the tokens of the expression in reverse polish notation.
+   * Can be used to compile the expression instead of evaluating it with
+   * evaluate().
+   *
+   * @return tokens created by tokenizeRpn().
+   */
+  const QStringList& getRpnStack() const { return m_rpnStack; }
+
+  /**
+   * Check if a token is an operator.
+   *
+   * @param token token from getRpnStack()
+   *
+   * @return true if @a token is one of the additional operators or
+   *         not, and, or.
+   */
+  bool isOperator(const QString& token) const {
+    return m_operators.contains(token);
+  }
+
+  /**
+   * Convert a string to a boolean.
+   * Accepted values are 1, true, on, yes and 0, false, off, no.
+   *
+   * @param str string
+   * @param b   the boolean is returned here
+   *
+   * @return true if ok.
+   */
+  static bool stringToBool(const QString& str, bool& b);
+
 private:
   /**
    * Compare operator priority.
@@ -29,6 +29,41 @@
 #include <QRegularExpression>
 #include <QCoreApplication>
 
+namespace {
+
+/**
+ * Format replacer giving access to the replacement of single format codes.
+ */
+class FilterFormatReplacer : public TrackDataFormatReplacer {
+public:
+  /**
+   * Constructor.
+   * @param trackData track data
+   */
+  explicit FilterFormatReplacer(const TrackData& trackData)
+    : TrackDataFormatReplacer(trackData) {}
+
+  /**
+   * Constructor.
+   * @param trackData track data providing the file information
+   * @param frames frames used instead of those of @a trackData
+   */
+  FilterFormatReplacer(const TrackData& trackData,
+                       const FrameCollection& frames)
+    : TrackDataFormatReplacer(trackData, frames) {}
+
+  /**
+   * Replace a format code.
+   * @param code format code
+   * @return replacement string, null if code not found.
+   */
+  QString replacement(const QString& code) const {
+    return getReplacement(code);
+  }
+};
+
+}
+
 /**
  * Constructor.
  * @param parent parent object
@@ -36,6 +71,8 @@
 FileFilter::FileFilter(QObject* parent) : QObject(parent),
   m_parser({QLatin1String("equals"), QLatin1String("contains"),
             QLatin1String("matches")}),
+  m_frames1(nullptr), m_frames2(nullptr),
+  m_rootNode(-1), m_trackDataFlags(0), m_compileError(false),
   m_aborted(false)
 {
 }
@@ -48,30 +85,227 @@ FileFilter::FileFilter(QObject* parent) : QObject(parent),
 void FileFilter::initParser()
 {
   m_parser.tokenizeRpn(m_filterExpression);
+  compile();
+}
+
+/**
+ * Compile the expression tokenized by the parser into m_nodes.
+ * Operand format strings are split into literal text and format codes,
+ * constant regular expressions are created once. The tags whose frames
+ * are needed by the format codes are stored in m_trackDataFlags.
+ */
+void FileFilter::compile()
+{
+  m_nodes.clear();
+  m_rootNode = -1;
+  m_trackDataFlags = 0;
+  m_compileError = false;
+
+  // Indexes of the nodes on the operand stack. The types of all values are
+  // known in advance, so errors which would occur in every evaluation of the
+  // RPN stack are detected here.
+  QList<int> stack;
+  const QStringList& tokens = m_parser.getRpnStack();
+  for (const QString& token : tokens) {
+    Node node;
+    node.left = -1;
+    node.right = -1;
+    node.isBool = true;
+    node.boolValue = false;
+    if (!m_parser.isOperator(token)) {
+      if (token.indexOf(QLatin1Char('%')) == -1) {
+        node.type = NT_Constant;
+        node.text = token;
+      } else {
+        node.type = NT_Format;
+        node.parts = compileFormat(token);
+        for (const FormatPart& part : std::as_const(node.parts)) {
+          if (!part.code.isNull() &&
+              !TrackDataFormatReplacer::isFileInfoCode(part.code)) {
+            m_trackDataFlags |= part.tagVersion == Frame::TagV1 ? TD_Tag1
+                              : part.tagVersion == Frame::TagV2 ? TD_Tag2
+                              : TD_Tag12;
+          }
+        }
+      }
+      node.isBool = ExpressionParser::stringToBool(token, node.boolValue);
+    } else if (token == QLatin1String("not")) {
+      if (stack.isEmpty() || !m_nodes.at(stack.last()).isBool) {
+        m_compileError = true;
+        break;
+      }
+      node.type = NT_Not;
+      node.left = stack.takeLast();
+    } else {
+      if (stack.size() < 2) {
+        m_compileError = true;
+        break;
+      }
+      node.right = stack.takeLast();
+      node.left = stack.takeLast();
+      if (token == QLatin1String("and") || token == QLatin1String("or")) {
+        if (!m_nodes.at(node.left).isBool || !m_nodes.at(node.right).isBool) {
+          m_compileError = true;
+          break;
+        }
+        node.type = token == QLatin1String("and") ? NT_And : NT_Or;
+      } else if (token == QLatin1String("equals")) {
+        node.type = NT_Equals;
+      } else if (token == QLatin1String("contains")) {
+        node.type = NT_Contains;
+      } else {
+        node.type = NT_Matches;
+        if (const Node& pattern = m_nodes.at(node.right);
+            pattern.type == NT_Constant) {
+          node.regExp.setPattern(pattern.text);
+        }
+      }
+    }
+    stack.append(m_nodes.size());
+    m_nodes.append(node);
+  }
+  if (!m_compileError && !stack.isEmpty()) {
+    m_rootNode = stack.last();
+  }
+}
+
+/**
+ * Split format string into literal text and format codes.
+ *
+ * @param format format specification containing '%'
+ *
+ * @return parts of format string.
+ */
+QList<FileFilter::FormatPart> FileFilter::compileFormat(const QString& format)
+{
+  // Escaped characters are replaced in the whole string before the format
+  // codes are replaced, see TrackData::formatString().
+  ImportTrackData noTrackData;
+  FilterFormatReplacer escapeReplacer(noTrackData);
+  escapeReplacer.setString(format);
+  escapeReplacer.replaceEscapedChars();
+  const QString str = escapeReplacer.getString();
+
+  QList<FormatPart> parts;
+  QString literal;
+  auto addLiteral = [&parts, &literal]() {
+    if (!literal.isEmpty()) {
+      FormatPart part;
+      part.text = literal;
+      part.tagVersion = Frame::TagNone;
+      part.htmlEscape = false;
+      part.keepUnknown = true;
+      parts.append(part);
+      literal.clear();
+    }
+  };
+
+  const int len = str.length();
+  int pos = 0;
+  while (pos < len) {
+    const int percentPos = str.indexOf(QLatin1Char('%'), pos);
+    if (percentPos == -1) {
+      literal += str.mid(pos);
+      break;
+    }
+    literal += str.mid(pos, percentPos - pos);
+
+    // %1 and %2 select tag 1 and tag 2, else tag 2 with fallback to tag 1.
+    FormatPart part;
+    part.tagVersion = Frame::TagV2V1;
+    part.htmlEscape = false;
+    part.keepUnknown = false;
+    int codePos = percentPos + 1;
+    if (codePos < len && str.at(codePos) == QLatin1Char('1')) {
+      part.tagVersion = Frame::TagV1;
+      ++codePos;
+    } else if (codePos < len && str.at(codePos) == QLatin1Char('2')) {
+      part.tagVersion = Frame::TagV2;
+      ++codePos;
+    }
+    const int afterTagPos = codePos;
+    if (codePos < len && str.at(codePos) == QLatin1Char('h')) {
+      part.htmlEscape = true;
+      ++codePos;
+    }
+    int codeEnd = -1;
+    if (codePos < len && str.at(codePos) == QLatin1Char('{')) {
+      if (int closingBracePos = str.indexOf(QLatin1Char('}'), codePos + 1);
+          closingBracePos > codePos + 1) {
+        QString longCode =
+            str.mid(codePos + 1, closingBracePos - codePos - 1).toLower();
+        if (longCode.startsWith(QLatin1Char('"'))) {
+          if (int prefixEnd = longCode.indexOf(QLatin1Char('"'), 1);
+              prefixEnd != -1 && prefixEnd < longCode.length() - 2) {
+            part.prefix = longCode.mid(1, prefixEnd - 1);
+            longCode.remove(0, prefixEnd + 1);
+          }
+        }
+        if (longCode.endsWith(QLatin1Char('"'))) {
+          if (int postfixStart = longCode.lastIndexOf(QLatin1Char('"'), -2);
+              postfixStart > 1) {
+            part.postfix = longCode.mid(postfixStart + 1,
+                                        longCode.length() - postfixStart - 2);
+            longCode.truncate(postfixStart);
+          }
+        }
+        part.code = longCode;
+        codeEnd = closingBracePos + 1;
+      }
+    } else if (codePos < len && str.at(codePos) != QLatin1Char('%')) {
+      part.code = QString(str.at(codePos));
+      // An unknown single character code is kept unless it has a modifier.
+      part.keepUnknown = !part.htmlEscape;
+      codeEnd = codePos + 1;
+    }
+
+    if (codeEnd == -1) {
+      // Not a format code, keep '%' and continue after the tag number.
+      literal += QLatin1Char('%');
+      pos = afterTagPos;
+    } else {
+      addLiteral();
+      part.text = QLatin1Char('%') + str.mid(afterTagPos, codeEnd - afterTagPos);
+      parts.append(part);
+      pos = codeEnd;
+    }
+  }
+  addLiteral();
+  return parts;
 }
 
 /**
  * Format a string from tag data.
  *
- * @param format format specification
+ * @param parts format string split by compileFormat()
  *
  * @return formatted string.
  */
-QString FileFilter::formatString(const QString& format) const
+QString FileFilter::formatString(const QList<FormatPart>& parts) const
 {
-  if (format.indexOf(QLatin1Char('%')) == -1) {
-    return format;
-  }
-  QString str(format);
-  str.replace(QLatin1String("%1"), QLatin1String("\v1"));
-  str.replace(QLatin1String("%2"), QLatin1String("\v2"));
-  str = m_trackData12.formatString(str);
-  if (str.indexOf(QLatin1Char('\v')) != -1) {
-    str.replace(QLatin1String("\v2"), QLatin1String("%"));
-    str = m_trackData2.formatString(str);
-    if (str.indexOf(QLatin1Char('\v')) != -1) {
-      str.replace(QLatin1String("\v1"), QLatin1String("%"));
-      str = m_trackData1.formatString(str);
+  QString str;
+  for (const FormatPart& part : parts) {
+    if (part.code.isNull()) {
+      str += part.text;
+      continue;
+    }
+    const FrameCollection& frames =
+        part.tagVersion == Frame::TagV1 ? *m_frames1
+      : part.tagVersion == Frame::TagV2 ? *m_frames2
+      : m_frames12;
+    QString repl =
+        FilterFormatReplacer(m_trackData, frames).replacement(part.code);
+    if (repl.isNull() && part.keepUnknown) {
+      str += part.text;
+      continue;
+    }
+    if (part.htmlEscape) {
+      repl = FormatReplacer::escapeHtml(repl);
+    }
+    if (!repl.isEmpty()) {
+      str += part.prefix;
+      str += repl;
+      str += part.postfix;
     }
   }
   return str;
@@ -143,6 +377,67 @@ QString FileFilter::getFormatToolTip(bool onlyRows)
   return str;
 }
 
+/**
+ * Evaluate a node of the compiled expression to a string.
+ *
+ * @param nodeIndex index in m_nodes
+ *
+ * @return string value, "1" or "0" for boolean nodes.
+ */
+QString FileFilter::evaluateString(int nodeIndex)
+{
+  const Node& node = m_nodes.at(nodeIndex);
+  switch (node.type) {
+  case NT_Constant:
+    return node.text;
+  case NT_Format:
+    return formatString(node.parts);
+  default:
+    return evaluateBool(nodeIndex) ? QLatin1String("1") : QLatin1String("0");
+  }
+}
+
+/**
+ * Evaluate a node of the compiled expression to a boolean.
+ * The operands of "and" and "or" are evaluated from left to right and
+ * only if needed.
+ *
+ * @param nodeIndex index in m_nodes of a node with isBool set
+ *
+ * @return boolean value.
+ */
+bool FileFilter::evaluateBool(int nodeIndex)
+{
+  const Node& node = m_nodes.at(nodeIndex);
+  switch (node.type) {
+  case NT_Constant:
+  case NT_Format:
+    return node.boolValue;
+  case NT_Not:
+    return !evaluateBool(node.left);
+  case NT_And:
+    return evaluateBool(node.left) && evaluateBool(node.right);
+  case NT_Or:
+    return evaluateBool(node.left) || evaluateBool(node.right);
+  case NT_Equals:
+    return evaluateString(node.left) == evaluateString(node.right);
+  case NT_Contains:
+    return evaluateString(node.left).indexOf(evaluateString(node.right)) >= 0;
+  case NT_Matches:
+  {
+    const QString str = evaluateString(node.left);
+    const QString pattern = evaluateString(node.right);
+    // Only recompile the regular expression if the pattern has changed.
+    QRegularExpression& regExp = m_nodes[nodeIndex].regExp;
+    if (regExp.pattern() != pattern) {
+      regExp.setPattern(pattern);
+    }
+    return regExp.match(str).hasMatch();
+  }
+  }
+  return false;
+}
+
 /**
  * Evaluate the expression to a boolean result.
  * @see initParser()
@@ -150,24 +445,10 @@ QString FileFilter::getFormatToolTip(bool onlyRows)
  */
 bool FileFilter::parse()
 {
-  QString op, var1, var2;
-  bool result = false;
-  m_parser.clearEvaluation();
-  while (m_parser.evaluate(op, var1, var2)) {
-    var1 = formatString(var1);
-    var2 = formatString(var2);
-    if (op == QLatin1String("equals")) {
-      m_parser.pushBool(var1 == var2);
-    } else if (op == QLatin1String("contains")) {
-      m_parser.pushBool(var2.indexOf(var1) >= 0);
-    } else if (op == QLatin1String("matches")) {
-      m_parser.pushBool(QRegularExpression(var1).match(var2).hasMatch());
-    }
-  }
-  if (!m_parser.hasError()) {
-    m_parser.popBool(result);
+  if (m_rootNode < 0 || !m_nodes.at(m_rootNode).isBool) {
+    return false;
   }
-  return result;
+  return evaluateBool(m_rootNode);
 }
 
 /**
@@ -184,15 +465,35 @@ bool FileFilter::filter(TaggedFile& taggedFile, bool* ok)
     if (ok) *ok = true;
     return true;
   }
-  m_trackData1 = ImportTrackData(taggedFile, Frame::TagV1);
-  m_trackData2 = ImportTrackData(taggedFile, Frame::TagV2);
-  m_trackData12 = ImportTrackData(taggedFile, Frame::TagV2V1);
-
-  bool result = parse();
-  if (m_parser.hasError()) {
+  if (m_compileError) {
     if (ok) *ok = false;
     return false;
   }
+  // Only the frames of the tags which are used in the expression are
+  // fetched, each tag at most once. They are borrowed from the cache of the
+  // tagged file, only the merged frames of tag 2 and tag 1 are copied.
+  // File information such as the file name only needs the tagged file of
+  // the track data.
+  static const FrameCollection noFrames;
+  m_trackData = ImportTrackData(taggedFile, Frame::TagNone);
+  m_frames1 = m_trackDataFlags & (TD_Tag1 | TD_Tag12)
+      ? &taggedFile.getAllFramesCached(Frame::Tag_1) : &noFrames;
+  m_frames2 = m_trackDataFlags & (TD_Tag2 | TD_Tag12)
+      ? &taggedFile.getAllFramesCached(Frame::Tag_2) : &noFrames;
+  m_frames12.clear();
+  if (m_trackDataFlags & TD_Tag12) {
+    // Same as ImportTrackData(taggedFile, Frame::TagV2V1).
+    if (m_frames2->empty()) {
+      m_frames12 = *m_frames1;
+    } else {
+      m_frames12 = *m_frames2;
+      m_frames12.merge(*m_frames1);
+    }
+  }
+
+  bool result = parse();
+  m_frames1 = nullptr;
+  m_frames2 = nullptr;
   if (ok) *ok = true;
   return result;
 }
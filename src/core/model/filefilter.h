@@ -31,6 +31,8 @@
 #include "iabortable.h"
 #include <QObject>
 #include <QString>
+#include <QList>
+#include <QRegularExpression>
 
 class TaggedFile;
 
@@ -117,14 +119,87 @@ public slots:
   void abort() override;
 
 private:
+  /** Type of a node in the compiled filter expression. */
+  enum NodeType {
+    NT_Constant, NT_Format, NT_Equals, NT_Contains, NT_Matches,
+    NT_Not, NT_And, NT_Or
+  };
+
+  /** Frames used by the compiled expression. */
+  enum TrackDataFlag {
+    TD_Tag1 = 1 << 0,  /**< m_frames1 */
+    TD_Tag2 = 1 << 1,  /**< m_frames2 */
+    TD_Tag12 = 1 << 2  /**< m_frames12 */
+  };
+
+  /** Literal text or format code in an operand. */
+  struct FormatPart {
+    QString text;     /**< literal text, kept for unknown format code */
+    QString code;     /**< format code, null for literal text */
+    QString prefix;   /**< prefix for non-empty replacement */
+    QString postfix;  /**< postfix for non-empty replacement */
+    Frame::TagVersion tagVersion; /**< tags used to replace code */
+    bool htmlEscape;  /**< true to escape HTML in replacement */
+    bool keepUnknown; /**< true to keep text if code is not found */
+  };
+
+  /** Node of the compiled filter expression. */
+  struct Node {
+    NodeType type;   /**< type of node */
+    int left;        /**< index of left or only operand, -1 if none */
+    int right;       /**< index of right operand, -1 if none */
+    bool isBool;     /**< true if node has a boolean value */
+    bool boolValue;  /**< value of boolean constant */
+    QString text;    /**< value of string constant */
+    QList<FormatPart> parts;   /**< parts of format string for NT_Format */
+    QRegularExpression regExp; /**< regular expression for NT_Matches */
+  };
+
+  /**
+   * Compile the expression tokenized by the parser into m_nodes.
+   * Operand format strings are split into literal text and format codes,
+   * constant regular expressions are created once. The tags whose frames
+   * are needed by the format codes are stored in m_trackDataFlags.
+   */
+  void compile();
+
+  /**
+   * Split format string into literal text and format codes.
+   *
+   * @param format format specification containing '%'
+   *
+   * @return parts of format string.
+   */
+  static QList<FormatPart> compileFormat(const QString& format);
+
   /**
    * Format a string from tag data.
    *
-   * @param format format specification
+   * @param parts format string split by compileFormat()
    *
    * @return formatted string.
    */
-  QString formatString(const QString& format) const;
+  QString formatString(const QList<FormatPart>& parts) const;
+
+  /**
+   * Evaluate a node of the compiled expression to a string.
+   *
+   * @param nodeIndex index in m_nodes
+   *
+   * @return string value, "1" or "0" for boolean nodes.
+   */
+  QString evaluateString(int nodeIndex);
+
+  /**
+   * Evaluate a node of the compiled expression to a boolean.
+   * The operands of "and" and "or" are evaluated from left to right and
+   * only if needed.
+   *
+   * @param nodeIndex index in m_nodes of a node with isBool set
+   *
+   * @return boolean value.
+   */
+  bool evaluateBool(int nodeIndex);
 
   /**
    * Evaluate the expression to a boolean result.
@@ -135,8 +210,18 @@ private:
 
   QString m_filterExpression;
   ExpressionParser m_parser;
-  ImportTrackData m_trackData1;
-  ImportTrackData m_trackData2;
-  ImportTrackData m_trackData12;
+  QList<Node> m_nodes;
+  /** Track data providing the file information, without frames */
+  ImportTrackData m_trackData;
+  /** Frames of tag 1 of the filtered file, only valid in filter() */
+  const FrameCollection* m_frames1;
+  /** Frames of tag 2 of the filtered file, only valid in filter() */
+  const FrameCollection* m_frames2;
+  /** Frames of tag 2 merged with those of tag 1 */
+  FrameCollection m_frames12;
+  int m_rootNode;
+  /** Combination of TrackDataFlag values for frames used by m_nodes */
+  int m_trackDataFlags;
+  bool m_compileError;
   bool m_aborted;
 };
@@ -60,6 +60,7 @@
 #  include "qplatformdefs.h"
 #endif
 #include "abstractfiledecorationprovider.h"
+#include "performancestatistics.h"
 
 #ifdef Q_OS_WIN
 #include <windows.h>
@@ -399,6 +400,7 @@ ExtendedInformation FileInfoGatherer::getInfo(const QFileInfo &fileInfo) const
  */
 void FileInfoGatherer::getFileInfos(const QString &path, const QStringList &files)
 {
+    PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::GetFileInfos);
     // List drives
     if (path.isEmpty()) {
 #ifdef QT_BUILD_INTERNAL
@@ -29,6 +29,9 @@
 #include <QRegularExpression>
 #include "taggedfilesystemmodel.h"
 #include "itaggedfilefactory.h"
+#include "taggedfileprefetcher.h"
+#include "taggedfileprobe.h"
+#include "performancestatistics.h"
 #include "config.h"
 
 namespace {
@@ -216,6 +219,8 @@ QModelIndex FileProxyModel::index(const QString& path, int column) const
 bool FileProxyModel::filterAcceptsRow(
     int srcRow, const QModelIndex& srcParent) const
 {
+  PerformanceStatistics::ScopedTimer timer(
+      PerformanceStatistics::FilterAcceptsRow);
   if (QAbstractItemModel* srcModel = sourceModel()) {
     QModelIndex srcIndex(srcModel->index(srcRow, 0, srcParent));
     if (!m_filteredOut.isEmpty()) {
@@ -231,10 +236,10 @@ bool FileProxyModel::filterAcceptsRow(
       return passesExcludeFolderFilters(m_fsModel->filePath(srcIndex));
     if (m_extensions.isEmpty())
       return true;
-    for (auto it = m_extensions.constBegin(); it != m_extensions.constEnd(); ++it) {
-      if (item.endsWith(*it, Qt::CaseInsensitive))
-        return true;
-    }
+    // The extensions do not contain a dot after the first character,
+    // so only the part after the last dot of the name has to be checked.
+    if (int dotPos = item.lastIndexOf(QLatin1Char('.')); dotPos >= 0)
+      return m_extensions.contains(item.mid(dotPos).toLower());
   }
   return false;
 }
@@ -421,13 +426,8 @@ void FileProxyModel::setNameFilters(const QStringList& filters)
       exts.insert(filter.mid(pos, len).toLower());
     }
   }
-  QStringList oldExtensions(m_extensions);
-#if QT_VERSION >= 0x050e00
-  m_extensions = QStringList(exts.constBegin(), exts.constEnd());
-#else
-  m_extensions = exts.toList();
-#endif
-  if (m_extensions != oldExtensions) {
+  if (m_extensions != exts) {
+    m_extensions = exts;
     invalidateFilter();
   }
 }
@@ -567,6 +567,8 @@ bool FileProxyModel::passesExcludeFolderFilters(const QString& dirPath) const
 
 /**
  * Get tagged file of model index.
+ * If the tagged file is currently read in a worker thread, this waits
+ * until it has been read.
  *
  * @param index model index
  *
@@ -722,8 +724,10 @@ TaggedFile* FileProxyModel::readWithOggFlacIfInvalidOgg(TaggedFile* taggedFile)
 
 /**
  * Call readTags() on tagged file.
- * Reread file with other metadata plugin if it is not supported by current
- * plugin.
+ * If the tags are read for the first time and the header of the file shows
+ * that it is not supported by the current plugin, the file is read with
+ * another plugin. Otherwise, the file is read again with another plugin if
+ * the tags show that it is not supported by the current plugin.
  *
  * @param taggedFile tagged file
  *
@@ -731,6 +735,19 @@ TaggedFile* FileProxyModel::readWithOggFlacIfInvalidOgg(TaggedFile* taggedFile)
  */
 TaggedFile* FileProxyModel::readTagsFromTaggedFile(TaggedFile* taggedFile)
 {
+  TaggedFilePrefetcher::finishReading(taggedFile);
+  if (!taggedFile->isTagInformationRead() && !taggedFile->isChanged()) {
+    // Avoid that the file is parsed first by a plugin which cannot handle
+    // it. If the file was prefetched, the probe result is already known.
+    if (const int feature = TaggedFileProbe::instance().missingFeature(
+          taggedFile, taggedFile->getAbsFilename())) {
+      if (TaggedFile* otherFile = feature & TaggedFile::TF_ID3v24
+          ? readWithId3V24(taggedFile) : readWithOggFlac(taggedFile);
+          otherFile != taggedFile) {
+        return otherFile;
+      }
+    }
+  }
   taggedFile->readTags(false);
   taggedFile = readWithId3V24IfId3V24(taggedFile);
   taggedFile = readWithOggFlacIfInvalidOgg(taggedFile);
@@ -243,6 +243,8 @@ public:
 
   /**
    * Get tagged file of model index.
+   * If the tagged file is currently read in a worker thread, this waits
+   * until it has been read.
    *
    * @param index model index
    *
@@ -309,8 +311,10 @@ public:
 
   /**
    * Call readTags() on tagged file.
-   * Reread file with other metadata plugin if it is not supported by current
-   * plugin.
+   * If the tags are read for the first time and the header of the file shows
+   * that it is not supported by the current plugin, the file is read with
+   * another plugin. Otherwise, the file is read again with another plugin if
+   * the tags show that it is not supported by the current plugin.
    *
    * @param taggedFile tagged file
    *
@@ -416,7 +420,8 @@ private:
   TaggedFileSystemModel* m_fsModel;
   QTimer* m_loadTimer;
   QTimer* m_sortTimer;
-  QStringList m_extensions;
+  /** Lower case file extensions like ".mp3" of the name filters */
+  QSet<QString> m_extensions;
   unsigned int m_numModifiedFiles;
   bool m_isLoading;
 };
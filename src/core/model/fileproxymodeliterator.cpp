@@ -27,6 +27,7 @@
 #include "fileproxymodeliterator.h"
 #include <QTimer>
 #include "fileproxymodel.h"
+#include "taggedfileprefetcher.h"
 
 /**
  * Constructor.
@@ -34,16 +35,26 @@
  * @param model file proxy model
  */
 FileProxyModelIterator::FileProxyModelIterator(FileProxyModel* model)
-  : QObject(model), m_model(model), m_numDone(0), m_aborted(false)
+  : QObject(model), m_model(model), m_prefetcher(new TaggedFilePrefetcher),
+    m_numDone(0), m_aborted(false)
 {
 }
 
+/**
+ * Destructor.
+ */
+FileProxyModelIterator::~FileProxyModelIterator()
+{
+  // Defined here because TaggedFilePrefetcher is incomplete in the header.
+}
+
 /**
  * Abort operation.
  */
 void FileProxyModelIterator::abort()
 {
   m_aborted = true;
+  m_prefetcher->cancel();
 }
 
 /**
@@ -133,17 +144,43 @@ void FileProxyModelIterator::fetchNext()
         return lhs.data().toString().compare(rhs.data().toString()) > 0;
       });
       m_nodes += childNodes;
+      prefetchUpcomingFiles();
       emit nextReady(m_nextIdx);
     } else {
       m_nodes.pop();
     }
   }
+  m_prefetcher->cancel();
   m_nodes.clear();
   m_rootIndexes.clear();
   m_nextIdx = QPersistentModelIndex();
   emit nextReady(m_nextIdx);
 }
 
+/**
+ * Schedule reading the tags of the next files on the stack.
+ */
+void FileProxyModelIterator::prefetchUpcomingFiles()
+{
+  m_prefetcher->markProcessed(FileProxyModel::getTaggedFileOfIndex(m_nextIdx));
+  if (!m_prefetcher->needsMore())
+    return;
+
+  // The top of the stack contains the files which will be processed next.
+  // Subdirectories which are not yet fetched are skipped, their files are
+  // scheduled when they are expanded. The search is limited so that stacks
+  // with many files which are already read are not scanned completely.
+  const int end = qMax(0, static_cast<int>(m_nodes.size()) -
+                       2 * m_prefetcher->capacity());
+  for (int i = static_cast<int>(m_nodes.size()) - 1;
+       i >= end && !m_prefetcher->isFull();
+       --i) {
+    if (const QPersistentModelIndex& idx = m_nodes.at(i); idx.isValid()) {
+      m_prefetcher->prefetch(FileProxyModel::getTaggedFileOfIndex(idx));
+    }
+  }
+}
+
 /**
  * Called when the gatherer thread has finished to load.
  */
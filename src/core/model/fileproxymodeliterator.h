@@ -29,10 +29,12 @@
 #include <QObject>
 #include <QStack>
 #include <QPersistentModelIndex>
+#include <QScopedPointer>
 #include "iabortable.h"
 #include "kid3api.h"
 
 class FileProxyModel;
+class TaggedFilePrefetcher;
 
 /**
  * Iterator for FileProxyModel.
@@ -44,7 +46,9 @@ class FileProxyModel;
  * when file nodes are available. The iteration will also be suspended after
  * some files so that other slots can be processed and the GUI remains
  * responsive. If the iteration shall stop before all files are processed,
- * abort() shall be called.
+ * abort() shall be called. The tags of the upcoming files are read ahead in
+ * worker threads, so the slot has to use FileProxyModel::readTagsFromTaggedFile()
+ * before accessing a tagged file.
  */
 class KID3_CORE_EXPORT FileProxyModelIterator : public QObject, public IAbortable {
   Q_OBJECT
@@ -59,7 +63,7 @@ public:
   /**
    * Destructor.
    */
-  ~FileProxyModelIterator() override = default;
+  ~FileProxyModelIterator() override;
 
   /**
    * Abort operation.
@@ -124,10 +128,16 @@ private slots:
   void fetchNext();
 
 private:
+  /**
+   * Schedule reading the tags of the next files on the stack.
+   */
+  void prefetchUpcomingFiles();
+
   QList<QPersistentModelIndex> m_rootIndexes;
   QStack<QPersistentModelIndex> m_nodes;
   FileProxyModel* m_model;
   QPersistentModelIndex m_nextIdx;
+  QScopedPointer<TaggedFilePrefetcher> m_prefetcher;
   int m_numDone;
   bool m_aborted;
 };
@@ -55,6 +55,7 @@
 #endif
 #include "icoreplatformtools.h"
 #include "fileproxymodeliterator.h"
+#include "taggedfilesaver.h"
 #include "filefilter.h"
 #include "modeliterator.h"
 #include "trackdatamodel.h"
@@ -323,6 +324,8 @@ Kid3Application::Kid3Application(ICorePlatformTools* platformTools,
           this, &Kid3Application::updateCoverArtImageId);
   connect(m_selection, &TaggedFileSelection::fileNameModified,
           this, &Kid3Application::selectedFilesUpdated);
+  connect(m_tagSearcher, &TagSearcher::bulkReplaceFinished,
+          this, &Kid3Application::onBulkReplaceFinished);
 
   initPlugins();
   m_batchImporter->setImporters(m_importers, m_trackDataModel);
@@ -438,6 +441,7 @@ void Kid3Application::initPlugins()
     orderedFactories.removeAll(nullptr);
     FileProxyModel::taggedFileFactories().swap(orderedFactories);
   }
+  TaggedFileSystemModel::updateTaggedFileFactoryLookup();
 }
 
 /**
@@ -1010,6 +1014,8 @@ QModelIndex Kid3Application::currentOrRootIndex() const
 /**
  * Save all changed files.
  * longRunningOperationProgress() is emitted while saving files.
+ * Files which are not renamed are written in worker threads if their
+ * backend supports it, see TaggedFileSaver.
  *
  * @param errorDescriptions if not NULL, a list with error descriptions
  * corresponding to the errored files in the returned file list
@@ -1021,36 +1027,73 @@ QModelIndex Kid3Application::currentOrRootIndex() const
 QStringList Kid3Application::saveDirectory(QStringList* errorDescriptions)
 {
   QStringList errorFiles;
-  int numFiles = 0, totalFiles = 0;
-  // Get number of files to be saved to display correct progressbar
-  TaggedFileIterator countIt(m_fileProxyModelRootIndex);
-  while (countIt.hasNext()) {
-    if (countIt.next()->isChanged()) {
-      ++totalFiles;
+  if (errorDescriptions) {
+    errorDescriptions->clear();
+  }
+  auto addError = [&errorFiles, errorDescriptions](const TaggedFile* taggedFile,
+                                                   int errnum) {
+    errorFiles.push_back(taggedFile->getAbsFilename());
+    if (errorDescriptions) {
+      QString errorDescription;
+      if (errnum) {
+        if (const char* errdesc = ::strerror(errnum)) {
+          errorDescription = QString::fromUtf8(errdesc);
+        }
+      }
+      errorDescriptions->append(errorDescription);
+    }
+  };
+
+  // Collect the changed files, the files which are not renamed are written
+  // in worker threads if supported by their backend.
+  QList<TaggedFile*> workerFiles, changedFiles;
+  TaggedFileIterator it(m_fileProxyModelRootIndex);
+  while (it.hasNext()) {
+    if (TaggedFile* taggedFile = it.next(); taggedFile->isChanged()) {
+      if (TaggedFileSaver::canSaveInWorkerThread(taggedFile)) {
+        workerFiles.append(taggedFile);
+      } else {
+        changedFiles.append(taggedFile);
+      }
     }
   }
+  int numFiles = 0;
+  int totalFiles = workerFiles.size() + changedFiles.size();
   QString operationName = tr("Saving folder...");
   bool aborted = false;
   emit longRunningOperationProgress(operationName, -1, totalFiles, &aborted);
 
-  if (errorDescriptions) {
-    errorDescriptions->clear();
+  const bool preserve = FileConfig::instance().preserveTime();
+  if (!workerFiles.isEmpty()) {
+    TaggedFileSaver saver;
+    saver.save(workerFiles, preserve);
+    TaggedFileSaver::Result result;
+    while (saver.nextResult(result)) {
+      if (!result.ok) {
+        addError(result.taggedFile, result.errnum);
+      }
+      ++numFiles;
+      emit longRunningOperationProgress(operationName, numFiles, totalFiles,
+                                        &aborted);
+      if (aborted) {
+        saver.cancel();
+      }
+    }
   }
-  TaggedFileIterator it(m_fileProxyModelRootIndex);
-  while (it.hasNext()) {
-    TaggedFile* taggedFile = it.next();
+
+  for (auto fileIt = changedFiles.constBegin();
+       !aborted && fileIt != changedFiles.constEnd();
+       ++fileIt) {
+    TaggedFile* taggedFile = *fileIt;
     QString fileName = taggedFile->getFilename();
     if (taggedFile->isFilenameChanged() &&
         Utils::replaceIllegalFileNameCharacters(fileName)) {
       taggedFile->setFilename(fileName);
     }
     bool renamed = false;
-    if (errorDescriptions) {
-      errno = 0;
-    }
-    if (taggedFile->isChanged() &&
-        !taggedFile->writeTags(false, &renamed,
-                               FileConfig::instance().preserveTime())) {
+    errno = 0;
+    bool ok = taggedFile->writeTags(false, &renamed, preserve);
+    if (!ok) {
       if (QDir dir(taggedFile->getDirname());
           dir.exists(fileName) && taggedFile->isFilenameChanged()) {
         // File is renamed to a file name which already exists.
@@ -1063,39 +1106,25 @@ QStringList Kid3Application::saveDirectory(QStringList* errorDescriptions)
         }
         baseName.append(QLatin1Char('('));
         ext.prepend(QLatin1Char(')'));
-        bool ok = false;
         for (int nr = 1; nr < 100; ++nr) {
           if (QString newName = baseName + QString::number(nr) + ext;
               !dir.exists(newName)) {
             taggedFile->setFilename(newName);
-            ok = taggedFile->writeTags(false, &renamed,
-                                       FileConfig::instance().preserveTime());
+            ok = taggedFile->writeTags(false, &renamed, preserve);
             break;
           }
         }
-        if (ok) {
-          continue;
+        if (!ok) {
+          taggedFile->setFilename(fileName);
         }
-        taggedFile->setFilename(fileName);
       }
-      QString errorMsg = taggedFile->getAbsFilename();
-      errorFiles.push_back(errorMsg);
-      if (errorDescriptions) {
-        QString errorDescription;
-        if (const int errnum = errno) {
-          if (const char* errdesc = ::strerror(errnum)) {
-            errorDescription = QString::fromUtf8(errdesc);
-          }
-        }
-        errorDescriptions->append(errorDescription);
+      if (!ok) {
+        addError(taggedFile, errno);
       }
     }
     ++numFiles;
     emit longRunningOperationProgress(operationName, numFiles, totalFiles,
                                       &aborted);
-    if (aborted) {
-      break;
-    }
   }
   if (totalFiles == 0) {
     // To signal that operation is finished.
@@ -2866,6 +2895,50 @@ void Kid3Application::replaceAll(const TagSearcher::Parameters& params)
   m_tagSearcher->replaceAll(params);
 }
 
+/**
+ * Replace all occurrences in the files of the current folder without
+ * stopping at each match.
+ * When finished, bulkReplaceFinished() is emitted.
+ * @param params search parameters
+ */
+void Kid3Application::bulkReplace(const TagSearcher::Parameters& params)
+{
+  emit fileSelectionUpdateRequested();
+  m_tagSearcher->setModel(m_fileProxyModel);
+  m_tagSearcher->setRootIndex(m_fileProxyModelRootIndex);
+  m_tagSearcher->bulkReplace(params);
+}
+
+/**
+ * Replace all occurrences in the files of the current folder without
+ * stopping at each match.
+ * When finished, bulkReplaceFinished() is emitted.
+ * @param searchText text or regular expression to search
+ * @param replaceText replacement text
+ * @param flags search flags, TagSearcher::CaseSensitive and
+ * TagSearcher::RegExp can be used, the file name and all frames are searched
+ */
+void Kid3Application::bulkReplace(const QString& searchText,
+                                  const QString& replaceText, int flags)
+{
+  TagSearcher::Parameters params;
+  params.setSearchText(searchText);
+  params.setReplaceText(replaceText);
+  params.setFlags(TagSearcher::SearchFlags(flags) | TagSearcher::AllFrames);
+  bulkReplace(params);
+}
+
+/**
+ * Called when bulk replace is finished.
+ * @param numReplacements number of replaced occurrences
+ * @param numFiles number of modified files
+ */
+void Kid3Application::onBulkReplaceFinished(int numReplacements, int numFiles)
+{
+  emit selectedFilesUpdated();
+  emit bulkReplaceFinished(numReplacements, numFiles);
+}
+
 /**
  * Schedule actions to rename a directory.
  * When finished renameActionsScheduled() is emitted.
@@ -3449,6 +3522,7 @@ void Kid3Application::setAllFilesFileFilter() {
  */
 void Kid3Application::notifyConfigurationChange()
 {
+  TaggedFile::invalidateAllCachedFrames();
   const auto factories = FileProxyModel::taggedFileFactories();
   for (ITaggedFileFactory* factory : factories) {
     const auto keys = factory->taggedFileKeys();
@@ -399,6 +399,8 @@ public:
   /**
    * Save all changed files.
    * longRunningOperationProgress() is emitted while saving files.
+   * Files which are not renamed are written in worker threads if their
+   * backend supports it, see TaggedFileSaver.
    *
    * @param errorDescriptions if not NULL, a list with error descriptions
    * corresponding to the errored files in the returned file list
@@ -1222,6 +1224,26 @@ public slots:
    */
   void replaceAll(const TagSearcher::Parameters& params);
 
+  /**
+   * Replace all occurrences in the files of the current folder without
+   * stopping at each match.
+   * When finished, bulkReplaceFinished() is emitted.
+   * @param params search parameters
+   */
+  void bulkReplace(const TagSearcher::Parameters& params);
+
+  /**
+   * Replace all occurrences in the files of the current folder without
+   * stopping at each match.
+   * When finished, bulkReplaceFinished() is emitted.
+   * @param searchText text or regular expression to search
+   * @param replaceText replacement text
+   * @param flags search flags, TagSearcher::CaseSensitive and
+   * TagSearcher::RegExp can be used, the file name and all frames are searched
+   */
+  void bulkReplace(const QString& searchText, const QString& replaceText,
+                   int flags = 0);
+
   /**
    * Schedule actions to rename a directory.
    * When finished renameActionsScheduled() is emitted.
@@ -1385,6 +1407,13 @@ signals:
    */
   void fileFiltered(int type, const QString& fileName, int passed, int total);
 
+  /**
+   * Emitted when bulkReplace() is finished.
+   * @param numReplacements number of replaced occurrences
+   * @param numFiles number of modified files
+   */
+  void bulkReplaceFinished(int numReplacements, int numFiles);
+
   /**
    * Emitted before an audio file is played.
    * The GUI can display a player when receiving this signal.
@@ -1461,6 +1490,13 @@ private slots:
    */
   void filterNextFile(const QPersistentModelIndex& index);
 
+  /**
+   * Called when bulk replace is finished.
+   * @param numReplacements number of replaced occurrences
+   * @param numFiles number of modified files
+   */
+  void onBulkReplaceFinished(int numReplacements, int numFiles);
+
   /**
    * Apply single file to batch import.
    *
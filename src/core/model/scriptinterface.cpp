@@ -41,6 +41,7 @@
 #include "batchimportconfig.h"
 #include "batchimportprofile.h"
 #include "fileconfig.h"
+#include "performancestatistics.h"
 
 /**
  * Constructor.
@@ -671,4 +672,55 @@ void ScriptInterface::playAudio()
   m_app->playAudio();
 }
 
+/**
+ * Get performance statistics.
+ * For each recorded operation, e.g. "readTags", the properties
+ * count, totalMs, meanUs, maxUs, p50Us, p90Us, p99Us are returned with
+ * names in the form "readTags.count". Counters which are always available,
+ * e.g. the usage of file handles, are added as "fileHandles.hits".
+ *
+ * @return list with alternating property names and values.
+ */
+QStringList ScriptInterface::getStatistics()
+{
+  QStringList lst;
+  const QVariantMap operations = PerformanceStatistics::statistics();
+  for (auto it = operations.constBegin(); it != operations.constEnd(); ++it) {
+    const QVariantMap values = it.value().toMap();
+    for (auto valIt = values.constBegin(); valIt != values.constEnd(); ++valIt) {
+      if (valIt.key() != QLatin1String("histogram")) {
+        lst << it.key() + QLatin1Char('.') + valIt.key() // clazy:exclude=reserve-candidates
+            << valIt.value().toString();
+      }
+    }
+  }
+  const QVariantMap counters = PerformanceStatistics::counters();
+  for (auto it = counters.constBegin(); it != counters.constEnd(); ++it) {
+    const QVariantMap values = it.value().toMap();
+    for (auto valIt = values.constBegin(); valIt != values.constEnd(); ++valIt) {
+      lst << it.key() + QLatin1Char('.') + valIt.key() // clazy:exclude=reserve-candidates
+          << valIt.value().toString();
+    }
+  }
+  return lst;
+}
+
+/**
+ * Enable or disable recording of performance statistics.
+ *
+ * @param enable true to enable, false to disable
+ */
+void ScriptInterface::setStatisticsEnabled(bool enable)
+{
+  PerformanceStatistics::setEnabled(enable);
+}
+
+/**
+ * Remove all recorded performance statistics.
+ */
+void ScriptInterface::resetStatistics()
+{
+  PerformanceStatistics::reset();
+}
+
 #endif // HAVE_QTDBUS
@@ -447,6 +447,29 @@ public slots:
    */
   void playAudio();
 
+  /**
+   * Get performance statistics.
+   * For each recorded operation, e.g. "readTags", the properties
+   * count, totalMs, meanUs, maxUs, p50Us, p90Us, p99Us are returned with
+   * names in the form "readTags.count". Counters which are always available,
+   * e.g. the usage of file handles, are added as "fileHandles.hits".
+   *
+   * @return list with alternating property names and values.
+   */
+  QStringList getStatistics();
+
+  /**
+   * Enable or disable recording of performance statistics.
+   *
+   * @param enable true to enable, false to disable
+   */
+  void setStatisticsEnabled(bool enable);
+
+  /**
+   * Remove all recorded performance statistics.
+   */
+  void resetStatistics();
+
 private slots:
   void onRenameActionsScheduled();
 
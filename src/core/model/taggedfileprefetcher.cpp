@@ -0,0 +1,268 @@
+/**
+ * \file taggedfileprefetcher.cpp
+ * Read tags of upcoming files in worker threads.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taggedfileprefetcher.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QMutex>
+#include <QWaitCondition>
+#include "taggedfile.h"
+#include "taggedfileprobe.h"
+#include "taggedfilesystemmodel.h"
+
+namespace {
+
+/** Protects the sets of pending and read files. */
+QMutex s_mutex;
+/** Signaled when a worker has finished reading a file. */
+QWaitCondition s_readFinished;
+/** Files which are scheduled or currently read in a worker thread. */
+QSet<const TaggedFile*> s_pendingFiles;
+/** Files read in a worker thread, the model has not yet been notified. */
+QSet<const TaggedFile*> s_readFiles;
+
+/**
+ * Task reading the tags of a single file.
+ */
+class ReadTagsTask : public QRunnable {
+public:
+  /**
+   * Constructor.
+   * @param taggedFile tagged file, must be in s_pendingFiles
+   * @param filePath absolute path to file
+   * @param canceled set if the task shall not read the file
+   */
+  ReadTagsTask(TaggedFile* taggedFile, const QString& filePath,
+               const QAtomicInt& canceled)
+    : m_taggedFile(taggedFile), m_filePath(filePath), m_canceled(canceled) {
+  }
+
+  /**
+   * Read tags and remove file from pending files.
+   * A file which has to be read by another plugin is only probed, it is
+   * replaced by FileProxyModel::readTagsFromTaggedFile().
+   */
+  void run() override {
+    bool read = false;
+    if (!m_canceled.loadAcquire() &&
+        TaggedFileProbe::instance().missingFeature(m_taggedFile,
+                                                   m_filePath) == 0) {
+      m_taggedFile->readTagsInWorkerThread(m_filePath);
+      read = true;
+    }
+    QMutexLocker locker(&s_mutex);
+    s_pendingFiles.remove(m_taggedFile);
+    if (read) {
+      s_readFiles.insert(m_taggedFile);
+    }
+    s_readFinished.wakeAll();
+  }
+
+private:
+  TaggedFile* const m_taggedFile;
+  const QString m_filePath;
+  const QAtomicInt& m_canceled;
+};
+
+/**
+ * Notify model that the tags of a file have been read.
+ * @param taggedFile tagged file
+ */
+void notifyModel(const TaggedFile* taggedFile)
+{
+  if (const QPersistentModelIndex& index = taggedFile->getIndex();
+      index.isValid()) {
+    if (auto model = const_cast<TaggedFileSystemModel*>(
+          qobject_cast<const TaggedFileSystemModel*>(index.model()))) {
+      model->notifyModelDataChanged(index);
+    }
+  }
+}
+
+}
+
+/**
+ * Constructor.
+ *
+ * @param numThreads number of worker threads, 0 to use one thread per core
+ */
+TaggedFilePrefetcher::TaggedFilePrefetcher(int numThreads)
+  : m_threadPool(new QThreadPool), m_canceled(0), m_capacity(0)
+{
+  if (numThreads > 0) {
+    m_threadPool->setMaxThreadCount(numThreads);
+  }
+  // Allow some files to be read ahead so that the workers are kept busy
+  // while the files are processed.
+  m_capacity = 4 * m_threadPool->maxThreadCount();
+}
+
+/**
+ * Destructor, waits for running worker threads.
+ */
+TaggedFilePrefetcher::~TaggedFilePrefetcher()
+{
+  cancel();
+  delete m_threadPool;
+}
+
+/**
+ * Schedule reading the tags of a file in a worker thread.
+ * Nothing is done if the file does not support reading in a worker thread,
+ * is already read, modified or scheduled.
+ *
+ * @param taggedFile tagged file
+ */
+void TaggedFilePrefetcher::prefetch(TaggedFile* taggedFile)
+{
+  if (!taggedFile || isFull() || m_scheduled.contains(taggedFile) ||
+      !taggedFile->isReadTagsReentrant()) {
+    return;
+  }
+  {
+    QMutexLocker locker(&s_mutex);
+    if (s_pendingFiles.contains(taggedFile) ||
+        s_readFiles.contains(taggedFile)) {
+      return;
+    }
+  }
+  if (taggedFile->isTagInformationRead() || taggedFile->isChanged()) {
+    return;
+  }
+
+  // The path has to be determined here, the model must not be accessed
+  // from a worker thread.
+  const QString filePath = taggedFile->getAbsFilename();
+  m_scheduled.insert(taggedFile);
+  {
+    QMutexLocker locker(&s_mutex);
+    s_pendingFiles.insert(taggedFile);
+  }
+  m_threadPool->start(new ReadTagsTask(taggedFile, filePath, m_canceled));
+}
+
+/**
+ * Release the read-ahead capacity used by a file.
+ * Has to be called when a scheduled file is processed.
+ *
+ * @param taggedFile tagged file
+ */
+void TaggedFilePrefetcher::markProcessed(TaggedFile* taggedFile)
+{
+  m_scheduled.remove(taggedFile);
+}
+
+/**
+ * Skip files which are not yet started and wait for the running workers.
+ * The model is notified about all files which have been read.
+ */
+void TaggedFilePrefetcher::cancel()
+{
+  m_canceled.storeRelease(1);
+  m_threadPool->waitForDone();
+  m_canceled.storeRelease(0);
+
+  // Files which have been deleted in the meantime are no longer in
+  // s_readFiles, so only existing files are accessed here.
+  for (TaggedFile* taggedFile : std::as_const(m_scheduled)) {
+    if (waitUntilRead(taggedFile)) {
+      notifyModel(taggedFile);
+    }
+  }
+  m_scheduled.clear();
+}
+
+/**
+ * Check if a tagged file is currently scheduled or read in a worker thread.
+ * Must be called from the thread of the model.
+ *
+ * @param taggedFile tagged file
+ * @return true if the tagged file must not be accessed.
+ */
+bool TaggedFilePrefetcher::isPending(const TaggedFile* taggedFile)
+{
+  QMutexLocker locker(&s_mutex);
+  return s_pendingFiles.contains(taggedFile);
+}
+
+/**
+ * Wait until a scheduled tagged file has been read.
+ * Must be called from the thread of the model before deleting a tagged
+ * file which could have been scheduled.
+ *
+ * @param taggedFile tagged file
+ * @return true if the tags have been read in a worker thread and the model
+ * has not yet been notified.
+ */
+bool TaggedFilePrefetcher::waitUntilRead(const TaggedFile* taggedFile)
+{
+  QMutexLocker locker(&s_mutex);
+  while (s_pendingFiles.contains(taggedFile)) {
+    s_readFinished.wait(&s_mutex);
+  }
+  return s_readFiles.remove(taggedFile);
+}
+
+/**
+ * Wait until a scheduled tagged file has been read and notify its model.
+ * Must be called from the thread of the model before accessing a tagged
+ * file which could have been scheduled.
+ *
+ * @param taggedFile tagged file
+ */
+void TaggedFilePrefetcher::finishReading(TaggedFile* taggedFile)
+{
+  if (waitUntilRead(taggedFile)) {
+    notifyModel(taggedFile);
+  }
+}
+
+/**
+ * Mark a tagged file as accessed by another worker thread, e.g. while its
+ * tags are written by TaggedFileSaver. Until endPending() is called,
+ * isPending() returns true and the model waits before deleting the file.
+ * Must be called from the thread of the model.
+ *
+ * @param taggedFile tagged file which is not scheduled for reading
+ */
+void TaggedFilePrefetcher::beginPending(const TaggedFile* taggedFile)
+{
+  QMutexLocker locker(&s_mutex);
+  s_pendingFiles.insert(taggedFile);
+}
+
+/**
+ * Release a tagged file marked with beginPending().
+ * Can be called from the worker thread.
+ *
+ * @param taggedFile tagged file
+ */
+void TaggedFilePrefetcher::endPending(const TaggedFile* taggedFile)
+{
+  QMutexLocker locker(&s_mutex);
+  s_pendingFiles.remove(taggedFile);
+  s_readFinished.wakeAll();
+}
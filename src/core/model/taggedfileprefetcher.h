@@ -0,0 +1,168 @@
+/**
+ * \file taggedfileprefetcher.h
+ * Read tags of upcoming files in worker threads.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QSet>
+#include <QAtomicInt>
+#include "kid3api.h"
+
+class QThreadPool;
+class TaggedFile;
+
+/**
+ * Reads tags of files in worker threads before they are processed.
+ *
+ * Files are scheduled with prefetch() in the order in which they will be
+ * processed. Only tagged files which support isReadTagsReentrant() are read
+ * in the background, the others are read when they are processed.
+ * Before a tagged file is accessed, finishReading() has to be called, this
+ * is done by FileProxyModel::readTagsFromTaggedFile() and when the tagged
+ * file is retrieved with TaggedFileSystemModel::TaggedFileRole, e.g. by
+ * getTaggedFileOfIndex(). All other accesses from the thread of the model
+ * have to check isPending() first.
+ *
+ * Everything reached from TaggedFile::readTags() of a reentrant tagged file
+ * runs in a worker thread: the plugin code parsing the file, the conversion
+ * to frames for the tag cache (getAllFrames()), the static lookup tables
+ * used by this conversion (e.g. Frame::getTypeFromName(),
+ * Genres::getNumber()), TagCache and TagConfig getters. Such code must not
+ * access the model or other QObjects of the GUI thread, and static data
+ * must be initialized in a thread-safe way, e.g. with a static local
+ * variable built by a lambda. Data which can be modified, like the custom
+ * frame names, may only be changed in the GUI thread while no files are read.
+ */
+class KID3_CORE_EXPORT TaggedFilePrefetcher {
+public:
+  /**
+   * Constructor.
+   *
+   * @param numThreads number of worker threads, 0 to use one thread per core
+   */
+  explicit TaggedFilePrefetcher(int numThreads = 0);
+
+  /**
+   * Destructor, waits for running worker threads.
+   */
+  ~TaggedFilePrefetcher();
+
+  TaggedFilePrefetcher(const TaggedFilePrefetcher&) = delete;
+  TaggedFilePrefetcher& operator=(const TaggedFilePrefetcher&) = delete;
+
+  /**
+   * Get maximum number of files which are read ahead.
+   * @return read-ahead capacity.
+   */
+  int capacity() const { return m_capacity; }
+
+  /**
+   * Check if more files can be scheduled.
+   * @return true if less than half of the read-ahead capacity is used.
+   */
+  bool needsMore() const { return m_scheduled.size() <= m_capacity / 2; }
+
+  /**
+   * Check if the read-ahead capacity is exhausted.
+   * @return true if no more files can be scheduled.
+   */
+  bool isFull() const { return m_scheduled.size() >= m_capacity; }
+
+  /**
+   * Schedule reading the tags of a file in a worker thread.
+   * Nothing is done if the file does not support reading in a worker thread,
+   * is already read, modified or scheduled.
+   *
+   * @param taggedFile tagged file
+   */
+  void prefetch(TaggedFile* taggedFile);
+
+  /**
+   * Release the read-ahead capacity used by a file.
+   * Has to be called when a scheduled file is processed.
+   *
+   * @param taggedFile tagged file
+   */
+  void markProcessed(TaggedFile* taggedFile);
+
+  /**
+   * Skip files which are not yet started and wait for the running workers.
+   * The model is notified about all files which have been read.
+   */
+  void cancel();
+
+  /**
+   * Check if a tagged file is currently scheduled or read in a worker thread.
+   * Must be called from the thread of the model.
+   *
+   * @param taggedFile tagged file
+   * @return true if the tagged file must not be accessed.
+   */
+  static bool isPending(const TaggedFile* taggedFile);
+
+  /**
+   * Wait until a scheduled tagged file has been read.
+   * Must be called from the thread of the model before deleting a tagged
+   * file which could have been scheduled.
+   *
+   * @param taggedFile tagged file
+   * @return true if the tags have been read in a worker thread and the model
+   * has not yet been notified.
+   */
+  static bool waitUntilRead(const TaggedFile* taggedFile);
+
+  /**
+   * Wait until a scheduled tagged file has been read and notify its model.
+   * Must be called from the thread of the model before accessing a tagged
+   * file which could have been scheduled.
+   *
+   * @param taggedFile tagged file
+   */
+  static void finishReading(TaggedFile* taggedFile);
+
+  /**
+   * Mark a tagged file as accessed by another worker thread, e.g. while its
+   * tags are written by TaggedFileSaver. Until endPending() is called,
+   * isPending() returns true and the model waits before deleting the file.
+   * Must be called from the thread of the model.
+   *
+   * @param taggedFile tagged file which is not scheduled for reading
+   */
+  static void beginPending(const TaggedFile* taggedFile);
+
+  /**
+   * Release a tagged file marked with beginPending().
+   * Can be called from the worker thread.
+   *
+   * @param taggedFile tagged file
+   */
+  static void endPending(const TaggedFile* taggedFile);
+
+private:
+  QThreadPool* m_threadPool;
+  QSet<TaggedFile*> m_scheduled;
+  QAtomicInt m_canceled;
+  int m_capacity;
+};
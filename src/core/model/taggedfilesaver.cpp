@@ -0,0 +1,243 @@
+/**
+ * \file taggedfilesaver.cpp
+ * Write tags of modified files in worker threads.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taggedfilesaver.h"
+#include <QThreadPool>
+#include <QRunnable>
+#include <QStorageInfo>
+#include <QHash>
+#include <QFile>
+#include <cerrno>
+#include "taggedfile.h"
+#include "taggedfileprefetcher.h"
+
+/**
+ * Task writing the files of a device queue one after the other.
+ */
+class SaveTagsTask : public QRunnable {
+public:
+  /**
+   * Constructor.
+   * @param saver saver owning the queue
+   * @param queue files to write, shared with other tasks for the same device
+   */
+  SaveTagsTask(TaggedFileSaver& saver, TaggedFileSaver::DeviceQueue& queue)
+    : m_saver(saver), m_queue(queue) {
+  }
+
+  /**
+   * Write files until the queue is empty.
+   */
+  void run() override {
+    for (;;) {
+      TaggedFileSaver::Job job;
+      {
+        QMutexLocker locker(&m_saver.m_mutex);
+        if (m_queue.next >= m_queue.jobs.size()) {
+          break;
+        }
+        job = m_queue.jobs.at(m_queue.next++);
+      }
+      TaggedFileSaver::Result result{job.taggedFile, false, 0};
+      const bool written = !m_saver.m_canceled.loadAcquire();
+      if (written) {
+        errno = 0;
+        result.ok = job.taggedFile->writeTagsInWorkerThread(
+              job.filePath, m_saver.m_preserve);
+        if (!result.ok) {
+          result.errnum = errno;
+        }
+      }
+      TaggedFilePrefetcher::endPending(job.taggedFile);
+      QMutexLocker locker(&m_saver.m_mutex);
+      if (written) {
+        m_saver.m_results.append(result);
+      }
+      --m_saver.m_numPending;
+      m_saver.m_jobFinished.wakeAll();
+    }
+  }
+
+private:
+  TaggedFileSaver& m_saver;
+  TaggedFileSaver::DeviceQueue& m_queue;
+};
+
+/**
+ * Constructor.
+ *
+ * @param numThreads number of worker threads, 0 to use one thread per core
+ */
+TaggedFileSaver::TaggedFileSaver(int numThreads)
+  : m_threadPool(new QThreadPool), m_numPending(0), m_canceled(0),
+    m_preserve(false)
+{
+  if (numThreads > 0) {
+    m_threadPool->setMaxThreadCount(numThreads);
+  }
+}
+
+/**
+ * Destructor, skips files which are not yet started and waits for the
+ * running workers.
+ */
+TaggedFileSaver::~TaggedFileSaver()
+{
+  cancel();
+  m_threadPool->waitForDone();
+  delete m_threadPool;
+}
+
+/**
+ * Check if a tagged file can be written in a worker thread.
+ *
+ * @param taggedFile modified tagged file
+ *
+ * @return true if the backend supports writing in a worker thread and the
+ * file is not renamed.
+ */
+bool TaggedFileSaver::canSaveInWorkerThread(const TaggedFile* taggedFile)
+{
+  return taggedFile->isWriteTagsReentrant() &&
+      !taggedFile->isFilenameChanged();
+}
+
+/**
+ * Start writing files in worker threads.
+ * Must be called from the thread of the model.
+ *
+ * @param taggedFiles files for which canSaveInWorkerThread() is true
+ * @param preserve true to preserve file time stamps
+ */
+void TaggedFileSaver::save(const QList<TaggedFile*>& taggedFiles,
+                           bool preserve)
+{
+  m_preserve = preserve;
+  QHash<QString, QByteArray> deviceOfDir;
+  QHash<QByteArray, DeviceQueue*> queueOfDevice;
+  for (TaggedFile* taggedFile : taggedFiles) {
+    // The path has to be determined here, the model must not be accessed
+    // from a worker thread.
+    TaggedFilePrefetcher::finishReading(taggedFile);
+    const QString dirName = taggedFile->getDirname();
+    auto dirIt = deviceOfDir.find(dirName);
+    if (dirIt == deviceOfDir.end()) {
+      dirIt = deviceOfDir.insert(dirName, QStorageInfo(dirName).device());
+    }
+    DeviceQueue*& queue = queueOfDevice[*dirIt];
+    if (!queue) {
+      m_queues.emplace_back(new DeviceQueue);
+      queue = m_queues.back().get();
+    }
+    queue->jobs.append({taggedFile, taggedFile->getAbsFilename()});
+    // A file handle opened by this thread is registered with its thread ID
+    // and could be closed by this thread while the worker writes through it,
+    // so the worker has to open its own handle.
+    taggedFile->closeFileHandle();
+    TaggedFilePrefetcher::beginPending(taggedFile);
+  }
+
+  const int numThreads = m_threadPool->maxThreadCount();
+  {
+    QMutexLocker locker(&m_mutex);
+    m_numPending += taggedFiles.size();
+  }
+  for (auto it = queueOfDevice.constBegin(); it != queueOfDevice.constEnd();
+       ++it) {
+    DeviceQueue* queue = it.value();
+    const int numTasks = qMin(maxConcurrentWrites(it.key(), numThreads),
+                              static_cast<int>(queue->jobs.size()));
+    for (int i = 0; i < numTasks; ++i) {
+      m_threadPool->start(new SaveTagsTask(*this, *queue));
+    }
+  }
+}
+
+/**
+ * Wait for the next written file.
+ * The model is notified about the changes of the tagged file.
+ * Must be called from the thread of the model.
+ *
+ * @param result the result is returned here
+ *
+ * @return false if all files have been written or skipped.
+ */
+bool TaggedFileSaver::nextResult(Result& result)
+{
+  {
+    QMutexLocker locker(&m_mutex);
+    while (m_results.isEmpty() && m_numPending > 0) {
+      m_jobFinished.wait(&m_mutex);
+    }
+    if (m_results.isEmpty()) {
+      return false;
+    }
+    result = m_results.takeFirst();
+  }
+  result.taggedFile->notifyModelAfterWorkerThread();
+  return true;
+}
+
+/**
+ * Skip files which are not yet started.
+ * The results of running workers are still returned by nextResult().
+ */
+void TaggedFileSaver::cancel()
+{
+  m_canceled.storeRelease(1);
+}
+
+/**
+ * Get the number of files which are written concurrently to a device.
+ *
+ * @param device device as returned by QStorageInfo::device()
+ * @param numThreads number of worker threads
+ *
+ * @return 1 for rotational disks, else @a numThreads.
+ */
+int TaggedFileSaver::maxConcurrentWrites(const QByteArray& device,
+                                         int numThreads)
+{
+#ifdef Q_OS_LINUX
+  // Concurrent writes would make the heads of a hard disk seek between the
+  // files, so they are only used for solid state and network storage.
+  if (device.startsWith("/dev/")) {
+    const QString blockPath = QLatin1String("/sys/class/block/") +
+        QString::fromLocal8Bit(device.mid(5));
+    QFile file(blockPath + QLatin1String("/queue/rotational"));
+    if (!file.exists()) {
+      // Partitions use the queue of their disk.
+      file.setFileName(blockPath + QLatin1String("/../queue/rotational"));
+    }
+    if (file.open(QIODevice::ReadOnly) && file.read(1) == "1") {
+      return 1;
+    }
+  }
+#else
+  Q_UNUSED(device)
+#endif
+  return numThreads;
+}
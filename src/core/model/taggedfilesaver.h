@@ -0,0 +1,152 @@
+/**
+ * \file taggedfilesaver.h
+ * Write tags of modified files in worker threads.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QList>
+#include <QString>
+#include <QByteArray>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QAtomicInt>
+#include <vector>
+#include <memory>
+#include "kid3api.h"
+
+class QThreadPool;
+class TaggedFile;
+
+/**
+ * Writes the tags of modified files in worker threads.
+ *
+ * The files passed to save() are grouped by the storage device they are on.
+ * Files on rotational disks are written one after the other, files on other
+ * devices concurrently. The results are fetched from the thread of the model
+ * using nextResult(). While a file is written, it is marked as pending in
+ * TaggedFilePrefetcher so that the model does not access it.
+ *
+ * The files are written by TaggedFile::writeTags() in the same way as on the
+ * GUI thread, i.e. usually in place. Writing is not crash-safe: making it so
+ * would require writing a complete copy of each file and replacing the
+ * original, which would turn a tag update into a copy of the audio data.
+ */
+class KID3_CORE_EXPORT TaggedFileSaver {
+public:
+  /** Result of writing a file. */
+  struct Result {
+    TaggedFile* taggedFile; /**< tagged file */
+    bool ok;                /**< true if written successfully */
+    int errnum;             /**< errno if not ok, 0 if unknown */
+  };
+
+  /**
+   * Constructor.
+   *
+   * @param numThreads number of worker threads, 0 to use one thread per core
+   */
+  explicit TaggedFileSaver(int numThreads = 0);
+
+  /**
+   * Destructor, skips files which are not yet started and waits for the
+   * running workers.
+   */
+  ~TaggedFileSaver();
+
+  TaggedFileSaver(const TaggedFileSaver&) = delete;
+  TaggedFileSaver& operator=(const TaggedFileSaver&) = delete;
+
+  /**
+   * Check if a tagged file can be written in a worker thread.
+   *
+   * @param taggedFile modified tagged file
+   *
+   * @return true if the backend supports writing in a worker thread and the
+   * file is not renamed.
+   */
+  static bool canSaveInWorkerThread(const TaggedFile* taggedFile);
+
+  /**
+   * Start writing files in worker threads.
+   * Must be called from the thread of the model.
+   *
+   * @param taggedFiles files for which canSaveInWorkerThread() is true
+   * @param preserve true to preserve file time stamps
+   */
+  void save(const QList<TaggedFile*>& taggedFiles, bool preserve);
+
+  /**
+   * Wait for the next written file.
+   * The model is notified about the changes of the tagged file.
+   * Must be called from the thread of the model.
+   *
+   * @param result the result is returned here
+   *
+   * @return false if all files have been written or skipped.
+   */
+  bool nextResult(Result& result);
+
+  /**
+   * Skip files which are not yet started.
+   * The results of running workers are still returned by nextResult().
+   */
+  void cancel();
+
+private:
+  friend class SaveTagsTask;
+
+  /** File to be written. */
+  struct Job {
+    TaggedFile* taggedFile; /**< tagged file */
+    QString filePath;       /**< absolute path to file */
+  };
+
+  /** Files on a storage device. */
+  struct DeviceQueue {
+    QList<Job> jobs; /**< files on device */
+    int next = 0;    /**< index of next job to start */
+  };
+
+  /**
+   * Get the number of files which are written concurrently to a device.
+   *
+   * @param device device as returned by QStorageInfo::device()
+   * @param numThreads number of worker threads
+   *
+   * @return 1 for rotational disks, else @a numThreads.
+   */
+  static int maxConcurrentWrites(const QByteArray& device, int numThreads);
+
+  QThreadPool* m_threadPool;
+  std::vector<std::unique_ptr<DeviceQueue>> m_queues;
+  /** protects m_queues, m_results and m_numPending */
+  QMutex m_mutex;
+  /** Signaled when a result is available or a job skipped. */
+  QWaitCondition m_jobFinished;
+  QList<Result> m_results;
+  int m_numPending;
+  QAtomicInt m_canceled;
+  bool m_preserve;
+};
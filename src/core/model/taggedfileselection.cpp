@@ -139,12 +139,10 @@ void TaggedFileSelection::addTaggedFile(TaggedFile* taggedFile)
   FOR_ALL_TAGS(tagNr) {
     if (taggedFile->isTagSupported(tagNr)) {
       if (m_state.m_tagSupportedCount[tagNr] == 0) {
-        FrameCollection frames;
-        taggedFile->getAllFrames(tagNr, frames);
+        FrameCollection frames(taggedFile->getAllFramesCached(tagNr));
         m_framesModel[tagNr]->transferFrames(frames);
       } else {
-        FrameCollection fileFrames;
-        taggedFile->getAllFrames(tagNr, fileFrames);
+        FrameCollection fileFrames(taggedFile->getAllFramesCached(tagNr));
         m_framesModel[tagNr]->filterDifferent(fileFrames);
       }
       ++m_state.m_tagSupportedCount[tagNr];
@@ -28,7 +28,9 @@
 #include "coretaggedfileiconprovider.h"
 #include "filesystemmodel.h"
 #include "itaggedfilefactory.h"
+#include "taggedfileprefetcher.h"
 #include "tagconfig.h"
+#include "tagcache.h"
 #include "saferename.h"
 
 /** Only defined for generation of translation files */
@@ -44,6 +46,9 @@
   QT_TRANSLATE_NOOP("QFileSystemModel", "Date Modified")
 
 QList<ITaggedFileFactory*> TaggedFileSystemModel::s_taggedFileFactories;
+QHash<QString, QList<TaggedFileSystemModel::TaggedFileFactoryKey>>
+  TaggedFileSystemModel::s_factoryKeysForExtension;
+QList<ITaggedFileFactory*> TaggedFileSystemModel::s_lookupFactories;
 
 TaggedFileSystemModel::TaggedFileSystemModel(
     CoreTaggedFileIconProvider* iconProvider, QObject* parent)
@@ -93,22 +98,22 @@ QVariant TaggedFileSystemModel::data(const QModelIndex& index, int role) const
       return retrieveTaggedFileVariant(index);
     }
     if (role == Qt::DecorationRole && index.column() == 0) {
-      if (TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr)) {
+      if (TaggedFile* taggedFile = readableTaggedFile(index)) {
         return m_iconProvider->iconForTaggedFile(taggedFile);
       }
     } else if (role == Qt::BackgroundRole && index.column() == 0) {
-      if (TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr)) {
+      if (TaggedFile* taggedFile = readableTaggedFile(index)) {
         if (QVariant color = m_iconProvider->backgroundForTaggedFile(taggedFile);
             !color.isNull())
           return color;
       }
     } else if (role == IconIdRole && index.column() == 0) {
-      TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr);
+      TaggedFile* taggedFile = readableTaggedFile(index);
       return taggedFile
           ? m_iconProvider->iconIdForTaggedFile(taggedFile)
           : QByteArray("");
     } else if (role == TruncatedRole && index.column() == 0) {
-      TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr);
+      TaggedFile* taggedFile = readableTaggedFile(index);
       return taggedFile &&
           ((TagConfig::instance().markTruncations() &&
             taggedFile->getTruncationFlags(Frame::Tag_Id3v1) != 0) ||
@@ -119,23 +124,20 @@ QVariant TaggedFileSystemModel::data(const QModelIndex& index, int role) const
                index.column() >= NUM_FILESYSTEM_COLUMNS &&
                index.column() <
                NUM_FILESYSTEM_COLUMNS + m_tagFrameColumnTypes.size()) {
-      QPersistentModelIndex taggedFileIdx = index.sibling(index.row(), 0);
-      if (auto it = m_taggedFiles.constFind(taggedFileIdx);
-          it != m_taggedFiles.constEnd()) {
-        if (TaggedFile* taggedFile = *it) {
-          Frame::Type type = m_tagFrameColumnTypes.at(index.column() -
-                                                      NUM_FILESYSTEM_COLUMNS);
-          if (Frame frame; taggedFile->getFrame(Frame::Tag_2, type, frame)) {
-            QString value = frame.getValue();
-            if (type == Frame::FT_Track) {
-              bool ok;
-              int intValue = value.toInt(&ok);
-              if (ok) {
-                return intValue;
-              }
+      if (TaggedFile* taggedFile =
+            readableTaggedFile(index.sibling(index.row(), 0))) {
+        Frame::Type type = m_tagFrameColumnTypes.at(index.column() -
+                                                    NUM_FILESYSTEM_COLUMNS);
+        if (Frame frame; taggedFile->getFrame(Frame::Tag_2, type, frame)) {
+          QString value = frame.getValue();
+          if (type == Frame::FT_Track) {
+            bool ok;
+            int intValue = value.toInt(&ok);
+            if (ok) {
+              return intValue;
             }
-            return value;
           }
+          return value;
         }
       }
       return QVariant();
@@ -270,16 +272,35 @@ void TaggedFileSystemModel::resetInternalData()
 
 /**
  * Retrieve tagged file for an index.
+ * If the tagged file is currently read in a worker thread, this waits until
+ * it has been read, so that the caller can access it.
  * @param index model index
  * @return QVariant with tagged file, invalid QVariant if not found.
  */
 QVariant TaggedFileSystemModel::retrieveTaggedFileVariant(
     const QPersistentModelIndex& index) const {
-  if (m_taggedFiles.contains(index))
-    return QVariant::fromValue(m_taggedFiles.value(index));
+  if (auto it = m_taggedFiles.constFind(index);
+      it != m_taggedFiles.constEnd()) {
+    if (TaggedFile* taggedFile = *it) {
+      TaggedFilePrefetcher::finishReading(taggedFile);
+    }
+    return QVariant::fromValue(*it);
+  }
   return QVariant();
 }
 
+/**
+ * Get tagged file for an index if it can be accessed.
+ * @param index model index
+ * @return tagged file, null if not found or currently read in a worker thread.
+ */
+TaggedFile* TaggedFileSystemModel::readableTaggedFile(
+    const QModelIndex& index) const {
+  TaggedFile* taggedFile = m_taggedFiles.value(index, nullptr);
+  return taggedFile && !TaggedFilePrefetcher::isPending(taggedFile)
+      ? taggedFile : nullptr;
+}
+
 /**
  * Store tagged file from variant with index.
  * @param index model index
@@ -292,12 +313,14 @@ bool TaggedFileSystemModel::storeTaggedFileVariant(
     if (value.isValid()) {
       if (value.canConvert<TaggedFile*>()) {
         TaggedFile* oldItem = m_taggedFiles.value(index, nullptr);
+        TaggedFilePrefetcher::waitUntilRead(oldItem);
         delete oldItem;
         m_taggedFiles.insert(index, value.value<TaggedFile*>());
         return true;
       }
     } else {
       if (TaggedFile* oldFile = m_taggedFiles.value(index, nullptr)) {
+        TaggedFilePrefetcher::waitUntilRead(oldFile);
         m_taggedFiles.remove(index);
         delete oldFile;
       }
@@ -310,12 +333,16 @@ bool TaggedFileSystemModel::storeTaggedFileVariant(
  * Clear store with tagged files.
  */
 void TaggedFileSystemModel::clearTaggedFileStore() {
+  for (auto it = m_taggedFiles.constBegin(); it != m_taggedFiles.constEnd(); ++it) {
+    TaggedFilePrefetcher::waitUntilRead(*it);
+  }
   qDeleteAll(m_taggedFiles);
   m_taggedFiles.clear();
 }
 
 /**
  * Initialize tagged file for model index.
+ * If the tag cache is enabled, the tags are taken from the cache if available.
  * @param index model index
  */
 void TaggedFileSystemModel::initTaggedFileData(const QModelIndex& index) {
@@ -323,13 +350,20 @@ void TaggedFileSystemModel::initTaggedFileData(const QModelIndex& index) {
   if (dat.isValid() || isDir(index))
     return;
 
-  dat.setValue(createTaggedFile(fileName(index), index));
+  TaggedFile* taggedFile = createTaggedFile(fileName(index), index);
+  dat.setValue(taggedFile);
   setData(index, dat, TaggedFileRole);
+  if (taggedFile && TagCache::isEnabled()) {
+    // Make the tags of unchanged files available without reading them.
+    taggedFile->readTagsFromCache();
+  }
 }
 
 
 /**
  * Get tagged file data of model index.
+ * If the tagged file is currently read in a worker thread, this waits
+ * until it has been read.
  *
  * @param index model index
  * @param taggedFile a TaggedFile pointer is returned here
@@ -349,6 +383,8 @@ bool TaggedFileSystemModel::getTaggedFileOfIndex(const QModelIndex& index,
 
 /**
  * Get tagged file of model index.
+ * If the tagged file is currently read in a worker thread, this waits
+ * until it has been read.
  *
  * @param index model index
  *
@@ -378,15 +414,11 @@ TaggedFile* TaggedFileSystemModel::createTaggedFile(
     TaggedFile::Feature feature,
     const QString& fileName,
     const QPersistentModelIndex& idx) {
-  TaggedFile* taggedFile = nullptr;
-  const auto factories = s_taggedFileFactories;
-  for (ITaggedFileFactory* factory : factories) {
-    const auto keys = factory->taggedFileKeys();
-    for (const QString& key : keys) {
-      if ((factory->taggedFileFeatures(key) & feature) != 0 &&
-          (taggedFile = factory->createTaggedFile(key, fileName, idx,
-                                                  feature))
-          != nullptr) {
+  const auto factoryKeys = taggedFileFactoryKeys(fileName);
+  for (const TaggedFileFactoryKey& factoryKey : factoryKeys) {
+    if ((factoryKey.features & feature) != 0) {
+      if (TaggedFile* taggedFile = factoryKey.factory->createTaggedFile(
+            factoryKey.key, fileName, idx, feature)) {
         return taggedFile;
       }
     }
@@ -405,16 +437,54 @@ TaggedFile* TaggedFileSystemModel::createTaggedFile(
 TaggedFile* TaggedFileSystemModel::createTaggedFile(
     const QString& fileName,
     const QPersistentModelIndex& idx) {
-  TaggedFile* taggedFile = nullptr;
-  const auto factories = s_taggedFileFactories;
-  for (ITaggedFileFactory* factory : factories) {
+  const auto factoryKeys = taggedFileFactoryKeys(fileName);
+  for (const TaggedFileFactoryKey& factoryKey : factoryKeys) {
+    if (TaggedFile* taggedFile = factoryKey.factory->createTaggedFile(
+          factoryKey.key, fileName, idx)) {
+      return taggedFile;
+    }
+  }
+  return nullptr;
+}
+
+/**
+ * Update the table used to find the tagged file factories supporting a
+ * file extension.
+ * This method shall be called when taggedFileFactories() or their
+ * supported file extensions have changed. The table is also updated
+ * if the factory list has changed since the last update.
+ */
+void TaggedFileSystemModel::updateTaggedFileFactoryLookup()
+{
+  s_factoryKeysForExtension.clear();
+  s_lookupFactories = s_taggedFileFactories;
+  for (ITaggedFileFactory* factory : std::as_const(s_lookupFactories)) {
     const auto keys = factory->taggedFileKeys();
     for (const QString& key : keys) {
-      taggedFile = factory->createTaggedFile(key, fileName, idx);
-      if (taggedFile) {
-        return taggedFile;
+      const TaggedFileFactoryKey factoryKey{
+        factory, key, factory->taggedFileFeatures(key)
+      };
+      const auto extensions = factory->supportedFileExtensions(key);
+      for (const QString& extension : extensions) {
+        s_factoryKeysForExtension[extension.toLower()].append(factoryKey);
       }
     }
   }
-  return nullptr;
+}
+
+/**
+ * Get the factory keys which support the extension of a file.
+ * @param fileName file name
+ * @return factory keys in the order of taggedFileFactories().
+ */
+QList<TaggedFileSystemModel::TaggedFileFactoryKey>
+TaggedFileSystemModel::taggedFileFactoryKeys(const QString& fileName)
+{
+  if (s_lookupFactories != s_taggedFileFactories) {
+    updateTaggedFileFactoryLookup();
+  }
+  if (int dotPos = fileName.lastIndexOf(QLatin1Char('.')); dotPos >= 0) {
+    return s_factoryKeysForExtension.value(fileName.mid(dotPos).toLower());
+  }
+  return {};
 }
@@ -128,6 +128,15 @@ public:
     return s_taggedFileFactories;
   }
 
+  /**
+   * Update the table used to find the tagged file factories supporting a
+   * file extension.
+   * This method shall be called when taggedFileFactories() or their
+   * supported file extensions have changed. The table is also updated
+   * if the factory list has changed since the last update.
+   */
+  static void updateTaggedFileFactoryLookup();
+
   /**
    * Create a tagged file with a given feature.
    *
@@ -156,6 +165,8 @@ public:
 
   /**
    * Get tagged file data of model index.
+   * If the tagged file is currently read in a worker thread, this waits
+   * until it has been read.
    *
    * @param index model index
    * @param taggedFile a TaggedFile pointer is returned here
@@ -167,6 +178,8 @@ public:
 
   /**
    * Get tagged file of model index.
+   * If the tagged file is currently read in a worker thread, this waits
+   * until it has been read.
    *
    * @param index model index
    *
@@ -206,11 +219,21 @@ private slots:
 private:
   /**
    * Retrieve tagged file for an index.
+   * If the tagged file is currently read in a worker thread, this waits until
+   * it has been read, so that the caller can access it.
    * @param index model index
    * @return QVariant with tagged file, invalid QVariant if not found.
    */
   QVariant retrieveTaggedFileVariant(const QPersistentModelIndex& index) const;
 
+  /**
+   * Get tagged file for an index if it can be accessed.
+   * @param index model index
+   * @return tagged file, null if not found or currently read in a worker
+   * thread.
+   */
+  TaggedFile* readableTaggedFile(const QModelIndex& index) const;
+
   /**
    * Store tagged file from variant with index.
    * @param index model index
@@ -231,11 +254,30 @@ private:
    */
   void initTaggedFileData(const QModelIndex& index);
 
+  /** Tagged file key of a factory. */
+  struct TaggedFileFactoryKey {
+    ITaggedFileFactory* factory; /**< tagged file factory */
+    QString key;                 /**< tagged file key */
+    int features;                /**< features supported for key */
+  };
+
+  /**
+   * Get the factory keys which support the extension of a file.
+   * @param fileName file name
+   * @return factory keys in the order of taggedFileFactories().
+   */
+  static QList<TaggedFileFactoryKey> taggedFileFactoryKeys(
+      const QString& fileName);
+
   QHash<QPersistentModelIndex, TaggedFile*> m_taggedFiles;
   QList<Frame::Type> m_tagFrameColumnTypes;
   CoreTaggedFileIconProvider* m_iconProvider;
 
   static QList<ITaggedFileFactory*> s_taggedFileFactories;
+  /** Factory keys for lower case file extensions like ".mp3" */
+  static QHash<QString, QList<TaggedFileFactoryKey>> s_factoryKeysForExtension;
+  /** Factories used to build s_factoryKeysForExtension */
+  static QList<ITaggedFileFactory*> s_lookupFactories;
 };
 
 Q_DECLARE_METATYPE(TaggedFile*)
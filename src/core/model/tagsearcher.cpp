@@ -28,6 +28,9 @@
 #include "trackdatamodel.h"
 #include "fileproxymodel.h"
 #include "bidirfileproxymodeliterator.h"
+#include "fileproxymodeliterator.h"
+#include "taggedfileprefetcher.h"
+#include "tagsearchindex.h"
 
 /**
  * Constructor.
@@ -64,7 +67,9 @@ bool TagSearcher::Position::isValid() const
  * @param parent parent object
  */
 TagSearcher::TagSearcher(QObject* parent) : QObject(parent),
-  m_fileProxyModel(nullptr), m_iterator(nullptr), m_aborted(false), m_started(false)
+  m_fileProxyModel(nullptr), m_iterator(nullptr), m_bulkIterator(nullptr),
+  m_numBulkReplacements(0), m_numBulkFiles(0),
+  m_aborted(false), m_started(false)
 {
 }
 
@@ -95,6 +100,11 @@ void TagSearcher::setModel(FileProxyModel* model)
     delete m_iterator;
     m_iterator = nullptr;
   }
+  if (m_bulkIterator && m_fileProxyModel != model) {
+    m_bulkIterator->abort();
+    delete m_bulkIterator;
+    m_bulkIterator = nullptr;
+  }
   m_fileProxyModel = model;
   if (m_fileProxyModel && !m_iterator) {
     m_iterator = new BiDirFileProxyModelIterator(m_fileProxyModel, this);
@@ -109,6 +119,7 @@ void TagSearcher::setModel(FileProxyModel* model)
  */
 void TagSearcher::setRootIndex(const QPersistentModelIndex& index)
 {
+  m_rootIndex = index;
   m_iterator->setRootIndex(index);
 }
 
@@ -131,6 +142,9 @@ void TagSearcher::abort()
   if (m_iterator) {
     m_iterator->abort();
   }
+  if (m_bulkIterator) {
+    m_bulkIterator->abort();
+  }
 }
 
 /**
@@ -179,7 +193,14 @@ void TagSearcher::searchNextFile(const QPersistentModelIndex& index)
   if (index.isValid()) {
     if (TaggedFile* taggedFile = FileProxyModel::getTaggedFileOfIndex(index)) {
       emit progress(taggedFile->getFilename());
+      TagSearchIndex& searchIndex = TagSearchIndex::instance();
+      if (!TaggedFilePrefetcher::isPending(taggedFile) &&
+          searchIndex.check(taggedFile, m_trigramHashes) ==
+          TagSearchIndex::NoMatch) {
+        return;
+      }
       taggedFile = FileProxyModel::readTagsFromTaggedFile(taggedFile);
+      searchIndex.update(taggedFile);
 
       Position pos;
       if (searchInFile(taggedFile, &pos, 1)) {
@@ -195,6 +216,7 @@ void TagSearcher::searchNextFile(const QPersistentModelIndex& index)
   } else {
     m_started = false;
     m_currentPosition.clear();
+    TagSearchIndex::instance().save();
     emit progress(tr("Search finished"));
     emit textFound();
   }
@@ -250,9 +272,8 @@ bool TagSearcher::searchInFile(TaggedFile* taggedFile, Position* pos,
   FOR_ALL_TAGS(tagNr) {
     if (Position::Part part = Position::tagNumberToPart(tagNr);
         pos->getPart() <= part) {
-      FrameCollection frames;
-      taggedFile->getAllFrames(tagNr, frames);
-      if (searchInFrames(frames, part, pos, advanceChars)) {
+      if (searchInFrames(taggedFile->getAllFramesCached(tagNr), part, pos,
+                         advanceChars)) {
         return true;
       }
     }
@@ -335,9 +356,9 @@ void TagSearcher::replaceNext()
                     m_currentPosition.getMatchedLength(), replaced);
         taggedFile->setFilename(str);
       } else {
-        FrameCollection frames;
-        taggedFile->getAllFrames(
-              Position::partToTagNumber(m_currentPosition.getPart()), frames);
+        // A copy is used because the frames are modified.
+        FrameCollection frames(taggedFile->getAllFramesCached(
+              Position::partToTagNumber(m_currentPosition.getPart())));
         auto it = frames.begin();
         auto end = frames.end();
         for (int frameNr = 0;
@@ -381,6 +402,107 @@ void TagSearcher::replaceAll(const TagSearcher::Parameters& params)
   replaceNext();
 }
 
+/**
+ * Replace all occurrences without stopping at each match.
+ * All replacements in a file are applied with a single setFrames() call
+ * per tag. When finished, bulkReplaceFinished() is emitted.
+ * @param params search parameters
+ */
+void TagSearcher::bulkReplace(const TagSearcher::Parameters& params)
+{
+  setParameters(params);
+  m_aborted = false;
+  m_numBulkReplacements = 0;
+  m_numBulkFiles = 0;
+  m_lastProcessedDirName.clear();
+  if (!m_fileProxyModel) {
+    emit bulkReplaceFinished(0, 0);
+    return;
+  }
+  if (!m_bulkIterator) {
+    m_bulkIterator = new FileProxyModelIterator(m_fileProxyModel);
+    connect(m_bulkIterator, &FileProxyModelIterator::nextReady,
+            this, &TagSearcher::bulkReplaceInNextFile);
+  }
+  m_bulkIterator->clearAborted();
+  m_bulkIterator->start(m_rootIndex);
+}
+
+/**
+ * Replace all occurrences in next file of bulk replace.
+ * @param index index of file in file proxy model, invalid when finished
+ */
+void TagSearcher::bulkReplaceInNextFile(const QPersistentModelIndex& index)
+{
+  if (index.isValid()) {
+    if (TaggedFile* taggedFile = m_aborted
+        ? nullptr : FileProxyModel::getTaggedFileOfIndex(index)) {
+      if (taggedFile->getDirname() != m_lastProcessedDirName) {
+        m_lastProcessedDirName = taggedFile->getDirname();
+        emit progress(m_lastProcessedDirName);
+      }
+      TagSearchIndex& searchIndex = TagSearchIndex::instance();
+      if (!TaggedFilePrefetcher::isPending(taggedFile) &&
+          searchIndex.check(taggedFile, m_trigramHashes) ==
+          TagSearchIndex::NoMatch) {
+        return;
+      }
+      taggedFile = FileProxyModel::readTagsFromTaggedFile(taggedFile);
+      searchIndex.update(taggedFile);
+      if (int numReplacements = replaceAllInFile(taggedFile);
+          numReplacements > 0) {
+        m_numBulkReplacements += numReplacements;
+        ++m_numBulkFiles;
+      }
+    }
+  } else {
+    TagSearchIndex::instance().save();
+    emit progress(tr("Replaced %n occurrence(s)", nullptr,
+                     m_numBulkReplacements));
+    emit bulkReplaceFinished(m_numBulkReplacements, m_numBulkFiles);
+  }
+}
+
+/**
+ * Replace all occurrences in the file name and the tags of a file.
+ * @param taggedFile tagged file
+ * @return number of replaced occurrences.
+ */
+int TagSearcher::replaceAllInFile(TaggedFile* taggedFile) const
+{
+  int numReplacements = 0;
+  if ((m_params.getFlags() & AllFrames) ||
+      (m_params.getFrameMask() & (1ULL << TrackDataModel::FT_FileName))) {
+    QString str = taggedFile->getFilename();
+    if (int count = countInString(str); count > 0) {
+      replaceString(str);
+      taggedFile->setFilename(str);
+      numReplacements += count;
+    }
+  }
+  FOR_ALL_TAGS(tagNr) {
+    FrameCollection frames(taggedFile->getAllFramesCached(tagNr));
+    bool changed = false;
+    for (auto it = frames.begin(); it != frames.end(); ++it) {
+      if ((m_params.getFlags() & AllFrames) ||
+          (m_params.getFrameMask() & (1ULL << it->getType()))) {
+        QString str = it->getValue();
+        if (int count = countInString(str); count > 0) {
+          replaceString(str);
+          auto& frame = const_cast<Frame&>(*it);
+          frame.setValueIfChanged(str);
+          numReplacements += count;
+          changed = true;
+        }
+      }
+    }
+    if (changed) {
+      taggedFile->setFrames(tagNr, frames);
+    }
+  }
+  return numReplacements;
+}
+
 /**
  * If a text is found replace it and then search the next occurrence.
  */
@@ -412,6 +534,23 @@ int TagSearcher::findInString(const QString& str, int& idx) const
   return match.hasMatch() ? match.capturedLength() : -1;
 }
 
+/**
+ * Count occurrences of text in string.
+ * @param str string to be searched
+ * @return number of non-overlapping matches.
+ */
+int TagSearcher::countInString(const QString& str) const
+{
+  int count = 0;
+  int idx = 0;
+  int len;
+  while (idx <= str.length() && (len = findInString(str, idx)) != -1) {
+    ++count;
+    idx += qMax(len, 1);
+  }
+  return count;
+}
+
 /**
  * Replace string.
  * @param str string which will be replaced
@@ -443,9 +582,11 @@ void TagSearcher::setParameters(const Parameters& params)
     m_regExp.setPatternOptions(flags & CaseSensitive
                                ? QRegularExpression::NoPatternOption
                                : QRegularExpression::CaseInsensitiveOption);
+    m_trigramHashes.clear();
   } else {
     m_regExp.setPattern(QString());
     m_regExp.setPatternOptions(QRegularExpression::NoPatternOption);
+    m_trigramHashes = TagSearchIndex::trigramHashes(m_params.getSearchText());
   }
 }
 
@@ -30,12 +30,14 @@
 #include <QString>
 #include <QRegularExpression>
 #include <QPersistentModelIndex>
+#include <QVector>
 #include "iabortable.h"
 #include "frame.h"
 #include "kid3api.h"
 
 class FileProxyModel;
 class BiDirFileProxyModelIterator;
+class FileProxyModelIterator;
 class TaggedFile;
 
 /**
@@ -303,6 +305,14 @@ public slots:
    */
   void replaceAll(const TagSearcher::Parameters& params);
 
+  /**
+   * Replace all occurrences without stopping at each match.
+   * All replacements in a file are applied with a single setFrames() call
+   * per tag. When finished, bulkReplaceFinished() is emitted.
+   * @param params search parameters
+   */
+  void bulkReplace(const TagSearcher::Parameters& params);
+
 signals:
   /**
    * Emitted when a match is found.
@@ -323,9 +333,17 @@ signals:
    */
   void progress(const QString& msg);
 
+  /**
+   * Emitted when bulkReplace() is finished or aborted.
+   * @param numReplacements number of replaced occurrences
+   * @param numFiles number of modified files
+   */
+  void bulkReplaceFinished(int numReplacements, int numFiles);
+
 private slots:
   void searchNextFile(const QPersistentModelIndex& index);
   void replaceThenFindNext();
+  void bulkReplaceInNextFile(const QPersistentModelIndex& index);
 
 private:
   void setParameters(const Parameters& params);
@@ -338,15 +356,24 @@ private:
                       Position::Part part, Position* pos,
                       int advanceChars) const;
   int findInString(const QString& str, int& idx) const;
+  int countInString(const QString& str) const;
+  int replaceAllInFile(TaggedFile* taggedFile) const;
   void replaceString(QString& str) const;
   QString getLocationString(const TaggedFile* taggedFile) const;
 
   FileProxyModel* m_fileProxyModel;
   BiDirFileProxyModelIterator* m_iterator;
+  FileProxyModelIterator* m_bulkIterator;
+  QPersistentModelIndex m_rootIndex;
   QPersistentModelIndex m_startIndex;
   Position m_currentPosition;
   Parameters m_params;
   QRegularExpression m_regExp;
+  /** Trigram hashes of search text to skip files using TagSearchIndex */
+  QVector<quint64> m_trigramHashes;
+  QString m_lastProcessedDirName;
+  int m_numBulkReplacements;
+  int m_numBulkFiles;
   bool m_aborted;
   bool m_started;
 };
@@ -0,0 +1,381 @@
+/**
+ * \file tagsearchindex.cpp
+ * Index to skip files which cannot contain a searched text.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tagsearchindex.h"
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include "taggedfile.h"
+#include "tagcache.h"
+#include "tagconfig.h"
+
+namespace {
+
+/** Magic number at the start of the index file. */
+constexpr quint32 INDEX_MAGIC = 0x4b335349;
+/** Version of the index file format, increment when the format changes. */
+constexpr quint32 INDEX_VERSION = 2;
+/** Number of bits set in the Bloom filter for each trigram. */
+constexpr int NUM_BIT_HASHES = 3;
+/** Minimum and maximum size of a Bloom filter in bytes. */
+constexpr int MIN_FILTER_BYTES = 32;
+constexpr int MAX_FILTER_BYTES = 2048;
+
+/**
+ * Get size, modification and status change time of a file.
+ * @param filePath path to file
+ * @param size the size is returned here
+ * @param modified the modification time is returned here
+ * @param changed the status change time is returned here
+ * @return true if file exists.
+ */
+bool getFileStatus(const QString& filePath,
+                   qint64& size, qint64& modified, qint64& changed)
+{
+  QFileInfo fi(filePath);
+  if (!fi.exists()) {
+    return false;
+  }
+  size = fi.size();
+  modified = fi.lastModified().toMSecsSinceEpoch();
+  // The modification time is preserved when tags are written with
+  // "Preserve file timestamp", but the status change time is not.
+#if QT_VERSION >= 0x050a00
+  changed = fi.metadataChangeTime().toMSecsSinceEpoch();
+#else
+  changed = 0;
+#endif
+  return true;
+}
+
+/**
+ * Add the hashes of the trigrams of a string.
+ * @param str case folded string
+ * @param hashes the hashes are appended here
+ */
+void addTrigramHashes(const QString& str, QVector<quint64>& hashes)
+{
+  for (int i = 0; i + 2 < str.length(); ++i) {
+    quint64 key = str.at(i).unicode() |
+        (static_cast<quint64>(str.at(i + 1).unicode()) << 16) |
+        (static_cast<quint64>(str.at(i + 2).unicode()) << 32);
+    // Finalizer of MurmurHash3 to spread the bits.
+    key ^= key >> 33;
+    key *= Q_UINT64_C(0xff51afd7ed558ccd);
+    key ^= key >> 33;
+    key *= Q_UINT64_C(0xc4ceb9fe1a85ec53);
+    key ^= key >> 33;
+    hashes.append(key);
+  }
+}
+
+/**
+ * Get bit positions of a trigram hash in a Bloom filter.
+ * Uses double hashing with the two halves of the hash.
+ * @param hash trigram hash
+ * @param i number of bit hash, 0 .. NUM_BIT_HASHES - 1
+ * @param numBits number of bits in filter, a power of two
+ * @return bit position.
+ */
+inline quint32 bitPosition(quint64 hash, int i, quint32 numBits)
+{
+  return (static_cast<quint32>(hash) +
+          static_cast<quint32>(i) * static_cast<quint32>(hash >> 32)) &
+      (numBits - 1);
+}
+
+/**
+ * Get the settings which affect the frame values stored in the index.
+ * @return context string, entries created with a different context are
+ * invalid.
+ */
+QString indexContext()
+{
+  return TagConfig::instance().textEncodingV1();
+}
+
+/**
+ * Create Bloom filter with trigram hashes.
+ * @param hashes trigram hashes
+ * @return filter bits.
+ */
+QByteArray createFilter(const QVector<quint64>& hashes)
+{
+  // About 10 bits per trigram give a false positive rate below 2%
+  // with 3 bit hashes.
+  int numBytes = MIN_FILTER_BYTES;
+  while (numBytes < MAX_FILTER_BYTES && numBytes * 8 < hashes.size() * 10) {
+    numBytes *= 2;
+  }
+  QByteArray bits(numBytes, '\0');
+  const auto numBits = static_cast<quint32>(numBytes * 8);
+  for (quint64 hash : hashes) {
+    for (int i = 0; i < NUM_BIT_HASHES; ++i) {
+      const quint32 pos = bitPosition(hash, i, numBits);
+      bits[pos >> 3] = static_cast<char>(bits.at(pos >> 3) | (1 << (pos & 7)));
+    }
+  }
+  return bits;
+}
+
+/**
+ * Check if all trigram hashes are contained in a Bloom filter.
+ * @param bits filter bits
+ * @param hashes trigram hashes
+ * @return true if all hashes may be contained.
+ */
+bool filterContains(const QByteArray& bits, const QVector<quint64>& hashes)
+{
+  const auto numBits = static_cast<quint32>(bits.size() * 8);
+  if (numBits == 0) {
+    return true;
+  }
+  for (quint64 hash : hashes) {
+    for (int i = 0; i < NUM_BIT_HASHES; ++i) {
+      if (const quint32 pos = bitPosition(hash, i, numBits);
+          (bits.at(pos >> 3) & (1 << (pos & 7))) == 0) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+}
+
+/**
+ * Get index instance.
+ * @return tag search index.
+ */
+TagSearchIndex& TagSearchIndex::instance()
+{
+  static TagSearchIndex index;
+  return index;
+}
+
+/**
+ * Get the hashes of the case folded trigrams of a search text.
+ *
+ * @param text search text
+ *
+ * @return trigram hashes, empty if the text is too short to use the index.
+ */
+QVector<quint64> TagSearchIndex::trigramHashes(const QString& text)
+{
+  QVector<quint64> hashes;
+  addTrigramHashes(text.toCaseFolded(), hashes);
+  return hashes;
+}
+
+/**
+ * Check if a file can contain a search text.
+ *
+ * @param taggedFile tagged file
+ * @param hashes trigram hashes of search text from trigramHashes()
+ *
+ * @return NoMatch if the file cannot contain the text.
+ */
+TagSearchIndex::Match TagSearchIndex::check(const TaggedFile* taggedFile,
+                                            const QVector<quint64>& hashes)
+{
+  if (hashes.isEmpty() || taggedFile->isChanged()) {
+    return Unknown;
+  }
+  load();
+  const Entry* entry = findEntry(taggedFile->getAbsFilename());
+  if (!entry) {
+    return Unknown;
+  }
+  return filterContains(entry->bits, hashes) ? PossibleMatch : NoMatch;
+}
+
+/**
+ * Add or update the entry for a file if it is not up-to-date.
+ * The tags of the file must have been read.
+ *
+ * @param taggedFile tagged file
+ */
+void TagSearchIndex::update(TaggedFile* taggedFile)
+{
+  if (taggedFile->isChanged() || !taggedFile->isTagInformationRead()) {
+    return;
+  }
+  load();
+  const QString filePath = taggedFile->getAbsFilename();
+  if (findEntry(filePath)) {
+    return;
+  }
+  Entry entry;
+  if (!getFileStatus(filePath, entry.size, entry.modified, entry.changed)) {
+    return;
+  }
+  QVector<quint64> hashes;
+  addTrigramHashes(taggedFile->getFilename().toCaseFolded(), hashes);
+  FOR_ALL_TAGS(tagNr) {
+    FrameCollection frames;
+    taggedFile->getAllFrames(tagNr, frames);
+    for (const Frame& frame : frames) {
+      addTrigramHashes(frame.getValue().toCaseFolded(), hashes);
+    }
+  }
+  entry.bits = createFilter(hashes);
+  m_entries.insert(filePath, entry);
+  m_dirty = true;
+}
+
+/**
+ * Remove the entry of a file.
+ * @param filePath path to file
+ */
+void TagSearchIndex::remove(const QString& filePath)
+{
+  if (m_entries.remove(filePath) > 0) {
+    m_dirty = true;
+  }
+}
+
+/**
+ * Find up-to-date entry for a file.
+ * Outdated entries are removed.
+ * @param filePath path to file
+ * @return entry, nullptr if not found or outdated.
+ */
+const TagSearchIndex::Entry* TagSearchIndex::findEntry(const QString& filePath)
+{
+  auto it = m_entries.constFind(filePath);
+  if (it == m_entries.constEnd()) {
+    return nullptr;
+  }
+  qint64 size, modified, changed;
+  if (!getFileStatus(filePath, size, modified, changed) ||
+      size != it->size || modified != it->modified || changed != it->changed) {
+    m_entries.remove(filePath);
+    m_dirty = true;
+    return nullptr;
+  }
+  return &*it;
+}
+
+/**
+ * Get path to index file.
+ * @return path in cache directory, empty if not available.
+ */
+QString TagSearchIndex::indexFilePath()
+{
+  const QString dirPath =
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return dirPath.isEmpty()
+      ? QString() : dirPath + QLatin1String("/searchindex.dat");
+}
+
+/**
+ * Read index from cache directory if not already done.
+ * All entries are removed if the settings affecting the frame values
+ * have been changed since they were created.
+ */
+void TagSearchIndex::load()
+{
+  const QString context = indexContext();
+  if (m_loaded) {
+    if (context != m_context) {
+      m_entries.clear();
+      m_context = context;
+      m_dirty = true;
+    }
+    return;
+  }
+  m_loaded = true;
+  m_context = context;
+  if (!TagCache::isEnabled()) {
+    return;
+  }
+  QFile file(indexFilePath());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_DefaultCompiledVersion);
+  quint32 magic, version;
+  qint32 streamVersion;
+  QString storedContext;
+  stream >> magic >> version >> streamVersion;
+  if (stream.status() != QDataStream::Ok || magic != INDEX_MAGIC ||
+      version != INDEX_VERSION || streamVersion != stream.version()) {
+    return;
+  }
+  stream >> storedContext;
+  if (stream.status() != QDataStream::Ok || storedContext != m_context) {
+    return;
+  }
+  quint32 numEntries;
+  stream >> numEntries;
+  for (quint32 i = 0;
+       i < numEntries && stream.status() == QDataStream::Ok;
+       ++i) {
+    QString filePath;
+    Entry entry;
+    stream >> filePath >> entry.size >> entry.modified >> entry.changed
+           >> entry.bits;
+    m_entries.insert(filePath, entry);
+  }
+  if (stream.status() != QDataStream::Ok) {
+    m_entries.clear();
+  }
+}
+
+/**
+ * Store the index in the cache directory if it has been changed and the
+ * tag cache is enabled.
+ */
+void TagSearchIndex::save()
+{
+  if (!m_dirty || !TagCache::isEnabled()) {
+    return;
+  }
+  const QString filePath = indexFilePath();
+  if (filePath.isEmpty() || !QDir().mkpath(QFileInfo(filePath).path())) {
+    return;
+  }
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_DefaultCompiledVersion);
+  stream << INDEX_MAGIC << INDEX_VERSION
+         << static_cast<qint32>(stream.version()) << m_context
+         << static_cast<quint32>(m_entries.size());
+  for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+    stream << it.key() << it->size << it->modified << it->changed << it->bits;
+  }
+  if (stream.status() == QDataStream::Ok && file.commit()) {
+    m_dirty = false;
+  }
+}
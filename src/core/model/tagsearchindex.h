@@ -0,0 +1,149 @@
+/**
+ * \file tagsearchindex.h
+ * Index to skip files which cannot contain a searched text.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QVector>
+#include "kid3api.h"
+
+class TaggedFile;
+
+/**
+ * Index with the trigrams of the file names and frame values of files.
+ *
+ * For each file, the case folded trigrams of its file name and frame values
+ * are stored in a bit signature (a Bloom filter). A file whose signature
+ * does not contain all trigrams of a search text cannot contain the text,
+ * so its tags do not have to be read and searched. False positives are
+ * possible, false negatives are not, so the files which may contain the text
+ * still have to be searched.
+ *
+ * An entry is only used as long as the size, modification and status change
+ * time of the file are unchanged and the tagged file is not modified in
+ * memory, and as long as the settings used to read the frame values, e.g.
+ * the text encoding of ID3v1 tags, are unchanged. The entries are added
+ * while files are searched. If the tag cache is enabled, the index is stored
+ * in the cache directory.
+ */
+class KID3_CORE_EXPORT TagSearchIndex {
+public:
+  /** Result of check(). */
+  enum Match {
+    Unknown,       /**< No up-to-date entry for the file */
+    NoMatch,       /**< File cannot contain the text */
+    PossibleMatch  /**< File may contain the text */
+  };
+
+  /**
+   * Get index instance.
+   * @return tag search index.
+   */
+  static TagSearchIndex& instance();
+
+  /**
+   * Get the hashes of the case folded trigrams of a search text.
+   *
+   * @param text search text
+   *
+   * @return trigram hashes, empty if the text is too short to use the index.
+   */
+  static QVector<quint64> trigramHashes(const QString& text);
+
+  /**
+   * Check if a file can contain a search text.
+   *
+   * @param taggedFile tagged file
+   * @param hashes trigram hashes of search text from trigramHashes()
+   *
+   * @return NoMatch if the file cannot contain the text.
+   */
+  Match check(const TaggedFile* taggedFile, const QVector<quint64>& hashes);
+
+  /**
+   * Add or update the entry for a file if it is not up-to-date.
+   * The tags of the file must have been read.
+   *
+   * @param taggedFile tagged file
+   */
+  void update(TaggedFile* taggedFile);
+
+  /**
+   * Remove the entry of a file.
+   * @param filePath path to file
+   */
+  void remove(const QString& filePath);
+
+  /**
+   * Store the index in the cache directory if it has been changed and the
+   * tag cache is enabled.
+   */
+  void save();
+
+private:
+  /** Index entry for a file. */
+  struct Entry {
+    qint64 size;      /**< size of file */
+    qint64 modified;  /**< modification time of file in ms since epoch */
+    qint64 changed;   /**< status change time of file in ms since epoch */
+    QByteArray bits;  /**< Bloom filter with trigram hashes */
+  };
+
+  TagSearchIndex() = default;
+  ~TagSearchIndex() = default;
+  TagSearchIndex(const TagSearchIndex&) = delete;
+  TagSearchIndex& operator=(const TagSearchIndex&) = delete;
+
+  /**
+   * Find up-to-date entry for a file.
+   * Outdated entries are removed.
+   * @param filePath path to file
+   * @return entry, nullptr if not found or outdated.
+   */
+  const Entry* findEntry(const QString& filePath);
+
+  /**
+   * Read index from cache directory if not already done.
+   * All entries are removed if the settings affecting the frame values
+   * have been changed since they were created.
+   */
+  void load();
+
+  /**
+   * Get path to index file.
+   * @return path in cache directory, empty if not available.
+   */
+  static QString indexFilePath();
+
+  QHash<QString, Entry> m_entries;
+  /** settings affecting the frame values of the entries */
+  QString m_context;
+  bool m_loaded = false;
+  bool m_dirty = false;
+};
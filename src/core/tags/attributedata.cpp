@@ -80,13 +80,13 @@ AttributeData::AttributeData(const QString& name)
     { "WM/Writer", Utf16 }
   };
 
-  static QMap<QString, int> strNumMap;
-  if (strNumMap.empty()) {
-    // first time initialization
+  static const QMap<QString, int> strNumMap = [] {
+    QMap<QString, int> map;
     for (const auto& [str, type] : typeOfWmPriv) {
-      strNumMap.insert(QString::fromLatin1(str), type);
+      map.insert(QString::fromLatin1(str), type);
     }
-  }
+    return map;
+  }();
   auto it = strNumMap.constFind(name);
   m_type = it != strNumMap.constEnd() ? static_cast<Type>(*it) : Unknown;
 }
@@ -27,6 +27,7 @@
 #include "formatreplacer.h"
 #include <QUrl>
 #include "saferename.h"
+#include "performancestatistics.h"
 
 /**
  * Constructor.
@@ -90,6 +91,8 @@ void FormatReplacer::replaceEscapedChars()
  */
 void FormatReplacer::replacePercentCodes(unsigned flags)
 {
+  PerformanceStatistics::ScopedTimer timer(
+      PerformanceStatistics::ReplacePercentCodes);
   if (!m_str.isEmpty()) {
     for (int pos = 0; pos < m_str.length();) {
       pos = m_str.indexOf(QLatin1Char('%'), pos);
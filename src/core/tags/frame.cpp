@@ -336,13 +336,13 @@ QMap<QByteArray, QByteArray> getDisplayNamesOfIds()
     { "ISHP", QT_TRANSLATE_NOOP("@default", "Sharpness") },
     { "ISRF", QT_TRANSLATE_NOOP("@default", "Source Form") }
   };
-  static QMap<QByteArray, QByteArray> idStrMap;
-  if (idStrMap.isEmpty()) {
-    // first time initialization
+  static const QMap<QByteArray, QByteArray> idStrMap = [] {
+    QMap<QByteArray, QByteArray> map;
     for (const auto& [id, str] : strOfId) {
-      idStrMap.insert(id, str);
+      map.insert(id, str);
     }
-  }
+    return map;
+  }();
   return idStrMap;
 }
 
@@ -364,6 +364,114 @@ Frame::FieldList reducedFieldList(const Frame::FieldList& fieldList)
   return reduced;
 }
 
+/**
+ * Check if a frame name matches a name searched with
+ * FrameCollection::searchByName() using temporary upper case strings.
+ *
+ * @param ucName searched name converted to upper case and without '/'
+ * @param frameName frame name
+ *
+ * @return true if the frame name or the description after its first newline
+ * starts with @a ucName.
+ */
+bool frameNameMatchesConverted(const QString& ucName, const QString& frameName)
+{
+  QString ucFrameName(frameName.toUpper().remove(QLatin1Char('/')));
+  int len = ucName.length();
+#if QT_VERSION >= 0x060000
+  if (ucName == ucFrameName.left(len))
+#else
+  // Do not return ASF "Rating Information" when searching for "Rating".
+  if (ucName == ucFrameName.leftRef(len) &&
+      !(ucName == QLatin1String("RATING") &&
+        ucFrameName == QLatin1String("RATING INFORMATION")))
+#endif
+  {
+    return true;
+  }
+  int nlPos = ucFrameName.indexOf(QLatin1Char('\n'));
+#if QT_VERSION >= 0x060000
+  // Description in TXXX, WXXX, COMM, PRIV matches
+  return nlPos > 0 && ucName == ucFrameName.mid(nlPos + 1, len);
+#else
+  return nlPos > 0 && ucName == ucFrameName.midRef(nlPos + 1, len);
+#endif
+}
+
+/**
+ * Check if an ASCII string starting at a position matches a name ignoring
+ * case and '/' characters.
+ *
+ * @param ucName name in upper case without '/'
+ * @param str ASCII string, QString or QLatin1String
+ * @param pos position in @a str where the comparison starts
+ *
+ * @return true if @a str starts with @a ucName at @a pos.
+ */
+template<class Str>
+bool asciiStartsWith(const QString& ucName, const Str& str, int pos)
+{
+  const int size = str.size();
+  const int len = ucName.size();
+  int ucPos = 0;
+  for (; pos < size && ucPos < len; ++pos) {
+    auto c = str.at(pos).unicode();
+    if (c == '/') {
+      continue;
+    }
+    if (c >= 'a' && c <= 'z') {
+      c -= 'a' - 'A';
+    }
+    if (c != ucName.at(ucPos).unicode()) {
+      return false;
+    }
+    ++ucPos;
+  }
+  return ucPos == len;
+}
+
+/**
+ * Check if a frame name matches a name searched with
+ * FrameCollection::searchByName().
+ * ASCII frame names are compared character by character without
+ * creating temporary strings.
+ *
+ * @param ucName searched name converted to upper case and without '/'
+ * @param frameName frame name, QString or QLatin1String
+ *
+ * @return true if the frame name or the description after its first newline
+ * starts with @a ucName.
+ */
+template<class Str>
+bool frameNameMatches(const QString& ucName, const Str& frameName)
+{
+  const int size = frameName.size();
+  int nlPos = -1;
+  bool charBeforeNewline = false;
+  for (int i = 0; i < size; ++i) {
+    const auto c = frameName.at(i).unicode();
+    if (c >= 0x80) {
+      // Conversion to upper case can change the length of non ASCII strings.
+      return frameNameMatchesConverted(ucName, QString(frameName));
+    }
+    if (nlPos == -1) {
+      if (c == '\n') {
+        nlPos = i;
+      } else if (c != '/') {
+        charBeforeNewline = true;
+      }
+    }
+  }
+#if QT_VERSION < 0x060000
+  if (ucName == QLatin1String("RATING")) {
+    return frameNameMatchesConverted(ucName, QString(frameName));
+  }
+#endif
+  return asciiStartsWith(ucName, frameName, 0) ||
+      (nlPos != -1 && charBeforeNewline &&
+       asciiStartsWith(ucName, frameName, nlPos + 1));
+}
+
 }
 
 Frame::ExtendedType::ExtendedType(const QString& name) :
@@ -834,15 +942,15 @@ QVariant Frame::getField(const Frame& frame, const QString& fieldName)
  */
 Frame::Type Frame::getTypeFromName(const QString& name)
 {
-  static QMap<QString, int> strNumMap;
-  if (strNumMap.empty()) {
-    // first time initialization
+  static const QMap<QString, int> strNumMap = [] {
+    QMap<QString, int> map;
     for (int i = 0; i < Frame::FT_Custom1; ++i) {
       auto type = static_cast<Frame::Type>(i);
-      strNumMap.insert(QString::fromLatin1(getNameFromType(type))
-                       .remove(QLatin1Char(' ')).toUpper(), type);
+      map.insert(QString::fromLatin1(getNameFromType(type))
+                 .remove(QLatin1Char(' ')).toUpper(), type);
     }
-  }
+    return map;
+  }();
   QString ucName(name.toUpper());
   ucName.remove(QLatin1Char(' '));
   if (auto it = strNumMap.constFind(ucName); it != strNumMap.constEnd()) {
@@ -918,22 +1026,22 @@ QMap<QString, QString> Frame::getDisplayNameMap(const QStringList& names)
  */
 QString Frame::getNameForTranslatedFrameName(const QString& name)
 {
-  static QMap<QString, QString> nameMap;
-  if (nameMap.isEmpty()) {
-    // first time initialization
+  static const QMap<QString, QString> nameMap = [] {
+    QMap<QString, QString> map;
     for (int k = Frame::FT_FirstFrame; k < Frame::FT_Custom1; ++k) {
       QString typeName = Frame::ExtendedType(static_cast<Frame::Type>(k),
                                          QLatin1String("")).getName();
-      nameMap.insert(QCoreApplication::translate("@default",
-                         typeName.toLatin1().constData()), typeName);
+      map.insert(QCoreApplication::translate("@default",
+                     typeName.toLatin1().constData()), typeName);
     }
     QMap<QByteArray, QByteArray> idStrMap = getDisplayNamesOfIds();
     const auto names = idStrMap.values();
     for (const QByteArray& frameName : names) {
-      nameMap.insert(QCoreApplication::translate("@default", frameName),
-                     QString::fromLatin1(frameName));
+      map.insert(QCoreApplication::translate("@default", frameName),
+                 QString::fromLatin1(frameName));
     }
-  }
+    return map;
+  }();
   return nameMap.value(name, name);
 }
 
@@ -945,15 +1053,15 @@ QString Frame::getNameForTranslatedFrameName(const QString& name)
  */
 QByteArray Frame::getFrameIdForTranslatedFrameName(const QString& name)
 {
-  static QMap<QString, QByteArray> nameMap;
-  if (nameMap.isEmpty()) {
-    // first time initialization
+  static const QMap<QString, QByteArray> nameMap = [] {
+    QMap<QString, QByteArray> map;
     const QMap<QByteArray, QByteArray> idStrMap = getDisplayNamesOfIds();
     for (auto it = idStrMap.constBegin(); it != idStrMap.constEnd(); ++it) {
-      nameMap.insert(QCoreApplication::translate("@default", it.value()),
-                     it.key());
+      map.insert(QCoreApplication::translate("@default", it.value()),
+                 it.key());
     }
-  }
+    return map;
+  }();
   return nameMap.value(name);
 }
 
@@ -977,17 +1085,6 @@ QByteArray Frame::getNameForCustomFrame(Frame::Type type)
  */
 Frame::Type Frame::getTypeFromCustomFrameName(const QByteArray& name)
 {
-  if (customFrameNameMap.isEmpty()) {
-    // first time initialization
-    for (int i = 0; i < customFrameNames.size(); ++i) {
-      auto type = static_cast<Frame::Type>(FT_Custom1 + i);
-      if (QByteArray customFrameName = customFrameNames.at(i).toUpper()
-            .replace(' ', QByteArray());
-          !customFrameName.isEmpty()) {
-        customFrameNameMap.insert(customFrameName, type);
-      }
-    }
-  }
   auto ucName = name.toUpper().replace(' ', QByteArray());
   if (auto it = customFrameNameMap.constFind(ucName);
       it != customFrameNameMap.constEnd()) {
@@ -1023,8 +1120,17 @@ bool Frame::setNamesForCustomFrames(const QStringList& customNames)
   }
   if (customFrameNames != newCustomFrameNames) {
     customFrameNames.swap(newCustomFrameNames);
-    // Invalidate mapping used by getTypeFromName()
+    // The mapping used by getTypeFromName() is built here and not when it is
+    // first used because it is also read from worker threads.
     customFrameNameMap.clear();
+    for (int i = 0; i < customFrameNames.size(); ++i) {
+      auto type = static_cast<Frame::Type>(FT_Custom1 + i);
+      if (QByteArray customFrameName = customFrameNames.at(i).toUpper()
+            .replace(' ', QByteArray());
+          !customFrameName.isEmpty()) {
+        customFrameNameMap.insert(customFrameName, type);
+      }
+    }
     return true;
   }
   return false;
@@ -1429,7 +1535,9 @@ void FrameCollection::setIndexesInvalid()
 void FrameCollection::merge(const FrameCollection& frames)
 {
   for (auto otherIt = frames.cbegin(); otherIt != frames.cend(); ++otherIt) {
-    if (auto it = find(*otherIt); it != end()) {
+    // The lower bound is used as a hint for the insertion of a new frame.
+    if (auto it = lower_bound(*otherIt);
+        it != end() && !key_comp()(*otherIt, *it)) {
       QString value(otherIt->getValue());
       if (auto& frameFound = const_cast<Frame&>(*it);
           frameFound.getValue().isEmpty() && !value.isEmpty()) {
@@ -1439,7 +1547,7 @@ void FrameCollection::merge(const FrameCollection& frames)
       Frame frame(*otherIt);
       frame.setIndex(-1);
       frame.setValueChanged(true);
-      insert(frame);
+      insert(it, frame);
     }
   }
 }
@@ -1477,33 +1585,18 @@ FrameCollection::const_iterator FrameCollection::searchByName(
 
   const_iterator it;
   QString ucName = name.toUpper().remove(QLatin1Char('/'));
-  int len = ucName.length();
   for (it = cbegin(); it != cend(); ++it) {
-    const QStringList names{it->getName(), it->getInternalName()};
-    for (const QString& frameName : names) {
-      QString ucFrameName(frameName.toUpper().remove(QLatin1Char('/')));
-#if QT_VERSION >= 0x060000
-      if (ucName == ucFrameName.left(len))
-#else
-      // Do not return ASF "Rating Information" when searching for "Rating".
-      if (ucName == ucFrameName.leftRef(len) &&
-          !(ucName == QLatin1String("RATING") &&
-            ucFrameName == QLatin1String("RATING INFORMATION")))
-#endif
-      {
-        return it;
-      }
-      int nlPos = ucFrameName.indexOf(QLatin1Char('\n'));
-#if QT_VERSION >= 0x060000
-      if (nlPos > 0 && ucName == ucFrameName.mid(nlPos + 1, len))
-#else
-      if (nlPos > 0 && ucName == ucFrameName.midRef(nlPos + 1, len))
-#endif
-      {
-        // Description in TXXX, WXXX, COMM, PRIV matches
+    // The name of standard types is compared without converting it to a
+    // QString, the internal name of other types is the same as their name.
+    const Frame::Type type = it->getType();
+    if (type != Frame::FT_Other) {
+      if (frameNameMatches(ucName, QLatin1String(getNameFromType(type)))) {
         return it;
       }
     }
+    if (frameNameMatches(ucName, it->getInternalName())) {
+      return it;
+    }
   }
   return it;
 }
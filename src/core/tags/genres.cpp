@@ -473,13 +473,13 @@ int Genres::getIndex(int num)
  */
 int Genres::getNumber(const QString& str)
 {
-  static QMap<QString, int> strNumMap;
-  if (strNumMap.empty()) {
-    // first time initialization
+  static const QMap<QString, int> strNumMap = [] {
+    QMap<QString, int> map;
     for (int i = 0; i < Genres::count + 1; i++) {
-      strNumMap.insert(QString::fromLatin1(s_genre[i]), s_genreNum[i]);
+      map.insert(QString::fromLatin1(s_genre[i]), s_genreNum[i]);
     }
-  }
+    return map;
+  }();
   if (auto it = strNumMap.constFind(str); it != strNumMap.constEnd()) {
     return *it;
   }
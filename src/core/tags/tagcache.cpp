@@ -0,0 +1,579 @@
+/**
+ * \file tagcache.cpp
+ * Persistent cache with the tags of files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tagcache.h"
+#include <QDataStream>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QLockFile>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include "tagconfig.h"
+
+namespace {
+
+/** Magic number at the start of the cache file. */
+constexpr quint32 CACHE_MAGIC = 0x4b334443;
+/** Version of the cache file format, increment when the format changes. */
+constexpr quint32 CACHE_VERSION = 2;
+/** Size of the header with magic, version and stream version. */
+constexpr qint64 HEADER_SIZE = 12;
+/** Milliseconds to wait for another process modifying the cache file. */
+constexpr int LOCK_TIMEOUT_MS = 2000;
+
+/**
+ * Get size and modification time of a file.
+ * @param filePath path to file
+ * @param size the size is returned here
+ * @param modified the modification time is returned here
+ * @return true if file exists.
+ */
+bool getFileStatus(const QString& filePath, qint64& size, qint64& modified)
+{
+  QFileInfo fi(filePath);
+  if (!fi.exists()) {
+    return false;
+  }
+  size = fi.size();
+  modified = fi.lastModified().toMSecsSinceEpoch();
+  return true;
+}
+
+/**
+ * Set up a data stream to use the same format for all cache data.
+ * @param stream data stream
+ */
+void initStream(QDataStream& stream)
+{
+  stream.setVersion(QDataStream::Qt_DefaultCompiledVersion);
+}
+
+/**
+ * Serialize a cache entry.
+ * @param filePath path to file, stored to verify the entry when it is read
+ * @param entry cache entry
+ * @return serialized entry.
+ */
+QByteArray entryToData(const QString& filePath, const TagCache::Entry& entry)
+{
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  initStream(stream);
+  const TaggedFile::DetailInfo& info = entry.detailInfo;
+  stream << filePath << entry.fileExtension << info.format
+         << static_cast<qint32>(info.channelMode)
+         << static_cast<quint32>(info.channels)
+         << static_cast<quint32>(info.sampleRate)
+         << static_cast<quint32>(info.bitrate)
+         << static_cast<quint64>(info.duration) << info.valid << info.vbr;
+  for (const TagCache::Tag& tag : entry.tags) {
+    stream << tag.format << static_cast<qint32>(tag.type) << tag.supported
+           << tag.hasTag << tag.values << tag.frames;
+  }
+  return data;
+}
+
+/**
+ * Deserialize a cache entry.
+ * @param data serialized entry
+ * @param filePath path to file which must match the path in the entry
+ * @param entry the cache entry is returned here
+ * @return true if ok, false if @a data is invalid or belongs to another file,
+ * which can happen if the cache file has been modified by another process.
+ */
+bool entryFromData(const QByteArray& data, const QString& filePath,
+                   TagCache::Entry& entry)
+{
+  QDataStream stream(data);
+  initStream(stream);
+  QString path;
+  stream >> path;
+  if (stream.status() != QDataStream::Ok || path != filePath) {
+    return false;
+  }
+  TaggedFile::DetailInfo& info = entry.detailInfo;
+  qint32 channelMode;
+  quint32 channels, sampleRate, bitrate;
+  quint64 duration;
+  stream >> entry.fileExtension >> info.format >> channelMode >> channels
+         >> sampleRate >> bitrate >> duration >> info.valid >> info.vbr;
+  info.channelMode =
+      static_cast<TaggedFile::DetailInfo::ChannelMode>(channelMode);
+  info.channels = channels;
+  info.sampleRate = sampleRate;
+  info.bitrate = bitrate;
+  info.duration = static_cast<unsigned long>(duration);
+  for (TagCache::Tag& tag : entry.tags) {
+    qint32 type;
+    stream >> tag.format >> type >> tag.supported >> tag.hasTag
+           >> tag.values >> tag.frames;
+    tag.type = static_cast<TaggedFile::TagType>(type);
+  }
+  return stream.status() == QDataStream::Ok;
+}
+
+}
+
+/**
+ * Get cache instance.
+ * @return tag cache.
+ */
+TagCache& TagCache::instance()
+{
+  static TagCache tagCache;
+  return tagCache;
+}
+
+/**
+ * Check if the tag cache is enabled in the configuration.
+ * @return true if enabled.
+ */
+bool TagCache::isEnabled()
+{
+  return TagConfig::instance().tagCacheEnabled();
+}
+
+/**
+ * Get cache entry for a file.
+ *
+ * @param filePath path to file
+ * @param context backend and settings which have to match the entry
+ * @param entry the cache entry is returned here
+ *
+ * @return true if an up-to-date entry was found.
+ */
+bool TagCache::lookup(const QString& filePath, const QString& context,
+                      Entry& entry)
+{
+  QMutexLocker locker(&m_mutex);
+  Record record;
+  if (!findRecord(filePath, record) || record.context != context ||
+      !m_file.seek(record.offset)) {
+    return false;
+  }
+  QDataStream stream(&m_file);
+  initStream(stream);
+  QByteArray data;
+  stream >> data;
+  if (stream.status() != QDataStream::Ok ||
+      !entryFromData(data, filePath, entry)) {
+    return false;
+  }
+  entry.context = record.context;
+  return true;
+}
+
+/**
+ * Check if an up-to-date entry exists for a file.
+ *
+ * @param filePath path to file
+ * @param context backend and settings which have to match the entry
+ *
+ * @return true if the file does not have to be stored again.
+ */
+bool TagCache::contains(const QString& filePath, const QString& context)
+{
+  QMutexLocker locker(&m_mutex);
+  Record record;
+  return findRecord(filePath, record) && record.context == context;
+}
+
+/**
+ * Store cache entry for a file.
+ * The current size and modification time of the file are stored with the
+ * entry.
+ *
+ * @param filePath path to file
+ * @param entry cache entry
+ */
+void TagCache::store(const QString& filePath, const Entry& entry)
+{
+  Record record;
+  if (!getFileStatus(filePath, record.size, record.modified)) {
+    return;
+  }
+  const QByteArray data = entryToData(filePath, entry);
+
+  QMutexLocker locker(&m_mutex);
+  if (!openCacheFile()) {
+    return;
+  }
+  // Other processes append to the same file, the records they have added
+  // are read before appending at the end.
+  QLockFile lockFile(lockFilePath());
+  if (!lockFile.tryLock(LOCK_TIMEOUT_MS) || !updateIndex() ||
+      !m_file.seek(m_file.size())) {
+    return;
+  }
+  QDataStream stream(&m_file);
+  initStream(stream);
+  stream << filePath << record.size << record.modified << entry.context;
+  record.offset = m_file.pos();
+  stream << data;
+  if (stream.status() == QDataStream::Ok && m_file.flush()) {
+    record.context = entry.context;
+    m_records.insert(filePath, record);
+    m_indexEnd = m_file.pos();
+  } else {
+    // Do not leave an incomplete record for other processes.
+    m_file.resize(m_indexEnd);
+  }
+}
+
+/**
+ * Remove all entries from the cache.
+ */
+void TagCache::clear()
+{
+  QMutexLocker locker(&m_mutex);
+  m_records.clear();
+  if (openCacheFile()) {
+    QLockFile lockFile(lockFilePath());
+    if (lockFile.tryLock(LOCK_TIMEOUT_MS) && m_file.resize(HEADER_SIZE)) {
+      m_indexEnd = HEADER_SIZE;
+    }
+  }
+}
+
+/**
+ * Serialize frames for Tag::frames.
+ *
+ * @param frames frames
+ * @param maxSize maximum size of the serialized data
+ *
+ * @return serialized frames, empty if larger than @a maxSize.
+ */
+QByteArray TagCache::framesToData(const FrameCollection& frames, int maxSize)
+{
+  QByteArray data;
+  QDataStream stream(&data, QIODevice::WriteOnly);
+  initStream(stream);
+  stream << static_cast<quint32>(frames.size());
+  for (const Frame& frame : frames) {
+    stream << static_cast<qint32>(frame.getType()) << frame.getInternalName()
+           << static_cast<qint32>(frame.getIndex()) << frame.getValue();
+    const Frame::FieldList& fields = frame.getFieldList();
+    stream << static_cast<quint32>(fields.size());
+    for (const Frame::Field& field : fields) {
+      stream << static_cast<qint32>(field.m_id) << field.m_value;
+    }
+    if (data.size() > maxSize) {
+      return QByteArray();
+    }
+  }
+  return data;
+}
+
+/**
+ * Deserialize frames from Tag::frames.
+ *
+ * @param data serialized frames
+ * @param frames the frames are returned here
+ *
+ * @return true if ok.
+ */
+bool TagCache::framesFromData(const QByteArray& data, FrameCollection& frames)
+{
+  frames.clear();
+  QDataStream stream(data);
+  initStream(stream);
+  quint32 numFrames = 0;
+  stream >> numFrames;
+  for (quint32 i = 0; i < numFrames && stream.status() == QDataStream::Ok;
+       ++i) {
+    qint32 type, index;
+    QString name, value;
+    quint32 numFields = 0;
+    stream >> type >> name >> index >> value >> numFields;
+    Frame frame(Frame::ExtendedType(static_cast<Frame::Type>(type), name),
+                value, index);
+    Frame::FieldList& fields = frame.fieldList();
+    for (quint32 j = 0; j < numFields && stream.status() == QDataStream::Ok;
+         ++j) {
+      Frame::Field field;
+      qint32 id;
+      stream >> id >> field.m_value;
+      field.m_id = id;
+      fields.append(field);
+    }
+    frames.insert(frame);
+  }
+  return stream.status() == QDataStream::Ok;
+}
+
+/**
+ * Open cache file and read its index if not already done.
+ * Must be called with m_mutex locked.
+ * @return true if cache file is open.
+ */
+bool TagCache::openCacheFile()
+{
+  if (m_opened) {
+    return m_file.isOpen();
+  }
+  m_opened = true;
+
+  const QString dirPath =
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  if (dirPath.isEmpty() || !QDir().mkpath(dirPath)) {
+    return false;
+  }
+  m_file.setFileName(dirPath + QLatin1String("/tagcache.dat"));
+  QLockFile lockFile(lockFilePath());
+  if (!lockFile.tryLock(LOCK_TIMEOUT_MS) ||
+      !m_file.open(QIODevice::ReadWrite)) {
+    return false;
+  }
+
+  int numRecords = 0;
+  if (!readIndex(numRecords)) {
+    if (!initCacheFile()) {
+      m_file.close();
+      return false;
+    }
+  } else if (numRecords > 2 * m_records.size() + 1000) {
+    compact();
+  }
+  return m_file.isOpen();
+}
+
+/**
+ * Start with an empty cache file.
+ * Must be called with m_mutex and the lock file locked.
+ * @return true if ok.
+ */
+bool TagCache::initCacheFile()
+{
+  // Missing, incompatible or corrupt cache file, start with an empty cache.
+  m_records.clear();
+  m_indexEnd = 0;
+  if (!m_file.resize(0) || !m_file.seek(0)) {
+    return false;
+  }
+  QDataStream stream(&m_file);
+  initStream(stream);
+  stream << CACHE_MAGIC << CACHE_VERSION
+         << static_cast<qint32>(stream.version());
+  if (!m_file.flush()) {
+    return false;
+  }
+  m_indexEnd = m_file.pos();
+  return true;
+}
+
+/**
+ * Get path of the lock file which has to be locked while the cache file is
+ * modified, the cache file is shared by all processes.
+ * @return path of lock file.
+ */
+QString TagCache::lockFilePath() const
+{
+  return m_file.fileName() + QLatin1String(".lock");
+}
+
+/**
+ * Update the index with the records added by other processes.
+ * Must be called with m_mutex and the lock file locked.
+ * @return true if the cache file can be appended.
+ */
+bool TagCache::updateIndex()
+{
+  if (QFileInfo(m_file.fileName()).size() != m_file.size()) {
+    // The file has been replaced or removed by another process.
+    m_file.close();
+    if (!m_file.open(QIODevice::ReadWrite)) {
+      m_records.clear();
+      return false;
+    }
+    m_indexEnd = 0;
+  }
+  int numRecords = 0;
+  if (m_file.size() < m_indexEnd) {
+    // The file has been cleared by another process.
+    m_indexEnd = 0;
+  }
+  if (m_indexEnd == 0) {
+    return readIndex(numRecords) || initCacheFile();
+  }
+  return readRecords(numRecords);
+}
+
+/**
+ * Read the index of the cache file.
+ * Must be called with m_mutex and the lock file locked.
+ * @param numRecords the number of records in the file is returned here
+ * @return false if the file does not contain a compatible cache.
+ */
+bool TagCache::readIndex(int& numRecords)
+{
+  m_records.clear();
+  m_indexEnd = 0;
+  numRecords = 0;
+  if (!m_file.seek(0)) {
+    return false;
+  }
+  QDataStream stream(&m_file);
+  initStream(stream);
+  quint32 magic = 0, version = 0;
+  qint32 streamVersion = 0;
+  stream >> magic >> version >> streamVersion;
+  if (stream.status() != QDataStream::Ok || magic != CACHE_MAGIC ||
+      version != CACHE_VERSION || streamVersion != stream.version()) {
+    return false;
+  }
+  m_indexEnd = m_file.pos();
+  return readRecords(numRecords);
+}
+
+/**
+ * Add the records after the part of the cache file which has already been
+ * read to the index.
+ * Must be called with m_mutex and the lock file locked. An incomplete record
+ * at the end, e.g. from an interrupted write, is truncated.
+ * @param numRecords the number of records read is added here
+ * @return true if ok.
+ */
+bool TagCache::readRecords(int& numRecords)
+{
+  const qint64 fileSize = m_file.size();
+  if (m_indexEnd >= fileSize) {
+    return true;
+  }
+  if (!m_file.seek(m_indexEnd)) {
+    return false;
+  }
+  QDataStream stream(&m_file);
+  initStream(stream);
+  qint64 endOfLastRecord = m_indexEnd;
+  QString lastContext;
+  while (endOfLastRecord < fileSize) {
+    QString filePath;
+    Record record;
+    quint32 dataSize = 0;
+    stream >> filePath >> record.size >> record.modified >> record.context
+           >> dataSize;
+    if (stream.status() != QDataStream::Ok || dataSize == 0xffffffff) {
+      break;
+    }
+    record.offset = m_file.pos() - static_cast<qint64>(sizeof(dataSize));
+    if (stream.skipRawData(static_cast<int>(dataSize)) !=
+        static_cast<int>(dataSize)) {
+      break;
+    }
+    // Share the context strings, they are the same for most records.
+    if (record.context == lastContext) {
+      record.context = lastContext;
+    } else {
+      lastContext = record.context;
+    }
+    m_records.insert(filePath, record);
+    endOfLastRecord = m_file.pos();
+    ++numRecords;
+  }
+  m_indexEnd = endOfLastRecord;
+  if (endOfLastRecord < fileSize) {
+    m_file.resize(endOfLastRecord);
+  }
+  return true;
+}
+
+/**
+ * Rewrite cache file with only the current records.
+ * Must be called with m_mutex and the lock file locked.
+ * @return true if ok.
+ */
+bool TagCache::compact()
+{
+  QSaveFile saveFile(m_file.fileName());
+  if (!saveFile.open(QIODevice::WriteOnly)) {
+    return false;
+  }
+  QDataStream inStream(&m_file);
+  initStream(inStream);
+  QDataStream outStream(&saveFile);
+  initStream(outStream);
+  outStream << CACHE_MAGIC << CACHE_VERSION
+            << static_cast<qint32>(outStream.version());
+  QHash<QString, Record> records;
+  for (auto it = m_records.constBegin(); it != m_records.constEnd(); ++it) {
+    Record record = it.value();
+    qint64 size, modified;
+    if (!getFileStatus(it.key(), size, modified) ||
+        size != record.size || modified != record.modified ||
+        !m_file.seek(record.offset)) {
+      continue;
+    }
+    QByteArray data;
+    inStream >> data;
+    if (inStream.status() != QDataStream::Ok) {
+      return false;
+    }
+    outStream << it.key() << record.size << record.modified << record.context;
+    record.offset = saveFile.pos();
+    outStream << data;
+    records.insert(it.key(), record);
+  }
+  if (outStream.status() != QDataStream::Ok) {
+    return false;
+  }
+  m_file.close();
+  const bool ok = saveFile.commit();
+  if (ok) {
+    m_records = records;
+  }
+  if (!m_file.open(QIODevice::ReadWrite)) {
+    m_records.clear();
+    return false;
+  }
+  m_indexEnd = m_file.size();
+  return ok;
+}
+
+/**
+ * Find up-to-date record for a file.
+ * Must be called with m_mutex locked.
+ * @param filePath path to file
+ * @param record the record is returned here
+ * @return true if found.
+ */
+bool TagCache::findRecord(const QString& filePath, Record& record)
+{
+  if (!openCacheFile()) {
+    return false;
+  }
+  auto it = m_records.constFind(filePath);
+  if (it == m_records.constEnd()) {
+    return false;
+  }
+  qint64 size, modified;
+  if (!getFileStatus(filePath, size, modified) ||
+      size != it->size || modified != it->modified) {
+    return false;
+  }
+  record = *it;
+  return true;
+}
@@ -0,0 +1,217 @@
+/**
+ * \file tagcache.h
+ * Persistent cache with the tags of files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QByteArray>
+#include <QHash>
+#include <QFile>
+#include <QMutex>
+#include "taggedfile.h"
+
+/**
+ * Persistent cache with the tags and detail information of files.
+ *
+ * The entries are stored in a single file in the cache directory, new entries
+ * are appended. An entry is only valid as long as the path, size and
+ * modification time of the file are unchanged. Outdated records are removed
+ * when the cache file is opened and contains too many of them.
+ * All methods can be called from worker threads. The cache file is shared by
+ * all processes, it is only modified with a lock file locked and the entries
+ * contain the file path, which is verified when they are read.
+ */
+class KID3_CORE_EXPORT TagCache {
+public:
+  /** Cached information about a tag. */
+  struct Tag {
+    /** Constructor. */
+    Tag() : type(TaggedFile::TT_Unknown), supported(false), hasTag(false) {}
+
+    QString format;          /**< tag format, see getTagFormat() */
+    TaggedFile::TagType type; /**< tag type */
+    bool supported;          /**< true if tag is supported */
+    bool hasTag;             /**< true if tag is available */
+    /** Values of frames Frame::FT_FirstFrame to Frame::FT_LastV1Frame */
+    QStringList values;
+    /** Frames serialized with framesToData(), empty if not cached */
+    QByteArray frames;
+  };
+
+  /** Cache entry for a file. */
+  struct Entry {
+    /** Backend and settings which created the entry */
+    QString context;
+    QString fileExtension;   /**< file extension, see getFileExtension() */
+    TaggedFile::DetailInfo detailInfo; /**< technical detail information */
+    Tag tags[Frame::Tag_NumValues]; /**< information about tags */
+  };
+
+  /**
+   * Get cache instance.
+   * @return tag cache.
+   */
+  static TagCache& instance();
+
+  /**
+   * Check if the tag cache is enabled in the configuration.
+   * @return true if enabled.
+   */
+  static bool isEnabled();
+
+  /**
+   * Get cache entry for a file.
+   *
+   * @param filePath path to file
+   * @param context backend and settings which have to match the entry
+   * @param entry the cache entry is returned here
+   *
+   * @return true if an up-to-date entry was found.
+   */
+  bool lookup(const QString& filePath, const QString& context, Entry& entry);
+
+  /**
+   * Check if an up-to-date entry exists for a file.
+   *
+   * @param filePath path to file
+   * @param context backend and settings which have to match the entry
+   *
+   * @return true if the file does not have to be stored again.
+   */
+  bool contains(const QString& filePath, const QString& context);
+
+  /**
+   * Store cache entry for a file.
+   * The current size and modification time of the file are stored with the
+   * entry.
+   *
+   * @param filePath path to file
+   * @param entry cache entry
+   */
+  void store(const QString& filePath, const Entry& entry);
+
+  /**
+   * Remove all entries from the cache.
+   */
+  void clear();
+
+  /**
+   * Serialize frames for Tag::frames.
+   *
+   * @param frames frames
+   * @param maxSize maximum size of the serialized data
+   *
+   * @return serialized frames, empty if larger than @a maxSize.
+   */
+  static QByteArray framesToData(const FrameCollection& frames, int maxSize);
+
+  /**
+   * Deserialize frames from Tag::frames.
+   *
+   * @param data serialized frames
+   * @param frames the frames are returned here
+   *
+   * @return true if ok.
+   */
+  static bool framesFromData(const QByteArray& data, FrameCollection& frames);
+
+private:
+  /** Location of a record in the cache file. */
+  struct Record {
+    qint64 size;     /**< size of file */
+    qint64 modified; /**< modification time of file in ms since epoch */
+    qint64 offset;   /**< position of entry data in cache file */
+    QString context; /**< context of entry */
+  };
+
+  TagCache() = default;
+  ~TagCache() = default;
+  TagCache(const TagCache&) = delete;
+  TagCache& operator=(const TagCache&) = delete;
+
+  /**
+   * Open cache file and read its index if not already done.
+   * @return true if cache file is open.
+   */
+  bool openCacheFile();
+
+  /**
+   * Start with an empty cache file.
+   * @return true if ok.
+   */
+  bool initCacheFile();
+
+  /**
+   * Get path of the lock file which has to be locked while the cache file is
+   * modified.
+   * @return path of lock file.
+   */
+  QString lockFilePath() const;
+
+  /**
+   * Update the index with the records added by other processes.
+   * @return true if the cache file can be appended.
+   */
+  bool updateIndex();
+
+  /**
+   * Read the index of the cache file.
+   * @param numRecords the number of records in the file is returned here
+   * @return false if the file does not contain a compatible cache.
+   */
+  bool readIndex(int& numRecords);
+
+  /**
+   * Add the records after the part of the cache file which has already been
+   * read to the index.
+   * @param numRecords the number of records read is added here
+   * @return true if ok.
+   */
+  bool readRecords(int& numRecords);
+
+  /**
+   * Rewrite cache file with only the current records.
+   * @return true if ok.
+   */
+  bool compact();
+
+  /**
+   * Find up-to-date record for a file.
+   * @param filePath path to file
+   * @param record the record is returned here
+   * @return true if found.
+   */
+  bool findRecord(const QString& filePath, Record& record);
+
+  QMutex m_mutex;
+  QFile m_file;
+  /** Records by file path */
+  QHash<QString, Record> m_records;
+  /** End of the part of the cache file which has been read into m_records */
+  qint64 m_indexEnd = 0;
+  bool m_opened = false;
+};
@@ -42,16 +42,36 @@
 #include "saferename.h"
 #include "taggedfilesystemmodel.h"
 
+QAtomicInt TaggedFile::s_cachedFramesGeneration(1);
+TaggedFile* TaggedFile::s_cachedFramesFirst = nullptr;
+TaggedFile* TaggedFile::s_cachedFramesLast = nullptr;
+int TaggedFile::s_numCachedFrames = 0;
+QMutex TaggedFile::s_cachedFramesMutex;
+
+namespace {
+
+/**
+ * Maximum number of files for which the frames are kept by
+ * getAllFramesCached(), enough for the selected files and the files
+ * processed by a search or filter.
+ */
+constexpr int MAX_FILES_WITH_CACHED_FRAMES = 64;
+
+}
+
 /**
  * Constructor.
  *
  * @param idx index in tagged file system model
  */
 TaggedFile::TaggedFile(const QPersistentModelIndex& idx)
-  : m_index(idx), m_truncation(0), m_modified(false), m_marked(false)
+  : m_index(idx), m_truncation(0), m_cachedFramesPrev(nullptr),
+    m_cachedFramesNext(nullptr), m_cachedFramesLinked(false),
+    m_modified(false), m_marked(false)
 {
   FOR_ALL_TAGS(tagNr) {
     m_changedFrames[tagNr] = 0;
+    m_cachedFramesGeneration[tagNr] = 0;
     m_changed[tagNr] = false;
   }
   Q_ASSERT(m_index.model()->metaObject() == &TaggedFileSystemModel::staticMetaObject);
@@ -61,6 +81,15 @@ TaggedFile::TaggedFile(const QPersistentModelIndex& idx)
   }
 }
 
+/**
+ * Destructor.
+ */
+TaggedFile::~TaggedFile()
+{
+  QMutexLocker locker(&s_cachedFramesMutex);
+  unlinkCachedFrames();
+}
+
 /**
  * Get tagged file model.
  * @return tagged file model.
@@ -132,6 +161,9 @@ void TaggedFile::updateCurrentFilename()
  */
 QString TaggedFile::currentFilePath() const
 {
+  if (!m_workerFilePath.isNull()) {
+    return m_workerFilePath;
+  }
   if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
     return model->filePath(m_index);
   }
@@ -270,6 +302,9 @@ void TaggedFile::markTagChanged(Frame::TagNumber tagNr,
 {
   Frame::Type type = extendedType.getType();
   m_changed[tagNr] = true;
+  // The frames are freed when the file leaves the LRU list, they are not
+  // accessed here because this can be called from a worker thread.
+  m_cachedFramesGeneration[tagNr] = 0;
   if (static_cast<unsigned>(type) < sizeof(m_changedFrames[tagNr]) * 8) {
     m_changedFrames[tagNr] |= 1ULL << type;
   }
@@ -288,6 +323,7 @@ void TaggedFile::markTagChanged(Frame::TagNumber tagNr,
  */
 void TaggedFile::markTagUnchanged(Frame::TagNumber tagNr) {
   m_changed[tagNr] = false;
+  m_cachedFramesGeneration[tagNr] = 0;
   m_changedFrames[tagNr] = 0;
   m_changedOtherFrameNames[tagNr].clear();
   clearTrunctionFlags(tagNr);
@@ -366,7 +402,8 @@ void TaggedFile::updateModifiedState()
   modified = modified || m_newFilename != m_filename;
   if (m_modified != modified) {
     m_modified = modified;
-    if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
+    if (const TaggedFileSystemModel* model = m_workerFilePath.isNull()
+        ? getTaggedFileSystemModel() : nullptr) {
       const_cast<TaggedFileSystemModel*>(model)->notifyModificationChanged(
             m_index, m_modified);
     }
@@ -385,7 +422,8 @@ void TaggedFile::updateModifiedState()
  */
 void TaggedFile::notifyModelDataChanged(bool priorIsTagInformationRead) const
 {
-  if (isTagInformationRead() != priorIsTagInformationRead) {
+  if (isTagInformationRead() != priorIsTagInformationRead &&
+      m_workerFilePath.isNull()) {
     if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
       const_cast<TaggedFileSystemModel*>(model)->notifyModelDataChanged(m_index);
     }
@@ -402,7 +440,7 @@ void TaggedFile::notifyModelDataChanged(bool priorIsTagInformationRead) const
 void TaggedFile::notifyTruncationChanged(bool priorTruncation) const
 {
   if (bool currentTruncation = m_truncation != 0;
-      currentTruncation != priorTruncation) {
+      currentTruncation != priorTruncation && m_workerFilePath.isNull()) {
     if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
       const_cast<TaggedFileSystemModel*>(model)->notifyModelDataChanged(m_index);
     }
@@ -1058,6 +1096,117 @@ void TaggedFile::getAllFrames(Frame::TagNumber tagNr, FrameCollection& frames)
   }
 }
 
+/**
+ * Get all frames in tag without converting them again on each call.
+ * The frames returned by getAllFrames() are kept until the tag is changed,
+ * read again or cleared, or invalidateAllCachedFrames() is called.
+ *
+ * @param tagNr tag number
+ *
+ * @return frames of tag, the reference is only valid until the tag is
+ * changed or the tagged file is deleted, so a copy has to be made if the
+ * tag is modified while the frames are used.
+ */
+const FrameCollection& TaggedFile::getAllFramesCached(Frame::TagNumber tagNr)
+{
+  const int generation = s_cachedFramesGeneration.loadAcquire();
+  QMutexLocker locker(&s_cachedFramesMutex);
+  if (!m_cachedFramesLinked || m_cachedFramesGeneration[tagNr] != generation) {
+    // getAllFrames() may read the file and thereby mark the tag unchanged,
+    // so the generation is only stored afterwards.
+    locker.unlock();
+    FrameCollection frames;
+    getAllFrames(tagNr, frames);
+    locker.relock();
+    if (!m_cachedFramesLinked) {
+      // Frames of other tags are no longer valid after being evicted.
+      FOR_ALL_TAGS(tn) {
+        m_cachedFramesGeneration[tn] = 0;
+      }
+    }
+    m_cachedFrames[tagNr].swap(frames);
+    m_cachedFramesGeneration[tagNr] = generation;
+  }
+
+  // Move to the front of the LRU list and evict the least recently used
+  // files, this file is never evicted because at least one file is kept.
+  unlinkCachedFrames();
+  m_cachedFramesPrev = nullptr;
+  m_cachedFramesNext = s_cachedFramesFirst;
+  if (s_cachedFramesFirst) {
+    s_cachedFramesFirst->m_cachedFramesPrev = this;
+  } else {
+    s_cachedFramesLast = this;
+  }
+  s_cachedFramesFirst = this;
+  m_cachedFramesLinked = true;
+  ++s_numCachedFrames;
+  const int maxFiles = TagConfig::instance().tagSnapshotsEnabled()
+      ? 1 : MAX_FILES_WITH_CACHED_FRAMES;
+  while (s_numCachedFrames > maxFiles && s_cachedFramesLast) {
+    TaggedFile* evicted = s_cachedFramesLast;
+    evicted->unlinkCachedFrames();
+    FOR_ALL_TAGS(tn) {
+      evicted->m_cachedFrames[tn].clear();
+    }
+  }
+  return m_cachedFrames[tagNr];
+}
+
+/**
+ * Remove file from LRU list of files with cached frames.
+ * Must be called with s_cachedFramesMutex locked.
+ */
+void TaggedFile::unlinkCachedFrames()
+{
+  if (!m_cachedFramesLinked) {
+    return;
+  }
+  if (m_cachedFramesPrev) {
+    m_cachedFramesPrev->m_cachedFramesNext = m_cachedFramesNext;
+  } else {
+    s_cachedFramesFirst = m_cachedFramesNext;
+  }
+  if (m_cachedFramesNext) {
+    m_cachedFramesNext->m_cachedFramesPrev = m_cachedFramesPrev;
+  } else {
+    s_cachedFramesLast = m_cachedFramesPrev;
+  }
+  m_cachedFramesPrev = nullptr;
+  m_cachedFramesNext = nullptr;
+  m_cachedFramesLinked = false;
+  --s_numCachedFrames;
+}
+
+/**
+ * Invalidate the frames cached by getAllFramesCached() of all tagged files.
+ * This method shall be called when the configuration affecting the
+ * frames returned by getAllFrames() changes.
+ */
+void TaggedFile::invalidateAllCachedFrames()
+{
+  // 0 is used for frames which are not cached.
+  if (!s_cachedFramesGeneration.ref()) {
+    s_cachedFramesGeneration.ref();
+  }
+}
+
+/**
+ * Free the frames cached by getAllFramesCached().
+ * Tags which are marked as changed or unchanged are invalidated
+ * automatically, this method has to be called when tags are freed without
+ * changing their state.
+ */
+void TaggedFile::clearCachedFrames()
+{
+  QMutexLocker locker(&s_cachedFramesMutex);
+  unlinkCachedFrames();
+  FOR_ALL_TAGS(tagNr) {
+    m_cachedFramesGeneration[tagNr] = 0;
+    m_cachedFrames[tagNr].clear();
+  }
+}
+
 /**
  * Update marked property of frames.
  * Mark frames which violate configured rules. This method should be called
@@ -1107,6 +1256,100 @@ void TaggedFile::closeFileHandle()
 {
 }
 
+/**
+ * Check if readTags() can be called from a worker thread.
+ * This is the case if the implementation only uses the state of this
+ * object and reentrant library functions, so that different tagged files
+ * can be read concurrently. The default implementation returns false.
+ *
+ * @return true if tags can be read in a worker thread.
+ */
+bool TaggedFile::isReadTagsReentrant() const
+{
+  return false;
+}
+
+/**
+ * Read tags from the persistent tag cache without accessing the file.
+ * If successful, the information about the tags is available as if
+ * readTags() had been called, the file is only read when the tags are
+ * modified or their frames are not cached. The default implementation
+ * does not support a cache and returns false.
+ *
+ * @return true if the tags were read from the cache.
+ * @see TagCache
+ */
+bool TaggedFile::readTagsFromCache()
+{
+  return false;
+}
+
+/**
+ * Read tags from file in a worker thread.
+ * The model may only be accessed from its own thread, therefore the file
+ * path has to be supplied and notifications to the model are suppressed.
+ * This method may only be called if isReadTagsReentrant() is true and
+ * the tagged file is not accessed from another thread at the same time.
+ *
+ * @param filePath absolute path to file as returned by the model
+ */
+void TaggedFile::readTagsInWorkerThread(const QString& filePath)
+{
+  m_workerFilePath = filePath;
+  readTags(false);
+  closeFileHandle();
+  m_workerFilePath.clear();
+}
+
+/**
+ * Check if writeTags() can be called from a worker thread for a file which
+ * is not renamed. The default implementation returns false.
+ *
+ * @return true if tags can be written in a worker thread.
+ */
+bool TaggedFile::isWriteTagsReentrant() const
+{
+  return false;
+}
+
+/**
+ * Write tags to file in a worker thread.
+ * The model may only be accessed from its own thread, therefore the file
+ * path has to be supplied and notifications to the model are suppressed.
+ * notifyModelAfterWorkerThread() has to be called afterwards from the
+ * thread of the model. This method may only be called if
+ * isWriteTagsReentrant() is true, the file name is not changed and the
+ * tagged file is not accessed from another thread at the same time.
+ *
+ * @param filePath absolute path to file as returned by the model
+ * @param preserve true to preserve file time stamps
+ *
+ * @return true if ok, false if the file could not be written.
+ */
+bool TaggedFile::writeTagsInWorkerThread(const QString& filePath,
+                                         bool preserve)
+{
+  m_workerFilePath = filePath;
+  bool renamed = false;
+  bool ok = writeTags(false, &renamed, preserve);
+  closeFileHandle();
+  m_workerFilePath.clear();
+  return ok;
+}
+
+/**
+ * Notify the model about changes done in a worker thread by
+ * writeTagsInWorkerThread(). Must be called from the thread of the model.
+ */
+void TaggedFile::notifyModelAfterWorkerThread()
+{
+  if (const TaggedFileSystemModel* model = getTaggedFileSystemModel()) {
+    auto fsModel = const_cast<TaggedFileSystemModel*>(model);
+    fsModel->notifyModificationChanged(m_index, m_modified);
+    fsModel->notifyModelDataChanged(m_index);
+  }
+}
+
 /**
  * Add a suitable field list for the frame if missing.
  * If a frame is created, its field list is empty. This method will create
@@ -1147,7 +1390,8 @@ void TaggedFile::setFrames(Frame::TagNumber tagNr,
           // The frame does not have an index
           // The frame has to be looked up and modified
           if (!myFramesValid) {
-            getAllFrames(tagNr, myFrames);
+            // A copy is needed because setFrame() invalidates the cache.
+            myFrames = getAllFramesCached(tagNr);
             myFramesValid = true;
           }
           auto myIt = myFrames.find(*it);
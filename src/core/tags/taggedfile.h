@@ -31,6 +31,8 @@
 #include <QList>
 #include <QSet>
 #include <QPersistentModelIndex>
+#include <QAtomicInt>
+#include <QMutex>
 #include "frame.h"
 
 class TaggedFileSystemModel;
@@ -98,7 +100,7 @@ public:
   /**
    * Destructor.
    */
-  virtual ~TaggedFile() = default;
+  virtual ~TaggedFile();
 
   /**
    * Set file name.
@@ -167,6 +169,69 @@ public:
    */
   virtual void readTags(bool force) = 0;
 
+  /**
+   * Check if readTags() can be called from a worker thread.
+   * This is the case if the implementation only uses the state of this
+   * object and reentrant library functions, so that different tagged files
+   * can be read concurrently. The default implementation returns false.
+   *
+   * @return true if tags can be read in a worker thread.
+   */
+  virtual bool isReadTagsReentrant() const;
+
+  /**
+   * Read tags from the persistent tag cache without accessing the file.
+   * If successful, the information about the tags is available as if
+   * readTags() had been called, the file is only read when the tags are
+   * modified or their frames are not cached. The default implementation
+   * does not support a cache and returns false.
+   *
+   * @return true if the tags were read from the cache.
+   * @see TagCache
+   */
+  virtual bool readTagsFromCache();
+
+  /**
+   * Read tags from file in a worker thread.
+   * The model may only be accessed from its own thread, therefore the file
+   * path has to be supplied and notifications to the model are suppressed.
+   * This method may only be called if isReadTagsReentrant() is true and
+   * the tagged file is not accessed from another thread at the same time.
+   *
+   * @param filePath absolute path to file as returned by the model
+   */
+  void readTagsInWorkerThread(const QString& filePath);
+
+  /**
+   * Check if writeTags() can be called from a worker thread for a file which
+   * is not renamed. The default implementation returns false.
+   *
+   * @return true if tags can be written in a worker thread.
+   */
+  virtual bool isWriteTagsReentrant() const;
+
+  /**
+   * Write tags to file in a worker thread.
+   * The model may only be accessed from its own thread, therefore the file
+   * path has to be supplied and notifications to the model are suppressed.
+   * notifyModelAfterWorkerThread() has to be called afterwards from the
+   * thread of the model. This method may only be called if
+   * isWriteTagsReentrant() is true, the file name is not changed and the
+   * tagged file is not accessed from another thread at the same time.
+   *
+   * @param filePath absolute path to file as returned by the model
+   * @param preserve true to preserve file time stamps
+   *
+   * @return true if ok, false if the file could not be written.
+   */
+  bool writeTagsInWorkerThread(const QString& filePath, bool preserve);
+
+  /**
+   * Notify the model about changes done in a worker thread by
+   * writeTagsInWorkerThread(). Must be called from the thread of the model.
+   */
+  void notifyModelAfterWorkerThread();
+
   /**
    * Write tags to file and rename it if necessary.
    *
@@ -309,6 +374,30 @@ public:
    */
   virtual void getAllFrames(Frame::TagNumber tagNr, FrameCollection& frames);
 
+  /**
+   * Get all frames in tag without converting them again on each call.
+   * The frames returned by getAllFrames() are kept until the tag is changed,
+   * read again or cleared, or invalidateAllCachedFrames() is called.
+   * Only the frames of the most recently used files are kept, if tag
+   * snapshots are enabled only those of the last file.
+   * Must be called from the thread of the model.
+   *
+   * @param tagNr tag number
+   *
+   * @return frames of tag, the reference is only valid until the tag is
+   * changed, the tagged file is deleted or the frames of another file are
+   * fetched, so a copy has to be made if the tag is modified while the
+   * frames are used.
+   */
+  const FrameCollection& getAllFramesCached(Frame::TagNumber tagNr);
+
+  /**
+   * Invalidate the frames cached by getAllFramesCached() of all tagged files.
+   * This method shall be called when the configuration affecting the
+   * frames returned by getAllFrames() changes.
+   */
+  static void invalidateAllCachedFrames();
+
   /**
    * Close any file handles which are held open by the tagged file object.
    * The default implementation does nothing. If a concrete subclass holds
@@ -538,6 +627,14 @@ public:
   static void staticCleanup();
 
 protected:
+  /**
+   * Free the frames cached by getAllFramesCached().
+   * Tags which are marked as changed or unchanged are invalidated
+   * automatically, this method has to be called when tags are freed without
+   * changing their state.
+   */
+  void clearCachedFrames();
+
   /**
    * Rename a file.
    * This methods takes care of case insensitive filesystems.
@@ -667,6 +764,12 @@ private:
 
   void updateModifiedState();
 
+  /**
+   * Remove file from LRU list of files with cached frames.
+   * Must be called with s_cachedFramesMutex locked.
+   */
+  void unlinkCachedFrames();
+
   /** Index of file in model */
   QPersistentModelIndex m_index;
   /** File name */
@@ -675,16 +778,42 @@ private:
   QString m_newFilename;
   /** File name reverted because file was not writable */
   QString m_revertedFilename;
+  /** File path used while reading in a worker thread, else null */
+  QString m_workerFilePath;
   /** The names of changed tag frames of type Frame::FT_Other */
   QSet<QString> m_changedOtherFrameNames[Frame::Tag_NumValues];
   /** changed tag frame types */
   quint64 m_changedFrames[Frame::Tag_NumValues];
   /** Truncation flags. */
   quint64 m_truncation;
+  /** Frames cached by getAllFramesCached() */
+  FrameCollection m_cachedFrames[Frame::Tag_NumValues];
+  /** Value of s_cachedFramesGeneration when frames were cached, 0 if not */
+  int m_cachedFramesGeneration[Frame::Tag_NumValues];
+  /** previous (more recently used) file in LRU list of cached frames */
+  TaggedFile* m_cachedFramesPrev;
+  /** next (less recently used) file in LRU list of cached frames */
+  TaggedFile* m_cachedFramesNext;
+  /** true if file is in LRU list of cached frames */
+  bool m_cachedFramesLinked;
   /** true if tags were changed */
   bool m_changed[Frame::Tag_NumValues];
   /** true if tagged file is modified */
   bool m_modified;
   /** true if tagged file is marked */
   bool m_marked;
+
+  /** Incremented by invalidateAllCachedFrames(), never 0 */
+  static QAtomicInt s_cachedFramesGeneration;
+  /** most recently used file with cached frames */
+  static TaggedFile* s_cachedFramesFirst;
+  /** least recently used file with cached frames */
+  static TaggedFile* s_cachedFramesLast;
+  /** number of files in LRU list of cached frames */
+  static int s_numCachedFrames;
+  /**
+   * protects LRU list of cached frames, the tags of files can be changed
+   * in worker threads while other files are accessed
+   */
+  static QMutex s_cachedFramesMutex;
 };
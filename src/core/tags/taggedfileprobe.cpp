@@ -0,0 +1,157 @@
+/**
+ * \file taggedfileprobe.cpp
+ * Detection of file contents which need a specific tagged file feature.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "taggedfileprobe.h"
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include "taggedfile.h"
+
+namespace {
+
+/**
+ * Number of bytes read from the start of a file, enough for an ID3v2 header
+ * and the first packet of an Ogg page with a full segment table.
+ */
+constexpr int HEADER_SIZE = 512;
+/** Maximum number of stored results, all are removed when exceeded. */
+constexpr int MAX_ENTRIES = 100000;
+
+}
+
+/**
+ * Get probe instance.
+ * @return tagged file probe.
+ */
+TaggedFileProbe& TaggedFileProbe::instance()
+{
+  static TaggedFileProbe probe;
+  return probe;
+}
+
+/**
+ * Get the feature needed to read a file.
+ *
+ * @param filePath path to file
+ *
+ * @return TaggedFile::TF_ID3v24, TaggedFile::TF_OggFlac or 0 if no special
+ * feature is needed or the file cannot be read.
+ */
+int TaggedFileProbe::requiredFeature(const QString& filePath)
+{
+  QFileInfo fi(filePath);
+  const qint64 size = fi.size();
+  const qint64 modified = fi.lastModified().toMSecsSinceEpoch();
+  {
+    QMutexLocker locker(&m_mutex);
+    if (auto it = m_entries.constFind(filePath);
+        it != m_entries.constEnd() &&
+        it->size == size && it->modified == modified) {
+      return it->feature;
+    }
+  }
+
+  QFile file(filePath);
+  if (!file.open(QIODevice::ReadOnly)) {
+    return 0;
+  }
+  const int feature = featureFromHeader(file.read(HEADER_SIZE));
+  file.close();
+
+  QMutexLocker locker(&m_mutex);
+  if (m_entries.size() >= MAX_ENTRIES) {
+    m_entries.clear();
+  }
+  m_entries.insert(filePath, {size, modified, feature});
+  return feature;
+}
+
+/**
+ * Get the feature needed to read a file which is not supported by its
+ * tagged file. Only tagged files without TaggedFile::TF_ID3v24 or
+ * TaggedFile::TF_OggFlac are probed.
+ *
+ * @param taggedFile tagged file
+ * @param filePath absolute path to file
+ *
+ * @return TaggedFile::TF_ID3v24, TaggedFile::TF_OggFlac or 0 if the
+ * tagged file can be used.
+ */
+int TaggedFileProbe::missingFeature(const TaggedFile* taggedFile,
+                                    const QString& filePath)
+{
+  // Only files which would otherwise be read again by
+  // FileProxyModel::readWithId3V24IfId3V24() or
+  // FileProxyModel::readWithOggFlacIfInvalidOgg() have to be probed.
+  const int features = taggedFile->taggedFileFeatures();
+  int missingFeatures = 0;
+  if ((features & (TaggedFile::TF_ID3v23 | TaggedFile::TF_ID3v24)) ==
+      TaggedFile::TF_ID3v23) {
+    missingFeatures |= TaggedFile::TF_ID3v24;
+  }
+  if ((features & (TaggedFile::TF_OggPictures | TaggedFile::TF_OggFlac)) ==
+      TaggedFile::TF_OggPictures) {
+    missingFeatures |= TaggedFile::TF_OggFlac;
+  }
+  return missingFeatures != 0
+      ? requiredFeature(filePath) & missingFeatures : 0;
+}
+
+/**
+ * Remove all stored results.
+ */
+void TaggedFileProbe::clear()
+{
+  QMutexLocker locker(&m_mutex);
+  m_entries.clear();
+}
+
+/**
+ * Detect the feature needed to read a file from its first bytes.
+ *
+ * @param header first bytes of the file
+ *
+ * @return TaggedFile::TF_ID3v24, TaggedFile::TF_OggFlac or 0.
+ */
+int TaggedFileProbe::featureFromHeader(const QByteArray& header)
+{
+  if (header.size() >= 10 && header.startsWith("ID3")) {
+    // ID3v2.2 tags are also read with ID3v2.4 because id3lib corrupts
+    // images in ID3v2.2 tags, unknown versions are left to TagLib too.
+    const auto majorVersion = static_cast<uchar>(header.at(3));
+    return majorVersion == 3 ? 0 : TaggedFile::TF_ID3v24;
+  }
+  if (header.size() >= 27 && header.startsWith("OggS")) {
+    // The first packet of the first page identifies the codec, its start
+    // follows the segment table of the page.
+    const int numSegments = static_cast<uchar>(header.at(26));
+    const QByteArray packet = header.mid(27 + numSegments, 5);
+    if (packet == QByteArray("\x7f" "FLAC") || packet.startsWith("fLaC")) {
+      return TaggedFile::TF_OggFlac;
+    }
+  }
+  return 0;
+}
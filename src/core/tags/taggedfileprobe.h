@@ -0,0 +1,110 @@
+/**
+ * \file taggedfileprobe.h
+ * Detection of file contents which need a specific tagged file feature.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QByteArray>
+#include <QHash>
+#include <QMutex>
+#include "kid3api.h"
+
+class TaggedFile;
+
+/**
+ * Probe for the header of a file to find the tagged file feature which is
+ * needed to read it.
+ *
+ * Only the first bytes of the file are read. Files with an ID3v2.4 or ID3v2.2
+ * tag need TaggedFile::TF_ID3v24, Ogg files containing a FLAC stream need
+ * TaggedFile::TF_OggFlac. This allows to select the right plugin before the
+ * file is parsed instead of reading it again with another plugin.
+ * The probe is done when the tags are read for the first time, in the
+ * prefetch worker thread or in FileProxyModel::readTagsFromTaggedFile().
+ * The results are kept as long as the size and modification time of the
+ * files are unchanged. All methods can be called from worker threads.
+ */
+class KID3_CORE_EXPORT TaggedFileProbe {
+public:
+  /**
+   * Get probe instance.
+   * @return tagged file probe.
+   */
+  static TaggedFileProbe& instance();
+
+  /**
+   * Get the feature needed to read a file.
+   *
+   * @param filePath path to file
+   *
+   * @return TaggedFile::TF_ID3v24, TaggedFile::TF_OggFlac or 0 if no special
+   * feature is needed or the file cannot be read.
+   */
+  int requiredFeature(const QString& filePath);
+
+  /**
+   * Get the feature needed to read a file which is not supported by its
+   * tagged file. Only tagged files without TaggedFile::TF_ID3v24 or
+   * TaggedFile::TF_OggFlac are probed.
+   *
+   * @param taggedFile tagged file
+   * @param filePath absolute path to file
+   *
+   * @return TaggedFile::TF_ID3v24, TaggedFile::TF_OggFlac or 0 if the
+   * tagged file can be used.
+   */
+  int missingFeature(const TaggedFile* taggedFile, const QString& filePath);
+
+  /**
+   * Remove all stored results.
+   */
+  void clear();
+
+  /**
+   * Detect the feature needed to read a file from its first bytes.
+   *
+   * @param header first bytes of the file
+   *
+   * @return TaggedFile::TF_ID3v24, TaggedFile::TF_OggFlac or 0.
+   */
+  static int featureFromHeader(const QByteArray& header);
+
+private:
+  /** Stored probe result. */
+  struct Entry {
+    qint64 size;      /**< size of file */
+    qint64 modified;  /**< modification time of file in ms since epoch */
+    int feature;      /**< result of featureFromHeader() */
+  };
+
+  TaggedFileProbe() = default;
+  ~TaggedFileProbe() = default;
+  TaggedFileProbe(const TaggedFileProbe&) = delete;
+  TaggedFileProbe& operator=(const TaggedFileProbe&) = delete;
+
+  QHash<QString, Entry> m_entries;
+  QMutex m_mutex;
+};
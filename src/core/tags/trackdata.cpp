@@ -32,6 +32,38 @@
 #include <QCoreApplication>
 #include "fileproxymodel.h"
 
+namespace {
+
+/** Short and long format codes for information about the file. */
+const struct {
+  const char* longCode;
+  char shortCode;
+} fileInfoShortToLong[] = {
+  { "file", 'f' },
+  { "filepath", 'p' },
+  { "url", 'u' },
+  { "duration", 'd' },
+  { "seconds", 'D' },
+  { "tracks", 'n' },
+  { "extension", 'e' },
+  { "tag1", 'O' },
+  { "tag2", 'o' },
+  { "bitrate", 'b' },
+  { "vbr", 'v' },
+  { "samplerate", 'r' },
+  { "mode", 'm' },
+  { "channels", 'C' },
+  { "codec", 'k' },
+  { "marked", 'w' }
+};
+
+/** Long format codes for information about the file without short code. */
+const char* const fileInfoLongCodes[] = {
+  "modificationdate", "creationdate", "dirname", "tag3"
+};
+
+}
+
 /**
  * Constructor.
  *
@@ -42,6 +74,18 @@ TrackDataFormatReplacer::TrackDataFormatReplacer(
   const TrackData& trackData, const QString& str)
   : FrameFormatReplacer(trackData, str), m_trackData(trackData) {}
 
+/**
+ * Constructor using frames which are not stored in the track data.
+ *
+ * @param trackData track data providing the file information
+ * @param frames    frames used instead of those of @a trackData
+ * @param str       string with format codes
+ */
+TrackDataFormatReplacer::TrackDataFormatReplacer(
+  const TrackData& trackData, const FrameCollection& frames,
+  const QString& str)
+  : FrameFormatReplacer(frames, str), m_trackData(trackData) {}
+
 /**
  * Replace a format code (one character %c or multiple characters %{chars}).
  * Supported format fields:
@@ -65,29 +109,8 @@ QString TrackDataFormatReplacer::getReplacement(const QString& code) const
     QString name;
 
     if (code.length() == 1) {
-      static const struct {
-        const char* longCode;
-        char shortCode;
-      } shortToLong[] = {
-        { "file", 'f' },
-        { "filepath", 'p' },
-        { "url", 'u' },
-        { "duration", 'd' },
-        { "seconds", 'D' },
-        { "tracks", 'n' },
-        { "extension", 'e' },
-        { "tag1", 'O' },
-        { "tag2", 'o' },
-        { "bitrate", 'b' },
-        { "vbr", 'v' },
-        { "samplerate", 'r' },
-        { "mode", 'm' },
-        { "channels", 'C' },
-        { "codec", 'k' },
-        { "marked", 'w' }
-      };
       const char c = code[0].toLatin1();
-      for (const auto& [longCode, shortCode] : shortToLong) {
+      for (const auto& [longCode, shortCode] : fileInfoShortToLong) {
         if (shortCode == c) {
           name = QString::fromLatin1(longCode);
           break;
@@ -181,6 +204,45 @@ QString TrackDataFormatReplacer::getReplacement(const QString& code) const
   return result;
 }
 
+/**
+ * Check if a format code is replaced with information about the file.
+ * The replacement of such a code does not depend on the frames of the
+ * track data, as long as there is no frame with the same name.
+ * The marked state (%w) is not such a code, it is only up to date after
+ * the frames have been fetched.
+ *
+ * @param code format code as passed to getReplacement()
+ *
+ * @return true if @a code is a code for file information.
+ */
+bool TrackDataFormatReplacer::isFileInfoCode(const QString& code)
+{
+  // See TaggedFile::updateMarkedState().
+  if (code == QLatin1String("w") || code == QLatin1String("marked")) {
+    return false;
+  }
+  if (code.length() == 1) {
+    const char c = code[0].toLatin1();
+    for (const auto& [longCode, shortCode] : fileInfoShortToLong) {
+      if (shortCode == c) {
+        return true;
+      }
+    }
+    return false;
+  }
+  for (const auto& [longCode, shortCode] : fileInfoShortToLong) {
+    if (code == QLatin1String(longCode)) {
+      return true;
+    }
+  }
+  for (auto longCode : fileInfoLongCodes) {
+    if (code == QLatin1String(longCode)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 /**
  * Get help text for supported format codes.
  *
@@ -316,11 +378,9 @@ TrackData::TrackData(TaggedFile& taggedFile, Frame::TagVersion tagVersion)
 {
   for (Frame::TagNumber tagNr : Frame::tagNumbersFromMask(tagVersion)) {
     if (empty()) {
-      taggedFile.getAllFrames(tagNr, *this);
+      setFrameCollection(taggedFile.getAllFramesCached(tagNr));
     } else {
-      FrameCollection frames;
-      taggedFile.getAllFrames(tagNr, frames);
-      merge(frames);
+      merge(taggedFile.getAllFramesCached(tagNr));
     }
   }
 }
@@ -628,10 +688,8 @@ QString ImportTrackDataVector::getFrame(Frame::Type type) const
     if (!result.isEmpty())
       return result;
     TaggedFile* taggedFile = trackData.getTaggedFile();
-    FrameCollection frames;
     for (Frame::TagNumber tagNr : Frame::allTagNumbers()) {
-      taggedFile->getAllFrames(tagNr, frames);
-      result = frames.getValue(type);
+      result = taggedFile->getAllFramesCached(tagNr).getValue(type);
       if (!result.isEmpty())
         return result;
     }
@@ -652,11 +710,9 @@ void ImportTrackDataVector::readTags(Frame::TagVersion tagVersion)
       it->clear();
       for (Frame::TagNumber tagNr : Frame::tagNumbersFromMask(tagVersion)) {
         if (it->empty()) {
-          taggedFile->getAllFrames(tagNr, *it);
+          it->setFrameCollection(taggedFile->getAllFramesCached(tagNr));
         } else {
-          FrameCollection frames;
-          taggedFile->getAllFrames(tagNr, frames);
-          it->merge(frames);
+          it->merge(taggedFile->getAllFramesCached(tagNr));
         }
       }
     }
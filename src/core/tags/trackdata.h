@@ -330,6 +330,17 @@ public:
     const TrackData& trackData,
     const QString& str = QString());
 
+  /**
+   * Constructor using frames which are not stored in the track data.
+   *
+   * @param trackData track data providing the file information
+   * @param frames    frames used instead of those of @a trackData
+   * @param str       string with format codes
+   */
+  TrackDataFormatReplacer(
+    const TrackData& trackData, const FrameCollection& frames,
+    const QString& str = QString());
+
   /**
    * Destructor.
    */
@@ -348,6 +359,19 @@ public:
    */
   static QString getToolTip(bool onlyRows = false);
 
+  /**
+   * Check if a format code is replaced with information about the file.
+   * The replacement of such a code does not depend on the frames of the
+   * track data, as long as there is no frame with the same name.
+   * The marked state (%w) is not such a code, it is only up to date after
+   * the frames have been fetched.
+   *
+   * @param code format code as passed to getReplacement()
+   *
+   * @return true if @a code is a code for file information.
+   */
+  static bool isFileInfoCode(const QString& code);
+
 protected:
   /**
    * Replace a format code (one character %c or multiple characters %{chars}).
@@ -0,0 +1,237 @@
+/**
+ * \file performancestatistics.cpp
+ * Timing counters for frequently executed operations.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "performancestatistics.h"
+#include <iterator>
+#include <QMap>
+#include <QMutex>
+
+namespace {
+
+/**
+ * Number of histogram buckets. Bucket i contains the durations below
+ * 2^i microseconds, the last bucket all longer durations.
+ */
+constexpr int NUM_BUCKETS = 28;
+
+/** Recorded durations of an operation. */
+struct Counters {
+  QAtomicInteger<quint64> count;
+  QAtomicInteger<quint64> totalNs;
+  QAtomicInteger<quint64> maxNs;
+  QAtomicInteger<quint64> buckets[NUM_BUCKETS];
+};
+
+Counters s_counters[PerformanceStatistics::NumOperations];
+
+const char* const operationNames[] = {
+  "readTags",
+  "writeTags",
+  "getFileInfos",
+  "filterAcceptsRow",
+  "replacePercentCodes",
+  "httpRequest",
+  "fingerprint"
+};
+
+static_assert(std::size(operationNames) == PerformanceStatistics::NumOperations,
+              "operationNames does not match Operation");
+
+/** Protects s_counterProviders. */
+QMutex s_counterProvidersMutex;
+
+/** Providers added with PerformanceStatistics::addCounters(). */
+QMap<QString, PerformanceStatistics::CounterProvider> s_counterProviders;
+
+int bucketOfDuration(quint64 nsecs)
+{
+  quint64 usecs = nsecs / 1000;
+  int bucket = 0;
+  while (usecs > 0 && bucket < NUM_BUCKETS - 1) {
+    usecs >>= 1;
+    ++bucket;
+  }
+  return bucket;
+}
+
+/**
+ * Get upper bound of a percentile from the histogram.
+ * @param counters counters with histogram
+ * @param count total count
+ * @param percent percentile
+ * @return upper bound of bucket containing percentile in microseconds.
+ */
+quint64 percentileUs(const Counters& counters, quint64 count, int percent)
+{
+  const quint64 rank = (count * percent + 99) / 100;
+  quint64 sum = 0;
+  for (int i = 0; i < NUM_BUCKETS; ++i) {
+    sum += counters.buckets[i].loadAcquire();
+    if (sum >= rank) {
+      return Q_UINT64_C(1) << i;
+    }
+  }
+  return counters.maxNs.loadAcquire() / 1000;
+}
+
+}
+
+QAtomicInt PerformanceStatistics::s_enabled(
+    qEnvironmentVariableIsSet("KID3_STATISTICS") ? 1 : 0);
+
+/**
+ * Enable or disable recording of statistics.
+ * @param enable true to enable
+ */
+void PerformanceStatistics::setEnabled(bool enable)
+{
+  s_enabled.storeRelease(enable ? 1 : 0);
+}
+
+/**
+ * Record the duration of an operation.
+ * Should be used if the start and end of an operation are not in the
+ * same scope, otherwise ScopedTimer is more convenient.
+ *
+ * @param operation instrumented operation
+ * @param nsecs duration in nanoseconds
+ */
+void PerformanceStatistics::record(Operation operation, qint64 nsecs)
+{
+  if (operation < 0 || operation >= NumOperations || nsecs < 0)
+    return;
+
+  Counters& counters = s_counters[operation];
+  const auto ns = static_cast<quint64>(nsecs);
+  counters.count.fetchAndAddRelaxed(1);
+  counters.totalNs.fetchAndAddRelaxed(ns);
+  counters.buckets[bucketOfDuration(ns)].fetchAndAddRelaxed(1);
+  quint64 maxNs = counters.maxNs.loadAcquire();
+  while (ns > maxNs && !counters.maxNs.testAndSetOrdered(maxNs, ns, maxNs)) {
+  }
+}
+
+/**
+ * Remove all recorded durations.
+ */
+void PerformanceStatistics::reset()
+{
+  for (Counters& counters : s_counters) {
+    counters.count.storeRelease(0);
+    counters.totalNs.storeRelease(0);
+    counters.maxNs.storeRelease(0);
+    for (auto& bucket : counters.buckets) {
+      bucket.storeRelease(0);
+    }
+  }
+}
+
+/**
+ * Get name of operation.
+ * @param operation instrumented operation
+ * @return name, e.g. "readTags".
+ */
+const char* PerformanceStatistics::operationName(Operation operation)
+{
+  return operation >= 0 && operation < NumOperations
+      ? operationNames[operation] : "";
+}
+
+/**
+ * Get recorded statistics.
+ *
+ * @return map with operation names as keys, the values are maps with
+ * "count", "totalMs", "meanUs", "maxUs", "p50Us", "p90Us", "p99Us"
+ * and "histogram", a map with the upper bounds of the buckets in
+ * microseconds and their counts. Only operations which have been
+ * recorded are contained.
+ */
+QVariantMap PerformanceStatistics::statistics()
+{
+  QVariantMap map;
+  for (int op = 0; op < NumOperations; ++op) {
+    const Counters& counters = s_counters[op];
+    const quint64 count = counters.count.loadAcquire();
+    if (count == 0)
+      continue;
+
+    const quint64 totalNs = counters.totalNs.loadAcquire();
+    QVariantMap histogram;
+    for (int i = 0; i < NUM_BUCKETS; ++i) {
+      if (quint64 bucketCount = counters.buckets[i].loadAcquire();
+          bucketCount > 0) {
+        histogram.insert(i < NUM_BUCKETS - 1
+                         ? QString::number(Q_UINT64_C(1) << i)
+                         : QLatin1String("inf"), bucketCount);
+      }
+    }
+    map.insert(QLatin1String(operationNames[op]), QVariantMap{
+      {QLatin1String("count"), count},
+      {QLatin1String("totalMs"), static_cast<double>(totalNs) / 1.0e6},
+      {QLatin1String("meanUs"), static_cast<double>(totalNs) / count / 1.0e3},
+      {QLatin1String("maxUs"), counters.maxNs.loadAcquire() / 1000},
+      {QLatin1String("p50Us"), percentileUs(counters, count, 50)},
+      {QLatin1String("p90Us"), percentileUs(counters, count, 90)},
+      {QLatin1String("p99Us"), percentileUs(counters, count, 99)},
+      {QLatin1String("histogram"), histogram}
+    });
+  }
+  return map;
+}
+
+/**
+ * Add counters maintained by a component.
+ * Adding the same name again replaces the provider.
+ *
+ * @param name name of counters, e.g. "fileHandles"
+ * @param provider function returning the current counters
+ */
+void PerformanceStatistics::addCounters(const QString& name,
+                                        CounterProvider provider)
+{
+  QMutexLocker locker(&s_counterProvidersMutex);
+  s_counterProviders.insert(name, provider);
+}
+
+/**
+ * Get counters added with addCounters().
+ *
+ * @return map with names of counters as keys, the values are the maps
+ * returned by the providers.
+ */
+QVariantMap PerformanceStatistics::counters()
+{
+  QMap<QString, CounterProvider> providers;
+  {
+    QMutexLocker locker(&s_counterProvidersMutex);
+    providers = s_counterProviders;
+  }
+  QVariantMap map;
+  for (auto it = providers.constBegin(); it != providers.constEnd(); ++it) {
+    map.insert(it.key(), it.value()());
+  }
+  return map;
+}
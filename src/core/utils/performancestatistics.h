@@ -0,0 +1,161 @@
+/**
+ * \file performancestatistics.h
+ * Timing counters for frequently executed operations.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QVariantMap>
+#include <QElapsedTimer>
+#include <QAtomicInt>
+#include "kid3api.h"
+
+/**
+ * Aggregated timing statistics for frequently executed operations.
+ *
+ * The durations of the operations are recorded with a ScopedTimer into
+ * a histogram with logarithmic buckets. Recording is disabled by default,
+ * in this case a ScopedTimer only checks a flag. It is enabled when the
+ * environment variable KID3_STATISTICS is set or with setEnabled().
+ * Components which maintain their own counters, e.g. plugins, can add them
+ * with addCounters(), they are always available.
+ * All methods are thread-safe.
+ */
+class KID3_CORE_EXPORT PerformanceStatistics {
+public:
+  /**
+   * Function returning counters of a component.
+   * Must be thread-safe.
+   */
+  typedef QVariantMap (*CounterProvider)();
+
+  /** Instrumented operations. */
+  enum Operation {
+    ReadTags,            /**< TaggedFile::readTags() */
+    WriteTags,           /**< TaggedFile::writeTags() */
+    GetFileInfos,        /**< FileInfoGatherer::getFileInfos() */
+    FilterAcceptsRow,    /**< FileProxyModel::filterAcceptsRow() */
+    ReplacePercentCodes, /**< FormatReplacer::replacePercentCodes() */
+    HttpRequest,         /**< HTTP request from sending until response */
+    Fingerprint,         /**< Calculation of an audio fingerprint */
+    NumOperations        /**< Number of operations */
+  };
+
+  /**
+   * Measures the time from its construction to its destruction.
+   */
+  class ScopedTimer {
+  public:
+    /**
+     * Constructor, starts timer if statistics are enabled.
+     * @param operation instrumented operation
+     */
+    explicit ScopedTimer(Operation operation) : m_operation(operation) {
+      if (isEnabled()) {
+        m_timer.start();
+      }
+    }
+
+    /**
+     * Destructor, records elapsed time.
+     */
+    ~ScopedTimer() {
+      if (m_timer.isValid()) {
+        record(m_operation, m_timer.nsecsElapsed());
+      }
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+  private:
+    QElapsedTimer m_timer;
+    const Operation m_operation;
+  };
+
+  /**
+   * Check if statistics are recorded.
+   * @return true if enabled.
+   */
+  static bool isEnabled() { return s_enabled.loadAcquire() != 0; }
+
+  /**
+   * Enable or disable recording of statistics.
+   * @param enable true to enable
+   */
+  static void setEnabled(bool enable);
+
+  /**
+   * Record the duration of an operation.
+   * Should be used if the start and end of an operation are not in the
+   * same scope, otherwise ScopedTimer is more convenient.
+   *
+   * @param operation instrumented operation
+   * @param nsecs duration in nanoseconds
+   */
+  static void record(Operation operation, qint64 nsecs);
+
+  /**
+   * Remove all recorded durations.
+   */
+  static void reset();
+
+  /**
+   * Get name of operation.
+   * @param operation instrumented operation
+   * @return name, e.g. "readTags".
+   */
+  static const char* operationName(Operation operation);
+
+  /**
+   * Get recorded statistics.
+   *
+   * @return map with operation names as keys, the values are maps with
+   * "count", "totalMs", "meanUs", "maxUs", "p50Us", "p90Us", "p99Us"
+   * and "histogram", a map with the upper bounds of the buckets in
+   * microseconds and their counts. Only operations which have been
+   * recorded are contained.
+   */
+  static QVariantMap statistics();
+
+  /**
+   * Add counters maintained by a component.
+   * Adding the same name again replaces the provider.
+   *
+   * @param name name of counters, e.g. "fileHandles"
+   * @param provider function returning the current counters
+   */
+  static void addCounters(const QString& name, CounterProvider provider);
+
+  /**
+   * Get counters added with addCounters().
+   *
+   * @return map with names of counters as keys, the values are the maps
+   * returned by the providers.
+   */
+  static QVariantMap counters();
+
+private:
+  static QAtomicInt s_enabled;
+};
@@ -137,6 +137,7 @@ ConfigDialogPages::ConfigDialogPages(IPlatformTools* platformTools,
   m_markChangesCheckBox(nullptr), m_coverFileNameLineEdit(nullptr),
   m_nameFilterComboBox(nullptr), m_includeFoldersLineEdit(nullptr),
   m_excludeFoldersLineEdit(nullptr), m_showHiddenFilesCheckBox(nullptr),
+  m_tagCacheCheckBox(nullptr), m_tagSnapshotsCheckBox(nullptr),
   m_fileTextEncodingComboBox(nullptr),
   m_markTruncationsCheckBox(nullptr), m_textEncodingV1ComboBox(nullptr),
   m_totalNumTracksCheckBox(nullptr), m_commentNameComboBox(nullptr),
@@ -158,6 +159,8 @@ ConfigDialogPages::ConfigDialogPages(IPlatformTools* platformTools,
   m_browserLineEdit(nullptr), m_proxyCheckBox(nullptr),
   m_proxyLineEdit(nullptr), m_proxyAuthenticationCheckBox(nullptr),
   m_proxyUserNameLineEdit(nullptr), m_proxyPasswordLineEdit(nullptr),
+  m_responseCacheCheckBox(nullptr), m_responseCacheDaysSpinBox(nullptr),
+  m_responseCacheSizeSpinBox(nullptr),
   m_enabledMetadataPluginsModel(nullptr), m_enabledPluginsModel(nullptr)
 {
 }
@@ -431,6 +434,11 @@ QWidget* ConfigDialogPages::createFilesPage()
   excludeFoldersLabel->setBuddy(m_excludeFoldersLineEdit);
   m_showHiddenFilesCheckBox = new QCheckBox(tr("&Show hidden files"),
                                             fileListGroupBox);
+  m_tagCacheCheckBox = new QCheckBox(tr("&Cache tags of unchanged files"),
+                                     fileListGroupBox);
+  m_tagSnapshotsCheckBox = new QCheckBox(
+        tr("&Keep only compact copies of read tags in memory"),
+        fileListGroupBox);
   auto fileListGroupBoxLayout = new QGridLayout(fileListGroupBox);
   fileListGroupBoxLayout->addWidget(nameFilterLabel, 0, 0);
   fileListGroupBoxLayout->addWidget(m_nameFilterComboBox, 0, 1);
@@ -439,6 +447,8 @@ QWidget* ConfigDialogPages::createFilesPage()
   fileListGroupBoxLayout->addWidget(excludeFoldersLabel, 2, 0);
   fileListGroupBoxLayout->addWidget(m_excludeFoldersLineEdit, 2, 1);
   fileListGroupBoxLayout->addWidget(m_showHiddenFilesCheckBox, 3, 0, 1, 2);
+  fileListGroupBoxLayout->addWidget(m_tagCacheCheckBox, 4, 0, 1, 2);
+  fileListGroupBoxLayout->addWidget(m_tagSnapshotsCheckBox, 5, 0, 1, 2);
   rightLayout->addWidget(fileListGroupBox);
 
   auto formatGroupBox = new QGroupBox(tr("Format"), filesPage);
@@ -612,6 +622,27 @@ QWidget* ConfigDialogPages::createNetworkPage()
   proxyGroupBox->setLayout(vbox);
   vlayout->addWidget(proxyGroupBox);
 
+  auto cacheGroupBox = new QGroupBox(tr("Cache"), networkPage);
+  m_responseCacheCheckBox = new QCheckBox(
+        tr("&Cache responses of import servers"), cacheGroupBox);
+  auto responseCacheDaysLabel =
+      new QLabel(tr("Use cached responses for &days:"), cacheGroupBox);
+  m_responseCacheDaysSpinBox = new QSpinBox(cacheGroupBox);
+  m_responseCacheDaysSpinBox->setRange(1, 3650);
+  responseCacheDaysLabel->setBuddy(m_responseCacheDaysSpinBox);
+  auto responseCacheSizeLabel =
+      new QLabel(tr("Maximum cache si&ze (MiB):"), cacheGroupBox);
+  m_responseCacheSizeSpinBox = new QSpinBox(cacheGroupBox);
+  m_responseCacheSizeSpinBox->setRange(1, 100000);
+  responseCacheSizeLabel->setBuddy(m_responseCacheSizeSpinBox);
+  auto cacheLayout = new QGridLayout(cacheGroupBox);
+  cacheLayout->addWidget(m_responseCacheCheckBox, 0, 0, 1, 2);
+  cacheLayout->addWidget(responseCacheDaysLabel, 1, 0);
+  cacheLayout->addWidget(m_responseCacheDaysSpinBox, 1, 1);
+  cacheLayout->addWidget(responseCacheSizeLabel, 2, 0);
+  cacheLayout->addWidget(m_responseCacheSizeSpinBox, 2, 1);
+  vlayout->addWidget(cacheGroupBox);
+
   auto vspacer = new QSpacerItem(0, 0,
                                  QSizePolicy::Minimum, QSizePolicy::Expanding);
   vlayout->addItem(vspacer);
@@ -721,6 +752,8 @@ void ConfigDialogPages::setConfigs(
   m_excludeFoldersLineEdit->setText(
         folderPatternListToString(fileCfg.excludeFolders(), false));
   m_showHiddenFilesCheckBox->setChecked(fileCfg.showHiddenFiles());
+  m_tagCacheCheckBox->setChecked(tagCfg.tagCacheEnabled());
+  m_tagSnapshotsCheckBox->setChecked(tagCfg.tagSnapshotsEnabled());
   m_fileTextEncodingComboBox->setCurrentIndex(fileCfg.textEncodingIndex());
   m_toFilenameFormats = fileCfg.toFilenameFormats();
   m_fromFilenameFormats = fileCfg.fromFilenameFormats();
@@ -780,6 +813,9 @@ void ConfigDialogPages::setConfigs(
   m_proxyAuthenticationCheckBox->setChecked(networkCfg.useProxyAuthentication());
   m_proxyUserNameLineEdit->setText(networkCfg.proxyUserName());
   m_proxyPasswordLineEdit->setText(networkCfg.proxyPassword());
+  m_responseCacheCheckBox->setChecked(networkCfg.responseCacheEnabled());
+  m_responseCacheDaysSpinBox->setValue(networkCfg.responseCacheDays());
+  m_responseCacheSizeSpinBox->setValue(networkCfg.responseCacheSize());
 
   QStringList metadataPlugins;
   if (QStringList pluginOrder = tagCfg.pluginOrder(); !pluginOrder.isEmpty()) {
@@ -857,6 +893,8 @@ void ConfigDialogPages::getConfig() const
   fileCfg.setExcludeFolders(
         folderPatternListFromString(m_excludeFoldersLineEdit->text(), false));
   fileCfg.setShowHiddenFiles(m_showHiddenFilesCheckBox->isChecked());
+  tagCfg.setTagCacheEnabled(m_tagCacheCheckBox->isChecked());
+  tagCfg.setTagSnapshotsEnabled(m_tagSnapshotsCheckBox->isChecked());
   fileCfg.setTextEncodingIndex(m_fileTextEncodingComboBox->currentIndex());
   fileCfg.setToFilenameFormats(m_toFilenameFormats);
   fileCfg.setFromFilenameFormats(m_fromFilenameFormats);
@@ -900,6 +938,9 @@ void ConfigDialogPages::getConfig() const
   networkCfg.setUseProxyAuthentication(m_proxyAuthenticationCheckBox->isChecked());
   networkCfg.setProxyUserName(m_proxyUserNameLineEdit->text());
   networkCfg.setProxyPassword(m_proxyPasswordLineEdit->text());
+  networkCfg.setResponseCacheEnabled(m_responseCacheCheckBox->isChecked());
+  networkCfg.setResponseCacheDays(m_responseCacheDaysSpinBox->value());
+  networkCfg.setResponseCacheSize(m_responseCacheSizeSpinBox->value());
 
   QStringList pluginOrder, disabledPlugins;
   const int numPlugins = m_enabledMetadataPluginsModel->rowCount();
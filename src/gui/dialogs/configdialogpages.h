@@ -154,6 +154,10 @@ private:
   QLineEdit* m_excludeFoldersLineEdit;
   /** Show hidden files checkbox */
   QCheckBox* m_showHiddenFilesCheckBox;
+  /** Tag cache checkbox */
+  QCheckBox* m_tagCacheCheckBox;
+  /** Tag snapshots checkbox */
+  QCheckBox* m_tagSnapshotsCheckBox;
   /** File text encoding combo box */
   QComboBox* m_fileTextEncodingComboBox;
   /** Mark truncated fields checkbox */
@@ -222,6 +226,12 @@ private:
   QLineEdit* m_proxyUserNameLineEdit;
   /** Proxy password line edit */
   QLineEdit* m_proxyPasswordLineEdit;
+  /** Cache responses of import servers check box */
+  QCheckBox* m_responseCacheCheckBox;
+  /** Days to use cached responses spin box */
+  QSpinBox* m_responseCacheDaysSpinBox;
+  /** Maximum response cache size spin box */
+  QSpinBox* m_responseCacheSizeSpinBox;
   /** Model with enabled metadata plugins */
   CheckableStringListModel* m_enabledMetadataPluginsModel;
   /** Model with enabled plugins */
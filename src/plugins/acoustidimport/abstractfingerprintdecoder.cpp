@@ -31,7 +31,7 @@
  * @param parent parent object
  */
 AbstractFingerprintDecoder::AbstractFingerprintDecoder(QObject* parent)
-  : QObject(parent), m_stopped(false)
+  : QObject(parent), m_stopped(0), m_maxLength(120)
 {
 }
 
@@ -47,7 +47,7 @@ AbstractFingerprintDecoder::~AbstractFingerprintDecoder()
  */
 void AbstractFingerprintDecoder::start(const QString&)
 {
-  m_stopped = false;
+  m_stopped.storeRelease(0);
 }
 
 /**
@@ -57,7 +57,7 @@ void AbstractFingerprintDecoder::start(const QString&)
  */
 void AbstractFingerprintDecoder::stop()
 {
-  m_stopped = true;
+  m_stopped.storeRelease(1);
 }
 
 /**
@@ -66,5 +66,5 @@ void AbstractFingerprintDecoder::stop()
  */
 bool AbstractFingerprintDecoder::isStopped() const
 {
-  return m_stopped;
+  return m_stopped.loadAcquire() != 0;
 }
@@ -27,6 +27,7 @@
 #pragma once
 
 #include <QObject>
+#include <QAtomicInt>
 
 /**
  * Abstract base class for Chromaprint fingerprint decoder.
@@ -64,6 +65,21 @@ public:
    */
   virtual bool isStopped() const;
 
+  /**
+   * Set the length of audio which is decoded from the start of a file.
+   * Must be called before start(), the decoder stops when enough data has
+   * been decoded, the duration reported with finished() is nevertheless
+   * the duration of the whole stream.
+   * @param seconds length in seconds
+   */
+  void setMaxLength(int seconds) { m_maxLength = seconds; }
+
+  /**
+   * Get the length of audio which is decoded from the start of a file.
+   * @return length in seconds.
+   */
+  int maxLength() const { return m_maxLength; }
+
   /**
    * Create concrete fingerprint decoder.
    * @param parent parent object
@@ -73,6 +89,15 @@ public:
    */
   static AbstractFingerprintDecoder* createFingerprintDecoder(QObject* parent);
 
+  /**
+   * Check if decoders created by createFingerprintDecoder() can run in
+   * worker threads, so that multiple files can be decoded concurrently.
+   * @return true if decoders can be moved to other threads.
+   * @remarks This static method will be implemented by the concrete
+   * fingerprint decoder which is used.
+   */
+  static bool canRunInThread();
+
 signals:
   /**
    * Emitted when decoding starts.
@@ -100,5 +125,7 @@ signals:
   void finished(int duration);
 
 private:
-  bool m_stopped;
+  /** Set by stop(), which can be called from another thread */
+  QAtomicInt m_stopped;
+  int m_maxLength;
 };
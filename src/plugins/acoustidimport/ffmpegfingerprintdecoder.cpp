@@ -627,8 +627,8 @@ void FFmpegFingerprintDecoder::start(const QString& filePath)
   AVPacket* packetTemp = ::av_packet_alloc();
 #endif
 
-  constexpr int MAX_LENGTH = 120;
-  int remaining = MAX_LENGTH * codec.channels() * codec.sampleRate();
+  qint64 remaining = static_cast<qint64>(maxLength()) *
+                     codec.channels() * codec.sampleRate();
   emit started(codec.sampleRate(), codec.channels());
 
   while (remaining > 0 && err == FingerprintCalculator::Ok) {
@@ -659,7 +659,8 @@ void FFmpegFingerprintDecoder::start(const QString& filePath)
         if (!buffer)
           break;
 
-        int length = qMin(remaining, bufferSize / 2);
+        int length = static_cast<int>(
+              qMin<qint64>(remaining, bufferSize / 2));
         emit bufferReady(QByteArray(reinterpret_cast<char*>(buffer), length * 2));
         if (isStopped()) {
           err = FingerprintCalculator::FingerprintCalculationFailed;
@@ -696,3 +697,17 @@ AbstractFingerprintDecoder*
 AbstractFingerprintDecoder::createFingerprintDecoder(QObject* parent) {
   return new FFmpegFingerprintDecoder(parent);
 }
+
+/**
+ * Check if decoders created by createFingerprintDecoder() can run in
+ * worker threads, so that multiple files can be decoded concurrently.
+ * @return true if decoders can be moved to other threads.
+ */
+bool AbstractFingerprintDecoder::canRunInThread() {
+#if LIBAVCODEC_VERSION_INT >= AV_VERSION_INT(58, 9, 100)
+  return true;
+#else
+  // Older versions require a lock manager to open codecs in multiple threads.
+  return false;
+#endif
+}
@@ -0,0 +1,217 @@
+/**
+ * \file fingerprintcache.cpp
+ * Cache for fingerprints of unchanged audio files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fingerprintcache.h"
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <QStandardPaths>
+#include <QVector>
+#include <algorithm>
+#include "importconfig.h"
+
+namespace {
+
+/** Magic number at the start of the cache file. */
+constexpr quint32 CACHE_MAGIC = 0x4b334650;
+/** Version of the cache file format, increment when the format changes. */
+constexpr quint32 CACHE_VERSION = 1;
+/**
+ * Maximum number of stored entries, the least recently used entries are
+ * removed when the cache is saved.
+ */
+constexpr int MAX_ENTRIES = 50000;
+
+}
+
+/**
+ * Get cache instance.
+ * @return fingerprint cache.
+ */
+FingerprintCache& FingerprintCache::instance()
+{
+  static FingerprintCache cache;
+  return cache;
+}
+
+/**
+ * Get the fingerprint of a file.
+ *
+ * @param filePath path to audio file
+ * @param length number of seconds used to calculate the fingerprint
+ * @param fingerprint the fingerprint is returned here
+ * @param duration the duration in seconds is returned here
+ *
+ * @return true if an up-to-date entry was found.
+ */
+bool FingerprintCache::find(const QString& filePath, int length,
+                            QString& fingerprint, int& duration)
+{
+  load();
+  auto it = m_entries.find(filePath);
+  if (it == m_entries.end() || it->length != length) {
+    return false;
+  }
+  if (QFileInfo fi(filePath);
+      !fi.exists() || fi.size() != it->size ||
+      fi.lastModified().toMSecsSinceEpoch() != it->modified) {
+    m_entries.erase(it);
+    m_dirty = true;
+    return false;
+  }
+  it->used = QDateTime::currentMSecsSinceEpoch();
+  m_dirty = true;
+  fingerprint = it->fingerprint;
+  duration = it->duration;
+  return true;
+}
+
+/**
+ * Store the fingerprint of a file.
+ *
+ * @param filePath path to audio file
+ * @param length number of seconds used to calculate the fingerprint
+ * @param fingerprint Chromaprint fingerprint
+ * @param duration duration in seconds
+ */
+void FingerprintCache::insert(const QString& filePath, int length,
+                              const QString& fingerprint, int duration)
+{
+  QFileInfo fi(filePath);
+  if (!fi.exists() || fingerprint.isEmpty()) {
+    return;
+  }
+  load();
+  m_entries.insert(filePath, {fi.size(), fi.lastModified().toMSecsSinceEpoch(),
+                              QDateTime::currentMSecsSinceEpoch(),
+                              length, fingerprint, duration});
+  m_dirty = true;
+}
+
+/**
+ * Get path to cache file.
+ * @return path in cache directory, empty if not available.
+ */
+QString FingerprintCache::cacheFilePath()
+{
+  const QString dirPath =
+      QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+  return dirPath.isEmpty()
+      ? QString() : dirPath + QLatin1String("/fingerprints.dat");
+}
+
+/**
+ * Read cache from cache directory if not already done.
+ */
+void FingerprintCache::load()
+{
+  if (m_loaded) {
+    return;
+  }
+  m_loaded = true;
+  if (!ImportConfig::instance().fingerprintCacheEnabled()) {
+    return;
+  }
+  QFile file(cacheFilePath());
+  if (!file.open(QIODevice::ReadOnly)) {
+    return;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  quint32 magic, version, numEntries;
+  stream >> magic >> version;
+  if (stream.status() != QDataStream::Ok ||
+      magic != CACHE_MAGIC || version != CACHE_VERSION) {
+    return;
+  }
+  stream >> numEntries;
+  for (quint32 i = 0;
+       i < numEntries && stream.status() == QDataStream::Ok;
+       ++i) {
+    QString filePath;
+    Entry entry;
+    qint32 length, duration;
+    stream >> filePath >> entry.size >> entry.modified >> entry.used
+           >> length >> entry.fingerprint >> duration;
+    entry.length = length;
+    entry.duration = duration;
+    m_entries.insert(filePath, entry);
+  }
+  if (stream.status() != QDataStream::Ok) {
+    m_entries.clear();
+  }
+}
+
+/**
+ * Store the cache in the cache directory if it has been changed and the
+ * fingerprint cache is enabled.
+ */
+void FingerprintCache::save()
+{
+  if (!m_dirty || !ImportConfig::instance().fingerprintCacheEnabled()) {
+    return;
+  }
+  if (m_entries.size() > MAX_ENTRIES) {
+    QVector<qint64> usedTimes;
+    usedTimes.reserve(m_entries.size());
+    for (const Entry& entry : std::as_const(m_entries)) {
+      usedTimes.append(entry.used);
+    }
+    auto nth = usedTimes.begin() + (usedTimes.size() - MAX_ENTRIES);
+    std::nth_element(usedTimes.begin(), nth, usedTimes.end());
+    const qint64 minUsed = *nth;
+    for (auto it = m_entries.begin(); it != m_entries.end();) {
+      if (it->used < minUsed) {
+        it = m_entries.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+  const QString filePath = cacheFilePath();
+  if (filePath.isEmpty() || !QDir().mkpath(QFileInfo(filePath).path())) {
+    return;
+  }
+  QSaveFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return;
+  }
+  QDataStream stream(&file);
+  stream.setVersion(QDataStream::Qt_5_0);
+  stream << CACHE_MAGIC << CACHE_VERSION
+         << static_cast<quint32>(m_entries.size());
+  for (auto it = m_entries.constBegin(); it != m_entries.constEnd(); ++it) {
+    stream << it.key() << it->size << it->modified << it->used
+           << static_cast<qint32>(it->length) << it->fingerprint
+           << static_cast<qint32>(it->duration);
+  }
+  if (stream.status() == QDataStream::Ok && file.commit()) {
+    m_dirty = false;
+  }
+}
@@ -0,0 +1,109 @@
+/**
+ * \file fingerprintcache.h
+ * Cache for fingerprints of unchanged audio files.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QString>
+#include <QHash>
+
+/**
+ * Cache with the Chromaprint fingerprints and durations of audio files.
+ *
+ * An entry is only used as long as the size and modification time of the
+ * file are unchanged. If ImportConfig::fingerprintCacheEnabled() is set,
+ * the entries are stored in the cache directory, so that unchanged files do
+ * not have to be decoded again in later sessions. Only used from the main
+ * thread.
+ */
+class FingerprintCache {
+public:
+  /**
+   * Get cache instance.
+   * @return fingerprint cache.
+   */
+  static FingerprintCache& instance();
+
+  /**
+   * Get the fingerprint of a file.
+   *
+   * @param filePath path to audio file
+   * @param length number of seconds used to calculate the fingerprint
+   * @param fingerprint the fingerprint is returned here
+   * @param duration the duration in seconds is returned here
+   *
+   * @return true if an up-to-date entry was found.
+   */
+  bool find(const QString& filePath, int length, QString& fingerprint,
+            int& duration);
+
+  /**
+   * Store the fingerprint of a file.
+   *
+   * @param filePath path to audio file
+   * @param length number of seconds used to calculate the fingerprint
+   * @param fingerprint Chromaprint fingerprint
+   * @param duration duration in seconds
+   */
+  void insert(const QString& filePath, int length,
+              const QString& fingerprint, int duration);
+
+  /**
+   * Store the cache in the cache directory if it has been changed and the
+   * fingerprint cache is enabled.
+   */
+  void save();
+
+private:
+  /** Cache entry for a file. */
+  struct Entry {
+    qint64 size;          /**< size of file */
+    qint64 modified;      /**< modification time of file in ms since epoch */
+    qint64 used;          /**< time of last use in ms since epoch */
+    int length;           /**< seconds used to calculate fingerprint */
+    QString fingerprint;  /**< Chromaprint fingerprint */
+    int duration;         /**< duration in seconds */
+  };
+
+  FingerprintCache() = default;
+  ~FingerprintCache() = default;
+  FingerprintCache(const FingerprintCache&) = delete;
+  FingerprintCache& operator=(const FingerprintCache&) = delete;
+
+  /**
+   * Read cache from cache directory if not already done.
+   */
+  void load();
+
+  /**
+   * Get path to cache file.
+   * @return path in cache directory, empty if not available.
+   */
+  static QString cacheFilePath();
+
+  QHash<QString, Entry> m_entries;
+  bool m_loaded = false;
+  bool m_dirty = false;
+};
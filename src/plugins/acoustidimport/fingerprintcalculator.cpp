@@ -28,13 +28,15 @@
 #include "fingerprintcalculator.h"
 #include "config.h"
 #include "abstractfingerprintdecoder.h"
+#include "performancestatistics.h"
 
 /**
  * Constructor.
  */
 FingerprintCalculator::FingerprintCalculator(QObject* parent) : QObject(parent),
   m_chromaprintCtx(nullptr),
-  m_decoder(AbstractFingerprintDecoder::createFingerprintDecoder(this))
+  m_decoder(AbstractFingerprintDecoder::createFingerprintDecoder(this)),
+  m_remainingSamples(0), m_maxLength(0)
 {
   connect(m_decoder, &AbstractFingerprintDecoder::started,
           this, &FingerprintCalculator::startChromaprint);
@@ -61,12 +63,20 @@ FingerprintCalculator::~FingerprintCalculator()
  * When the calculation is finished, finished() is emitted.
  *
  * @param fileName path to audio file
+ * @param maxLength number of seconds used from the start of the file
  */
-void FingerprintCalculator::start(const QString& fileName) {
+void FingerprintCalculator::start(const QString& fileName, int maxLength) {
   if (!m_chromaprintCtx) {
     // Lazy initialization to save resources if not used
     m_chromaprintCtx = ::chromaprint_new(CHROMAPRINT_ALGORITHM_DEFAULT);
   }
+  if (PerformanceStatistics::isEnabled()) {
+    m_elapsed.start();
+  } else {
+    m_elapsed.invalidate();
+  }
+  m_maxLength = maxLength;
+  m_decoder->setMaxLength(maxLength);
   m_decoder->start(fileName);
 }
 
@@ -84,6 +94,8 @@ void FingerprintCalculator::stop() {
  */
 void FingerprintCalculator::startChromaprint(int sampleRate, int channelCount)
 {
+  m_remainingSamples =
+      static_cast<qint64>(m_maxLength) * sampleRate * channelCount;
   ::chromaprint_start(m_chromaprintCtx, sampleRate, channelCount);
 }
 
@@ -93,9 +105,18 @@ void FingerprintCalculator::startChromaprint(int sampleRate, int channelCount)
  */
 void FingerprintCalculator::feedChromaprint(QByteArray data)
 {
+  // Decoders stop at buffer boundaries, so they can deliver more data
+  // than needed, which is ignored to get the same fingerprint with all
+  // decoders.
+  const int numSamples =
+      static_cast<int>(qMin<qint64>(m_remainingSamples, data.size() / 2));
+  if (numSamples <= 0) {
+    return;
+  }
+  m_remainingSamples -= numSamples;
   if (!::chromaprint_feed(m_chromaprintCtx,
                           reinterpret_cast<qint16*>(data.data()),
-                          data.size() / 2)) {
+                          numSamples)) {
     m_decoder->stop();
     emit finished(QString(), 0, FingerprintCalculationFailed);
   }
@@ -126,5 +147,10 @@ void FingerprintCalculator::finishChromaprint(int duration)
   } else {
     err = FingerprintCalculationFailed;
   }
+  if (m_elapsed.isValid()) {
+    PerformanceStatistics::record(PerformanceStatistics::Fingerprint,
+                                  m_elapsed.nsecsElapsed());
+    m_elapsed.invalidate();
+  }
   emit finished(fingerprint, duration, err);
 }
@@ -28,6 +28,7 @@
 
 #include <QObject>
 #include <QString>
+#include <QElapsedTimer>
 #include <chromaprint.h>
 
 class AbstractFingerprintDecoder;
@@ -65,8 +66,9 @@ public:
    * When the calculation is finished, finished() is emitted.
    *
    * @param fileName path to audio file
+   * @param maxLength number of seconds used from the start of the file
    */
-  void start(const QString& fileName);
+  Q_INVOKABLE void start(const QString& fileName, int maxLength);
 
   /**
    * Stop decoder.
@@ -112,4 +114,8 @@ private slots:
 private:
   ChromaprintContext* m_chromaprintCtx;
   AbstractFingerprintDecoder* m_decoder;
+  /** Number of samples which are still fed to Chromaprint */
+  qint64 m_remainingSamples;
+  int m_maxLength;
+  QElapsedTimer m_elapsed;
 };
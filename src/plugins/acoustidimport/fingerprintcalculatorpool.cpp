@@ -0,0 +1,264 @@
+/**
+ * \file fingerprintcalculatorpool.cpp
+ * Calculates fingerprints of multiple files concurrently.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "fingerprintcalculatorpool.h"
+#include <QThread>
+#include <QTimer>
+#include <algorithm>
+#include "fingerprintcalculator.h"
+#include "abstractfingerprintdecoder.h"
+#include "fingerprintcache.h"
+
+/**
+ * Constructor.
+ * @param parent parent object
+ */
+FingerprintCalculatorPool::FingerprintCalculatorPool(QObject* parent)
+  : QObject(parent), m_nextIndex(0), m_maxLength(0),
+    m_startCount(0), m_generation(0),
+    m_threaded(AbstractFingerprintDecoder::canRunInThread())
+{
+}
+
+/**
+ * Destructor.
+ */
+FingerprintCalculatorPool::~FingerprintCalculatorPool()
+{
+  deleteWorkers();
+  FingerprintCache::instance().save();
+}
+
+/**
+ * Create the workers.
+ * @param numWorkers number of workers, 0 for the number of processor cores
+ */
+void FingerprintCalculatorPool::createWorkers(int numWorkers)
+{
+  if (!m_threaded) {
+    numWorkers = 1;
+  } else if (numWorkers <= 0) {
+    numWorkers = qMax(QThread::idealThreadCount(), 1);
+  }
+  if (m_workers.size() == numWorkers) {
+    return;
+  }
+
+  deleteWorkers();
+  m_workers.reserve(numWorkers);
+  for (int workerNr = 0; workerNr < numWorkers; ++workerNr) {
+    Worker worker;
+    if (m_threaded) {
+      worker.calculator = new FingerprintCalculator;
+      worker.thread = new QThread(this);
+      worker.calculator->moveToThread(worker.thread);
+      worker.thread->start();
+    } else {
+      worker.calculator = new FingerprintCalculator(this);
+      worker.thread = nullptr;
+    }
+    const int generation = m_generation;
+    connect(worker.calculator, &FingerprintCalculator::finished,
+            this, [this, generation, workerNr](const QString& fingerprint,
+                                               int duration, int error) {
+      onWorkerFinished(generation, workerNr, fingerprint, duration, error);
+    });
+    m_workers.append(worker);
+  }
+}
+
+/**
+ * Delete all workers.
+ */
+void FingerprintCalculatorPool::deleteWorkers()
+{
+  ++m_generation;
+  for (const Worker& worker : std::as_const(m_workers)) {
+    worker.calculator->stop();
+    if (worker.thread) {
+      worker.thread->quit();
+      worker.thread->wait();
+      delete worker.calculator;
+      delete worker.thread;
+    } else {
+      delete worker.calculator;
+    }
+  }
+  m_workers.clear();
+}
+
+/**
+ * Calculate the fingerprints of files.
+ * Previously started calculations are stopped.
+ * For each file, started() and finished() are emitted.
+ *
+ * @param fileNames paths to audio files
+ * @param numWorkers number of files to decode concurrently,
+ * 0 to use the number of processor cores
+ * @param maxLength number of seconds used from the start of each file
+ */
+void FingerprintCalculatorPool::start(const QVector<QString>& fileNames,
+                                      int numWorkers, int maxLength)
+{
+  stop();
+  m_fileNames = fileNames;
+  m_nextIndex = 0;
+  m_maxLength = maxLength;
+  m_cached.fill(false, m_fileNames.size());
+  FingerprintCache& cache = FingerprintCache::instance();
+  for (int index = 0; index < m_fileNames.size(); ++index) {
+    CachedResult result;
+    result.index = index;
+    if (cache.find(m_fileNames.at(index), m_maxLength, result.fingerprint,
+                   result.duration)) {
+      m_cached[index] = true;
+      m_cachedResults.append(result);
+    }
+  }
+  if (!m_cachedResults.isEmpty()) {
+    // Like results from the calculators, the cached results are not
+    // delivered before start() returns.
+    QTimer::singleShot(0, this, &FingerprintCalculatorPool::emitCachedResults);
+  }
+  if (m_cachedResults.size() < m_fileNames.size()) {
+    createWorkers(numWorkers);
+    startIdleWorkers();
+  }
+}
+
+/**
+ * Stop calculations.
+ */
+void FingerprintCalculatorPool::stop()
+{
+  ++m_startCount;
+  m_fileNames.clear();
+  m_cached.clear();
+  m_cachedResults.clear();
+  m_nextIndex = 0;
+  for (Worker& worker : m_workers) {
+    worker.calculator->stop();
+    if (worker.thread) {
+      // The results of the running and queued jobs will still arrive
+      // and have to be ignored.
+      for (int& index : worker.jobs) {
+        index = -1;
+      }
+    } else {
+      worker.jobs.clear();
+    }
+  }
+}
+
+/**
+ * Start calculations on idle workers.
+ */
+void FingerprintCalculatorPool::startIdleWorkers()
+{
+  // Indexes are used because signals emitted from here can lead to
+  // calls to start() or stop().
+  for (int workerNr = 0;
+       workerNr < m_workers.size() && m_nextIndex < m_fileNames.size();
+       ++workerNr) {
+    if (!m_workers.at(workerNr).jobs.isEmpty()) {
+      continue;
+    }
+    while (m_nextIndex < m_fileNames.size() && m_cached.at(m_nextIndex)) {
+      ++m_nextIndex;
+    }
+    if (m_nextIndex >= m_fileNames.size()) {
+      break;
+    }
+    const int index = m_nextIndex++;
+    const QString fileName = m_fileNames.at(index);
+    m_workers[workerNr].jobs.append(index);
+    FingerprintCalculator* calculator = m_workers.at(workerNr).calculator;
+    emit started(index);
+    if (m_threaded) {
+      QMetaObject::invokeMethod(calculator, "start", Qt::QueuedConnection,
+                                Q_ARG(QString, fileName),
+                                Q_ARG(int, m_maxLength));
+    } else {
+      // Can emit finished() before returning.
+      calculator->start(fileName, m_maxLength);
+    }
+  }
+}
+
+/**
+ * Called when a calculator has finished a job.
+ *
+ * @param generation value of m_generation when the worker was created
+ * @param workerNr index of worker in m_workers
+ * @param fingerprint Chromaprint fingerprint
+ * @param duration duration in seconds
+ * @param error error code
+ */
+void FingerprintCalculatorPool::onWorkerFinished(
+    int generation, int workerNr, const QString& fingerprint, int duration,
+    int error)
+{
+  if (generation != m_generation || workerNr < 0 ||
+      workerNr >= m_workers.size() || m_workers.at(workerNr).jobs.isEmpty()) {
+    return;
+  }
+  const int index = m_workers[workerNr].jobs.takeFirst();
+  // Continue asynchronously to avoid a recursion over all files
+  // with decoders which finish within start().
+  QTimer::singleShot(0, this, &FingerprintCalculatorPool::startIdleWorkers);
+  if (index >= 0) {
+    if (error == FingerprintCalculator::Ok) {
+      FingerprintCache::instance().insert(m_fileNames.at(index), m_maxLength,
+                                          fingerprint, duration);
+    }
+    if (m_nextIndex >= m_fileNames.size() &&
+        std::all_of(m_workers.constBegin(), m_workers.constEnd(),
+                    [](const Worker& worker) {
+                      return worker.jobs.isEmpty();
+                    })) {
+      FingerprintCache::instance().save();
+    }
+    emit finished(index, fingerprint, duration, error);
+  }
+}
+
+/**
+ * Emit finished() for the files found in the fingerprint cache.
+ */
+void FingerprintCalculatorPool::emitCachedResults()
+{
+  const int startCount = m_startCount;
+  const QList<CachedResult> results = m_cachedResults;
+  m_cachedResults.clear();
+  for (const CachedResult& result : results) {
+    if (m_startCount != startCount) {
+      // start() or stop() was called from a signal handler.
+      break;
+    }
+    emit finished(result.index, result.fingerprint, result.duration,
+                  FingerprintCalculator::Ok);
+  }
+}
@@ -0,0 +1,161 @@
+/**
+ * \file fingerprintcalculatorpool.h
+ * Calculates fingerprints of multiple files concurrently.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+#include <QList>
+#include <QString>
+
+class QThread;
+class FingerprintCalculator;
+
+/**
+ * Pool of fingerprint calculators working on a list of files.
+ *
+ * The files are processed in the order of the list. If the decoder supports
+ * it, each calculator runs in its own thread, so that multiple files are
+ * decoded concurrently. Otherwise a single calculator is used in the thread
+ * of the pool. Files with a fingerprint in the FingerprintCache are not
+ * decoded.
+ */
+class FingerprintCalculatorPool : public QObject {
+  Q_OBJECT
+public:
+  /**
+   * Constructor.
+   * @param parent parent object
+   */
+  explicit FingerprintCalculatorPool(QObject* parent = nullptr);
+
+  /**
+   * Destructor.
+   */
+  ~FingerprintCalculatorPool() override;
+
+  /**
+   * Calculate the fingerprints of files.
+   * Previously started calculations are stopped.
+   * For each file, started() and finished() are emitted.
+   *
+   * @param fileNames paths to audio files
+   * @param numWorkers number of files to decode concurrently,
+   * 0 to use the number of processor cores
+   * @param maxLength number of seconds used from the start of each file
+   */
+  void start(const QVector<QString>& fileNames, int numWorkers,
+             int maxLength);
+
+  /**
+   * Stop calculations.
+   */
+  void stop();
+
+signals:
+  /**
+   * Emitted when the fingerprint calculation for a file is started.
+   * @param index index of file in list passed to start()
+   */
+  void started(int index);
+
+  /**
+   * Emitted when the fingerprint calculation for a file is finished.
+   *
+   * @param index index of file in list passed to start()
+   * @param fingerprint Chromaprint fingerprint
+   * @param duration duration in seconds
+   * @param error error code, enum FingerprintCalculator::Error
+   */
+  void finished(int index, const QString& fingerprint, int duration,
+                int error);
+
+private slots:
+  /**
+   * Start calculations on idle workers.
+   */
+  void startIdleWorkers();
+
+  /**
+   * Emit finished() for the files found in the fingerprint cache.
+   */
+  void emitCachedResults();
+
+private:
+  /** Calculator with the jobs it has been given. */
+  struct Worker {
+    FingerprintCalculator* calculator;
+    QThread* thread;
+    /**
+     * Indexes of files started and not yet finished, in the order in which
+     * they were started, -1 for stopped jobs.
+     */
+    QList<int> jobs;
+  };
+
+  /** Fingerprint found in cache. */
+  struct CachedResult {
+    int index;
+    QString fingerprint;
+    int duration;
+  };
+
+  /**
+   * Create the workers.
+   * @param numWorkers number of workers, 0 for the number of processor cores
+   */
+  void createWorkers(int numWorkers);
+
+  /**
+   * Delete all workers.
+   */
+  void deleteWorkers();
+
+  /**
+   * Called when a calculator has finished a job.
+   *
+   * @param generation value of m_generation when the worker was created
+   * @param workerNr index of worker in m_workers
+   * @param fingerprint Chromaprint fingerprint
+   * @param duration duration in seconds
+   * @param error error code
+   */
+  void onWorkerFinished(int generation, int workerNr,
+                        const QString& fingerprint, int duration, int error);
+
+  QVector<Worker> m_workers;
+  QVector<QString> m_fileNames;
+  /** true for the files in m_fileNames which are found in the cache */
+  QVector<bool> m_cached;
+  QList<CachedResult> m_cachedResults;
+  int m_nextIndex;
+  int m_maxLength;
+  /** Incremented by start() and stop() to detect calls from signal handlers */
+  int m_startCount;
+  /** Incremented when workers are deleted to ignore their queued results */
+  int m_generation;
+  const bool m_threaded;
+};
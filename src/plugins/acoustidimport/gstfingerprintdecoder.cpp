@@ -289,7 +289,7 @@ void GstFingerprintDecoder::cb_new_buffer(GstElement* sink, GstFingerprintDecode
     if (self->isStopped()) {
       self->raiseError(FingerprintCalculator::FingerprintCalculationFailed);
     }
-    if (buf_pos >= MAX_LENGTH_NS) {
+    if (buf_pos >= self->maxLength() * GST_SECOND) {
       g_main_loop_quit(self->m_loop);
     }
   }
@@ -358,3 +358,14 @@ AbstractFingerprintDecoder*
 AbstractFingerprintDecoder::createFingerprintDecoder(QObject* parent) {
   return new GstFingerprintDecoder(parent);
 }
+
+/**
+ * Check if decoders created by createFingerprintDecoder() can run in
+ * worker threads, so that multiple files can be decoded concurrently.
+ * @return true if decoders can be moved to other threads.
+ */
+bool AbstractFingerprintDecoder::canRunInThread() {
+  // The decoder runs its loop in the default main context,
+  // which is also used by the Qt event loop of the main thread.
+  return false;
+}
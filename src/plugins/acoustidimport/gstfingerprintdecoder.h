@@ -61,7 +61,6 @@ public:
 
 private:
   static const int BUFFER_SIZE = 10;
-  static const gint64 MAX_LENGTH_NS = 120000000000;
   static const guint TIMEOUT_MS = 5000;
 
   void raiseError(FingerprintCalculator::Error error);
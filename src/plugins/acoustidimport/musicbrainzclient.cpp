@@ -30,7 +30,9 @@
 #include <QRegularExpression>
 #include "httpclient.h"
 #include "trackdatamodel.h"
+#include "importconfig.h"
 #include "fingerprintcalculator.h"
+#include "fingerprintcalculatorpool.h"
 
 namespace {
 
@@ -188,13 +190,15 @@ void parseMusicBrainzMetadata(const QByteArray& bytes,
 MusicBrainzClient::MusicBrainzClient(QNetworkAccessManager* netMgr,
                                      TrackDataModel *trackDataModel)
   : ServerTrackImporter(netMgr, trackDataModel),
-    m_fingerprintCalculator(new FingerprintCalculator(this)),
+    m_fingerprintPool(new FingerprintCalculatorPool(this)),
     m_state(Idle), m_currentIndex(-1)
 {
   m_headers["User-Agent"] = "curl/7.52.1";
   connect(httpClient(), &HttpClient::bytesReceived,
           this, &MusicBrainzClient::receiveBytes);
-  connect(m_fingerprintCalculator, &FingerprintCalculator::finished,
+  connect(m_fingerprintPool, &FingerprintCalculatorPool::started,
+          this, &MusicBrainzClient::fingerprintStarted);
+  connect(m_fingerprintPool, &FingerprintCalculatorPool::finished,
           this, &MusicBrainzClient::receiveFingerprint);
 }
 
@@ -262,7 +266,7 @@ bool MusicBrainzClient::verifyTrackIndex()
  */
 void MusicBrainzClient::stop()
 {
-  m_fingerprintCalculator->stop();
+  m_fingerprintPool->stop();
   m_currentIndex = -1;
   m_state = Idle;
 }
@@ -300,23 +304,53 @@ void MusicBrainzClient::receiveBytes(const QByteArray& bytes)
   }
 }
 
+/**
+ * Called when the fingerprint calculation for a track is started.
+ * @param index index of track
+ */
+void MusicBrainzClient::fingerprintStarted(int index)
+{
+  emit statusChanged(index, tr("Fingerprint"));
+}
+
 /**
  * Receive fingerprint from decoder.
+ * The fingerprints can be calculated ahead of the current track, they are
+ * looked up in the order of the tracks.
  *
+ * @param index index of track
  * @param fingerprint Chromaprint fingerprint
  * @param duration duration in seconds
  * @param error error code
  */
-void MusicBrainzClient::receiveFingerprint(const QString& fingerprint,
+void MusicBrainzClient::receiveFingerprint(int index,
+                                           const QString& fingerprint,
                                            int duration, int error)
 {
-  if (error == FingerprintCalculator::Ok) {
+  if (index < 0 || index >= m_fingerprintOfTrack.size())
+    return;
+  m_fingerprintOfTrack[index] = {fingerprint, duration, error};
+  if (m_state == CalculatingFingerprint && index == m_currentIndex) {
+    lookupFingerprint();
+  }
+}
+
+/**
+ * Look up the fingerprint of the current track.
+ */
+void MusicBrainzClient::lookupFingerprint()
+{
+  if (!verifyTrackIndex())
+    return;
+  Fingerprint& fp = m_fingerprintOfTrack[m_currentIndex];
+  if (fp.error == FingerprintCalculator::Ok) {
     m_state = GettingIds;
     emit statusChanged(m_currentIndex, tr("ID Lookup"));
     QString path(
       QLatin1String("/v2/lookup?client=LxDbFAXo&meta=recordingids&duration=") +
-      QString::number(duration) +
-      QLatin1String("&fingerprint=") + fingerprint);
+      QString::number(fp.duration) +
+      QLatin1String("&fingerprint=") + fp.fingerprint);
+    fp.fingerprint.clear();
     httpClient()->sendRequest(QLatin1String("api.acoustid.org"), path,
                               QLatin1String("https"));
   } else {
@@ -339,8 +373,11 @@ void MusicBrainzClient::processNextStep()
   {
     if (!verifyTrackIndex())
       return;
-    emit statusChanged(m_currentIndex, tr("Fingerprint"));
-    m_fingerprintCalculator->start(m_filenameOfTrack.at(m_currentIndex));
+    // Otherwise the fingerprint is looked up when it is received.
+    if (m_fingerprintOfTrack.at(m_currentIndex).error !=
+        FingerprintCalculator::Pending) {
+      lookupFingerprint();
+    }
     break;
   }
   case GettingMetadata:
@@ -397,6 +434,7 @@ void MusicBrainzClient::start()
 {
   m_filenameOfTrack.clear();
   m_idsOfTrack.clear();
+  m_fingerprintOfTrack.clear();
   const ImportTrackDataVector& trackDataVector(trackDataModel()->trackData());
   for (auto it = trackDataVector.constBegin();
        it != trackDataVector.constEnd();
@@ -404,8 +442,12 @@ void MusicBrainzClient::start()
     if (it->isEnabled()) {
       m_filenameOfTrack.append(it->getAbsFilename());
       m_idsOfTrack.append(QStringList());
+      m_fingerprintOfTrack.append({QString(), 0, FingerprintCalculator::Pending});
     }
   }
   stop();
+  const ImportConfig& importCfg = ImportConfig::instance();
+  m_fingerprintPool->start(m_filenameOfTrack, importCfg.fingerprintWorkers(),
+                           importCfg.fingerprintLength());
   processNextTrack();
 }
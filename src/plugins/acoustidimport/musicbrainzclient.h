@@ -31,7 +31,7 @@
 #include "trackdata.h"
 
 class QByteArray;
-class FingerprintCalculator;
+class FingerprintCalculatorPool;
 
 /**
  * MusicBrainz client.
@@ -92,7 +92,10 @@ public:
 private slots:
   void receiveBytes(const QByteArray& bytes);
 
-  void receiveFingerprint(const QString& fingerprint, int duration, int error);
+  void receiveFingerprint(int index, const QString& fingerprint, int duration,
+                          int error);
+
+  void fingerprintStarted(int index);
 
 private:
   enum State {
@@ -102,14 +105,23 @@ private:
     GettingMetadata
   };
 
+  /** Result of fingerprint calculation. */
+  struct Fingerprint {
+    QString fingerprint;
+    int duration;
+    int error;
+  };
+
   bool verifyIdIndex();
   bool verifyTrackIndex();
   void processNextStep();
   void processNextTrack();
+  void lookupFingerprint();
 
-  FingerprintCalculator* m_fingerprintCalculator;
+  FingerprintCalculatorPool* m_fingerprintPool;
   State m_state;
   QVector<QString> m_filenameOfTrack;
+  QVector<Fingerprint> m_fingerprintOfTrack;
   QVector<QStringList> m_idsOfTrack;
   int m_currentIndex;
   ImportTrackDataVector m_currentTrackData;
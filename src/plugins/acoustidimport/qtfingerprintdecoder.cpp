@@ -110,7 +110,7 @@ void QtFingerprintDecoder::receiveBuffer()
   if (!buffer.isValid()) {
     return;
   }
-  if (buffer.startTime() > 120000000LL) {
+  if (buffer.startTime() >= maxLength() * 1000000LL) {
     finishDecoding();
     return;
   }
@@ -160,3 +160,13 @@ AbstractFingerprintDecoder*
 AbstractFingerprintDecoder::createFingerprintDecoder(QObject* parent) {
   return new QtFingerprintDecoder(parent);
 }
+
+/**
+ * Check if decoders created by createFingerprintDecoder() can run in
+ * worker threads, so that multiple files can be decoded concurrently.
+ * @return true if decoders can be moved to other threads.
+ */
+bool AbstractFingerprintDecoder::canRunInThread() {
+  // QAudioDecoder is already asynchronous.
+  return false;
+}
@@ -45,6 +45,7 @@
 #include "id3libconfig.h"
 #include "genres.h"
 #include "attributedata.h"
+#include "performancestatistics.h"
 
 #ifdef Q_OS_WIN32
 /**
@@ -128,6 +129,7 @@ int Mp3File::taggedFileFeatures() const
  */
 void Mp3File::readTags(bool force)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::ReadTags);
   bool priorIsTagInformationRead = isTagInformationRead();
   QByteArray fn = QFile::encodeName(currentFilePath());
 
@@ -173,6 +175,7 @@ void Mp3File::readTags(bool force)
  */
 bool Mp3File::writeTags(bool force, bool* renamed, bool preserve)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::WriteTags);
   QString fnStr(currentFilePath());
   if (isChanged() && !QFileInfo(fnStr).isWritable()) {
     revertChangedFilename();
@@ -40,6 +40,7 @@
 #include <cstring>
 #include "genres.h"
 #include "pictureframe.h"
+#include "performancestatistics.h"
 
 /** MPEG4IP version as 16-bit hex number with major and minor version. */
 #if defined MP4V2_PROJECT_version_major && defined MP4V2_PROJECT_version_minor
@@ -525,6 +526,7 @@ QString M4aFile::taggedFileKey() const
  */
 void M4aFile::readTags(bool force)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::ReadTags);
   bool priorIsTagInformationRead = isTagInformationRead();
   if (force || !m_fileRead) {
     m_metadata.clear();
@@ -727,6 +729,7 @@ void M4aFile::readTags(bool force)
  */
 bool M4aFile::writeTags(bool force, bool* renamed, bool preserve)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::WriteTags);
   bool ok = true;
   QString fnStr(currentFilePath());
   if (isChanged() && !QFileInfo(fnStr).isWritable()) {
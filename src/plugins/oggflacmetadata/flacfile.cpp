@@ -28,6 +28,7 @@
 
 #include "genres.h"
 #include "pictureframe.h"
+#include "performancestatistics.h"
 #include <FLAC++/metadata.h>
 #include <QFile>
 #include <QDir>
@@ -144,6 +145,7 @@ QString FlacFile::taggedFileKey() const
  */
 void FlacFile::readTags(bool force)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::ReadTags);
   bool priorIsTagInformationRead = isTagInformationRead();
   if (force || !m_fileRead) {
     m_comments.clear();
@@ -240,6 +242,7 @@ void FlacFile::readTags(bool force)
  */
 bool FlacFile::writeTags(bool force, bool* renamed, bool preserve)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::WriteTags);
   if (isChanged() &&
     !QFileInfo(currentFilePath()).isWritable()) {
     revertChangedFilename();
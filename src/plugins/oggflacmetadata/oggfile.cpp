@@ -36,6 +36,7 @@
 #include "vcedit.h"
 #endif
 #include "pictureframe.h"
+#include "performancestatistics.h"
 #include "tagconfig.h"
 #include "taggedfilesystemmodel.h"
 
@@ -156,6 +157,16 @@ QString OggFile::taggedFileKey() const
   return QLatin1String("OggMetadata");
 }
 
+/**
+ * Check if readTags() can be called from a worker thread.
+ * libvorbis and libFLAC only use the state passed to them.
+ * @return true.
+ */
+bool OggFile::isReadTagsReentrant() const
+{
+  return true;
+}
+
 #ifdef HAVE_VORBIS
 /**
  * Get features supported.
@@ -173,6 +184,7 @@ int OggFile::taggedFileFeatures() const
  */
 void OggFile::readTags(bool force)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::ReadTags);
   bool priorIsTagInformationRead = isTagInformationRead();
   if (force || !m_fileRead) {
     m_comments.clear();
@@ -229,6 +241,7 @@ void OggFile::readTags(bool force)
  */
 bool OggFile::writeTags(bool force, bool* renamed, bool preserve)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::WriteTags);
   QString dirname = getDirname();
   if (isChanged() &&
     !QFileInfo(currentFilePath()).isWritable()) {
@@ -237,6 +250,32 @@ bool OggFile::writeTags(bool force, bool* renamed, bool preserve)
   }
 
   if (m_fileRead && (force || isTagChanged(Frame::Tag_2))) {
+    // Try to replace the comment header in the existing file, which avoids
+    // copying the audio data.
+    const QString fn = currentFilePath();
+    quint64 actime = 0, modtime = 0;
+    if (preserve) {
+      getFileTimeStamps(fn, actime, modtime);
+    }
+    const InPlaceResult inPlaceResult = writeCommentsInPlace(fn);
+    if (inPlaceResult == InPlaceFailed) {
+      return false;
+    }
+    if (inPlaceResult == InPlaceWritten) {
+      if (actime || modtime) {
+        setFileTimeStamps(fn, actime, modtime);
+      }
+      markTagUnchanged(Frame::Tag_2);
+      if (isFilenameChanged()) {
+        if (!renameFile()) {
+          return false;
+        }
+        markFilenameUnchanged();
+        *renamed = true;
+      }
+      return true;
+    }
+
     bool writeOk = false;
     // we have to rename the original file and delete it afterwards
     const QString filename = currentFilename();
@@ -328,6 +367,194 @@ bool OggFile::writeTags(bool force, bool* renamed, bool preserve)
   return true;
 }
 
+/**
+ * Replace the comment header of an Ogg/Vorbis file without copying the
+ * file. This is only possible if the new comment packet fits into the
+ * space of the existing packet including its padding, so that the pages
+ * keep their layout and only their checksums have to be updated.
+ * Comments with empty values are removed from m_comments.
+ *
+ * If writing fails after the file has been modified, the original pages
+ * are restored. As this could fail too, the file must then not be used
+ * as the source of a full copy.
+ *
+ * @param fn file name
+ *
+ * @return InPlaceWritten if the comments were written, InPlaceNotPossible
+ * if the file is unchanged and has to be rewritten, InPlaceFailed if
+ * writing failed.
+ */
+OggFile::InPlaceResult OggFile::writeCommentsInPlace(const QString& fn)
+{
+  // Build the new comment packet, the fields are little endian and byte
+  // aligned as written by libvorbis.
+  auto appendUInt32 = [](QByteArray& ba, quint32 value) {
+    for (int i = 0; i < 4; ++i) {
+      ba.append(static_cast<char>((value >> (8 * i)) & 0xff));
+    }
+  };
+  QByteArray fields;
+  quint32 numFields = 0;
+  auto it = m_comments.begin(); // clazy:exclude=detaching-member
+  while (it != m_comments.end()) {
+    QString name = fixUpTagKey(it->getName(), TT_Vorbis);
+    if (QString value(it->getValue()); !value.isEmpty()) {
+      QByteArray field = name.toLatin1() + '=' + value.toUtf8();
+      appendUInt32(fields, field.size());
+      fields.append(field);
+      ++numFields;
+      ++it;
+    } else {
+      it = m_comments.erase(it);
+    }
+  }
+
+  QFile file(fn);
+  if (!file.open(QIODevice::ReadWrite)) {
+    return InPlaceNotPossible;
+  }
+
+  // Read the pages containing the identification, comment and setup
+  // headers. Only a single logical stream is supported.
+  struct Page {
+    qint64 offset;
+    QByteArray header;
+    QByteArray body;
+    bool modified;
+  };
+  struct Segment {
+    int pageIndex;
+    int start;
+    int length;
+  };
+  QList<Page> pages;
+  QList<Segment> commentSegments;
+  int packetNr = 0;
+  quint32 serial = 0;
+  while (packetNr < 3) {
+    Page page;
+    page.offset = file.pos();
+    page.header = file.read(27);
+    if (page.header.size() != 27 || !page.header.startsWith("OggS") ||
+        page.header.at(4) != 0 || pages.size() >= 256) {
+      return InPlaceNotPossible;
+    }
+    const auto hdr = reinterpret_cast<const uchar*>(page.header.constData());
+    const quint32 pageSerial = hdr[14] | (hdr[15] << 8) | (hdr[16] << 16) |
+        (static_cast<quint32>(hdr[17]) << 24);
+    const bool bos = (hdr[5] & 0x02) != 0;
+    if (pages.isEmpty()) {
+      if (!bos) {
+        return InPlaceNotPossible;
+      }
+      serial = pageSerial;
+    } else if (bos || pageSerial != serial) {
+      return InPlaceNotPossible;
+    }
+    const int numSegments = hdr[26];
+    const QByteArray lacing = file.read(numSegments);
+    if (lacing.size() != numSegments) {
+      return InPlaceNotPossible;
+    }
+    page.header.append(lacing);
+    int bodyLength = 0;
+    for (char lacingValue : lacing) {
+      bodyLength += static_cast<uchar>(lacingValue);
+    }
+    page.body = file.read(bodyLength);
+    if (page.body.size() != bodyLength) {
+      return InPlaceNotPossible;
+    }
+    page.modified = false;
+
+    int start = 0;
+    for (int i = 0; i < numSegments && packetNr < 3; ++i) {
+      const int length = static_cast<uchar>(lacing.at(i));
+      if (packetNr == 1 && length > 0) {
+        if (!commentSegments.isEmpty() &&
+            commentSegments.last().pageIndex == pages.size() &&
+            commentSegments.last().start + commentSegments.last().length ==
+            start) {
+          commentSegments.last().length += length;
+        } else {
+          commentSegments.append({static_cast<int>(pages.size()), start,
+                                  length});
+        }
+      }
+      start += length;
+      if (length < 255) {
+        ++packetNr;
+      }
+    }
+    pages.append(page);
+  }
+
+  QByteArray oldPacket;
+  for (const Segment& segment : std::as_const(commentSegments)) {
+    oldPacket.append(pages.at(segment.pageIndex).body.mid(segment.start,
+                                                          segment.length));
+  }
+  if (oldPacket.size() < 11 || !oldPacket.startsWith("\x03vorbis")) {
+    return InPlaceNotPossible;
+  }
+  const auto oldData = reinterpret_cast<const uchar*>(oldPacket.constData());
+  const quint32 vendorLength = oldData[7] | (oldData[8] << 8) |
+      (oldData[9] << 16) | (static_cast<quint32>(oldData[10]) << 24);
+  if (vendorLength > static_cast<quint32>(oldPacket.size() - 11)) {
+    return InPlaceNotPossible;
+  }
+
+  QByteArray packet("\x03vorbis", 7);
+  appendUInt32(packet, vendorLength);
+  packet.append(oldPacket.mid(11, vendorLength));
+  appendUInt32(packet, numFields);
+  packet.append(fields);
+  packet.append('\x01'); // framing bit
+  if (packet.size() > oldPacket.size()) {
+    return InPlaceNotPossible;
+  }
+  // Keep the remaining space as padding after the framing bit.
+  packet.append(QByteArray(oldPacket.size() - packet.size(), '\0'));
+
+  // Keep the original pages to restore them if writing fails.
+  QList<Page> originalPages = pages;
+  int packetPos = 0;
+  for (const Segment& segment : std::as_const(commentSegments)) {
+    originalPages[segment.pageIndex].modified = true;
+    Page& page = pages[segment.pageIndex];
+    page.body.replace(segment.start, segment.length,
+                      packet.mid(packetPos, segment.length));
+    page.modified = true;
+    packetPos += segment.length;
+  }
+  for (Page& page : pages) {
+    if (page.modified) {
+      ogg_page og;
+      og.header = reinterpret_cast<unsigned char*>(page.header.data());
+      og.header_len = page.header.size();
+      og.body = reinterpret_cast<unsigned char*>(page.body.data());
+      og.body_len = page.body.size();
+      ::ogg_page_checksum_set(&og);
+    }
+  }
+  auto writePages = [&file](const QList<Page>& pagesToWrite) {
+    for (const Page& page : pagesToWrite) {
+      if (page.modified &&
+          (!file.seek(page.offset) ||
+           file.write(page.header) != page.header.size() ||
+           file.write(page.body) != page.body.size())) {
+        return false;
+      }
+    }
+    return file.flush();
+  };
+  if (!writePages(pages)) {
+    writePages(originalPages);
+    return InPlaceFailed;
+  }
+  return InPlaceWritten;
+}
+
 /**
  * Free resources allocated when calling readTags().
  *
@@ -434,16 +661,16 @@ const char* getVorbisNameFromType(Frame::Type type)
  */
 Frame::Type getTypeFromVorbisName(QString name)
 {
-  static QMap<QString, int> strNumMap;
-  if (strNumMap.empty()) {
-    // first time initialization
+  static const QMap<QString, int> strNumMap = [] {
+    QMap<QString, int> map;
     for (int i = 0; i < Frame::FT_Custom1; ++i) {
       auto type = static_cast<Frame::Type>(i);
-      strNumMap.insert(QString::fromLatin1(getVorbisNameFromType(type)), type);
+      map.insert(QString::fromLatin1(getVorbisNameFromType(type)), type);
     }
-    strNumMap.insert(QLatin1String("COVERART"), Frame::FT_Picture);
-    strNumMap.insert(QLatin1String("METADATA_BLOCK_PICTURE"), Frame::FT_Picture);
-  }
+    map.insert(QLatin1String("COVERART"), Frame::FT_Picture);
+    map.insert(QLatin1String("METADATA_BLOCK_PICTURE"), Frame::FT_Picture);
+    return map;
+  }();
   if (auto it = strNumMap.constFind(name.remove(QLatin1Char('=')).toUpper());
       it != strNumMap.constEnd()) {
     return static_cast<Frame::Type>(*it);
@@ -65,6 +65,12 @@ public:
    */
   void readTags(bool force) override;
 
+  /**
+   * Check if readTags() can be called from a worker thread.
+   * @return true.
+   */
+  bool isReadTagsReentrant() const override;
+
   /**
    * Write tags to file and rename it if necessary.
    *
@@ -298,6 +304,13 @@ private:
   OggFile& operator=(const OggFile&);
 
 #ifdef HAVE_VORBIS
+  /** Result of writeCommentsInPlace(). */
+  enum InPlaceResult {
+    InPlaceWritten,     /**< comments written */
+    InPlaceNotPossible, /**< nothing written, file has to be rewritten */
+    InPlaceFailed       /**< writing failed, file must not be copied */
+  };
+
   /**
    * Read information about an Ogg/Vorbis file.
    * @param info file info to fill
@@ -305,5 +318,24 @@ private:
    * @return true if ok.
    */
   bool readFileInfo(FileInfo& info, const QString& fn) const;
+
+  /**
+   * Replace the comment header of an Ogg/Vorbis file without copying the
+   * file. This is only possible if the new comment packet fits into the
+   * space of the existing packet including its padding, so that the pages
+   * keep their layout and only their checksums have to be updated.
+   * Comments with empty values are removed from m_comments.
+   *
+   * If writing fails after the file has been modified, the original pages
+   * are restored. As this could fail too, the file must then not be used
+   * as the source of a full copy.
+   *
+   * @param fn file name
+   *
+   * @return InPlaceWritten if the comments were written, InPlaceNotPossible
+   * if the file is unchanged and has to be rewritten, InPlaceFailed if
+   * writing failed.
+   */
+  InPlaceResult writeCommentsInPlace(const QString& fn);
 #endif // HAVE_VORBIS
 };
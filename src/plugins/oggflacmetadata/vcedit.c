@@ -65,6 +65,8 @@ typedef struct vcedit_buffer_chain {
 
 #define CHUNKSIZE 4096
 #define BUFFERCHUNK CHUNKSIZE
+/* kid3 */
+#define COMMENT_PADDING 1024
 
 /* Helper function, shouldn't need to call directly */
 static int page_buffer_push(vcedit_buffer_chain *bufferlink, ogg_page *og) {
@@ -396,10 +398,13 @@ static int _commentheader_out(vorbis_comment *vc, char *vendor, ogg_packet *op)
 	}
 	oggpack_write(&opb,1,1);
 
-	op->packet = malloc(oggpack_bytes(&opb));
+	/* kid3: append padding, so that the comments can be changed later
+	   without rewriting the file, see OggFile::writeCommentsInPlace() */
+	op->packet = malloc(oggpack_bytes(&opb) + COMMENT_PADDING);
 	memcpy(op->packet, opb.buffer, oggpack_bytes(&opb));
+	memset(op->packet + oggpack_bytes(&opb), 0, COMMENT_PADDING);
 
-	op->bytes=oggpack_bytes(&opb);
+	op->bytes=oggpack_bytes(&opb) + COMMENT_PADDING;
 	op->b_o_s=0;
 	op->e_o_s=0;
 	op->granulepos=0;
@@ -26,6 +26,8 @@
 
 #include "taglibfile.h"
 #include <QDir>
+#include <QFile>
+#include <QFileInfo>
 #include <QString>
 #if QT_VERSION >= 0x060000
 #include <QStringConverter>
@@ -36,9 +38,14 @@
 #include <QVarLengthArray>
 #include <QScopedPointer>
 #include <QMimeDatabase>
+#include <QMutex>
+#include <QThread>
+#include <QAtomicInteger>
+#include <QCryptographicHash>
 #include "genres.h"
 #include "attributedata.h"
 #include "pictureframe.h"
+#include "performancestatistics.h"
 
 // Just using include <oggfile.h>, include <flacfile.h> as recommended in the
 // TagLib documentation does not work, as there are files with these names
@@ -291,6 +298,12 @@ void WavFile::changeToLowercaseId3Chunk()
  * Using streams, closing the file descriptor is also possible for modified
  * files because the TagLib file does not have to be deleted just to close the
  * file descriptor.
+ *
+ * While the tags are parsed, the file is mapped into memory and blocks
+ * are read from the mapping without system calls. The mapping is released
+ * with disableMapping() when parsing is finished, so that a file truncated
+ * by another program cannot cause a SIGBUS while the handle is kept open.
+ * Later accesses and all write operations use a TagLib::FileStream.
  */
 class FileIOStream : public TagLib::IOStream {
 public:
@@ -314,6 +327,12 @@ public:
    */
   void closeFileHandle();
 
+  /**
+   * Stop using a memory mapping, the mapping is released if it exists.
+   * All further accesses use a TagLib::FileStream.
+   */
+  void disableMapping();
+
   /**
    * Change the file name.
    * Can be used to modify the file name when it has changed because a path
@@ -374,6 +393,22 @@ public:
    */
   static TagLib::File* create(IOStream* stream);
 
+  /**
+   * Set the maximum number of file handles kept open.
+   * If more files are opened, the least recently used files are closed.
+   * @param maxOpenFiles maximum number of open files
+   */
+  static void setMaximumOpenFiles(int maxOpenFiles);
+
+  /**
+   * Get statistics about the usage of file handles.
+   * @return map with number of "openFiles", "maximumOpenFiles", "hits"
+   * (accesses with open handle), "opens" (first opens), "reopens" (opens
+   * after the handle has been closed) and "evictions" (closed because the
+   * maximum was exceeded).
+   */
+  static QVariantMap statistics();
+
 private:
   /**
    * Open file handle, is called by operations which need a file handle.
@@ -382,6 +417,21 @@ private:
    */
   bool openFileHandle() const;
 
+  /**
+   * Open file handle for writing, a mapped file is replaced by a
+   * TagLib::FileStream.
+   *
+   * @return true if file is open.
+   */
+  bool openFileStream();
+
+  /**
+   * Map the file into memory.
+   *
+   * @return true if the file is mapped, false if it cannot be mapped.
+   */
+  bool openMappedFile();
+
   /**
    * Create a TagLib file for a stream.
    * @param stream stream with name() of which the extension is used to deduce
@@ -408,7 +458,8 @@ private:
 
   /**
    * Register open files, so that the number of open files can be limited.
-   * If the number of open files exceeds a limit, files are closed.
+   * If the number of open files exceeds a limit, the least recently used
+   * files are closed.
    *
    * @param stream new open file to be registered
    */
@@ -421,22 +472,85 @@ private:
    */
   static void deregisterOpenFile(FileIOStream* stream);
 
+  /**
+   * Remove stream from LRU list of open files.
+   * Must be called with s_openFilesMutex locked.
+   * @param stream registered open file
+   */
+  static void unlinkOpenFile(FileIOStream* stream);
+
+  /**
+   * Insert stream as most recently used into LRU list of open files.
+   * Must be called with s_openFilesMutex locked.
+   * @param stream open file which is not in the list
+   */
+  static void linkOpenFile(FileIOStream* stream);
+
 #ifdef Q_OS_WIN32
   wchar_t* m_fileName;
 #else
   char* m_fileName;
 #endif
   TagLib::FileStream* m_fileStream;
+  /** file mapped into memory, used instead of m_fileStream for reading */
+  QFile* m_mappedFile;
+  const uchar* m_mappedData;
+  qint64 m_mappedSize;
+  qint64 m_mappedPos;
+  bool m_mappedReadOnly;
+  /**
+   * true if the mapping must not be used, set when parsing is finished or
+   * a write operation has been requested
+   */
+  bool m_mappingDisabled;
   long m_offset;
-
-  /** list of file streams with open file descriptor */
-  static QList<FileIOStream*> s_openFiles;
+  /** thread which opened the file handle */
+  Qt::HANDLE m_threadId;
+  /** previous (more recently used) open file in LRU list */
+  FileIOStream* m_lruPrev;
+  /** next (less recently used) open file in LRU list */
+  FileIOStream* m_lruNext;
+  /** true if stream is in LRU list */
+  bool m_registered;
+  /** true if file handle has been opened before */
+  bool m_openedBefore;
+
+  /** most recently used file stream with open file descriptor */
+  static FileIOStream* s_lruFirst;
+  /** least recently used file stream with open file descriptor */
+  static FileIOStream* s_lruLast;
+  /** number of file streams in LRU list */
+  static int s_numOpenFiles;
+  /** maximum number of open files */
+  static int s_maxOpenFiles;
+  /** number of closed files because of s_maxOpenFiles */
+  static quint64 s_numEvictions;
+  /** number of files opened for the first time */
+  static quint64 s_numOpens;
+  /** number of files opened again after they have been closed */
+  static quint64 s_numReopens;
+  /** protects LRU list and counters, files are read from worker threads */
+  static QMutex s_openFilesMutex;
+  /** number of accesses to already open file handles */
+  static QAtomicInteger<quint64> s_numHits;
 };
 
-QList<FileIOStream*> FileIOStream::s_openFiles;
+FileIOStream* FileIOStream::s_lruFirst = nullptr;
+FileIOStream* FileIOStream::s_lruLast = nullptr;
+int FileIOStream::s_numOpenFiles = 0;
+int FileIOStream::s_maxOpenFiles = 20;
+quint64 FileIOStream::s_numEvictions = 0;
+quint64 FileIOStream::s_numOpens = 0;
+quint64 FileIOStream::s_numReopens = 0;
+QMutex FileIOStream::s_openFilesMutex;
+QAtomicInteger<quint64> FileIOStream::s_numHits;
 
 FileIOStream::FileIOStream(const QString& fileName)
-  : m_fileName(nullptr), m_fileStream(nullptr), m_offset(0)
+  : m_fileName(nullptr), m_fileStream(nullptr), m_mappedFile(nullptr),
+    m_mappedData(nullptr), m_mappedSize(0), m_mappedPos(0),
+    m_mappedReadOnly(true), m_mappingDisabled(false), m_offset(0),
+    m_threadId(nullptr), m_lruPrev(nullptr), m_lruNext(nullptr),
+    m_registered(false), m_openedBefore(false)
 {
   setName(fileName);
 }
@@ -445,13 +559,18 @@ FileIOStream::~FileIOStream()
 {
   deregisterOpenFile(this);
   delete m_fileStream;
+  delete m_mappedFile;
   delete [] m_fileName;
 }
 
 bool FileIOStream::openFileHandle() const
 {
-  if (!m_fileStream) {
+  if (!m_fileStream && !m_mappedFile) {
     auto self = const_cast<FileIOStream*>(this);
+    if (!m_mappingDisabled && self->openMappedFile()) {
+      registerOpenFile(self);
+      return true;
+    }
     self->m_fileStream =
         new TagLib::FileStream(TagLib::FileName(m_fileName));
     if (!self->m_fileStream->isOpen()) {
@@ -463,10 +582,49 @@ bool FileIOStream::openFileHandle() const
       m_fileStream->seek(m_offset);
     }
     registerOpenFile(self);
+  } else {
+    // The position in the LRU list is only updated when the file is opened,
+    // so that reads and seeks do not have to lock s_openFilesMutex.
+    s_numHits.fetchAndAddRelaxed(1);
   }
   return true;
 }
 
+bool FileIOStream::openFileStream()
+{
+  if (m_mappedFile) {
+    // Writing is not possible using the mapping, continue with a file
+    // stream at the same position.
+    closeFileHandle();
+  }
+  m_mappingDisabled = true;
+  return openFileHandle();
+}
+
+bool FileIOStream::openMappedFile()
+{
+#ifdef Q_OS_WIN32
+  const QString fileName = QString::fromWCharArray(m_fileName);
+#else
+  const QString fileName = QFile::decodeName(m_fileName);
+#endif
+  auto file = new QFile(fileName);
+  if (file->open(QIODevice::ReadOnly)) {
+    if (qint64 size = file->size(); size > 0) {
+      if (uchar* data = file->map(0, size)) {
+        m_mappedFile = file;
+        m_mappedData = data;
+        m_mappedSize = size;
+        m_mappedPos = qBound<qint64>(0, m_offset, size);
+        m_mappedReadOnly = !QFileInfo(fileName).isWritable();
+        return true;
+      }
+    }
+  }
+  delete file;
+  return false;
+}
+
 void FileIOStream::closeFileHandle()
 {
   if (m_fileStream) {
@@ -474,7 +632,24 @@ void FileIOStream::closeFileHandle()
     delete m_fileStream;
     m_fileStream = nullptr;
     deregisterOpenFile(this);
+  } else if (m_mappedFile) {
+    m_offset = static_cast<long>(m_mappedPos);
+    // The mapping is released when the file is deleted.
+    delete m_mappedFile;
+    m_mappedFile = nullptr;
+    m_mappedData = nullptr;
+    m_mappedSize = 0;
+    m_mappedPos = 0;
+    deregisterOpenFile(this);
+  }
+}
+
+void FileIOStream::disableMapping()
+{
+  if (m_mappedFile) {
+    closeFileHandle();
   }
+  m_mappingDisabled = true;
 }
 
 void FileIOStream::setName(const QString& fileName)
@@ -509,6 +684,18 @@ TagLib::ByteVector FileIOStream::readBlock(
 )
 {
   if (openFileHandle()) {
+    if (m_mappedFile) {
+      if (m_mappedPos >= m_mappedSize || length == 0) {
+        return TagLib::ByteVector();
+      }
+      const qint64 len = qMin(static_cast<qint64>(length),
+                              m_mappedSize - m_mappedPos);
+      TagLib::ByteVector bv(
+            reinterpret_cast<const char*>(m_mappedData + m_mappedPos),
+            static_cast<unsigned int>(len));
+      m_mappedPos += len;
+      return bv;
+    }
     return m_fileStream->readBlock(length);
   }
   return TagLib::ByteVector();
@@ -516,7 +703,7 @@ TagLib::ByteVector FileIOStream::readBlock(
 
 void FileIOStream::writeBlock(const TagLib::ByteVector &data)
 {
-  if (openFileHandle()) {
+  if (openFileStream()) {
     m_fileStream->writeBlock(data);
   }
 }
@@ -530,7 +717,7 @@ void FileIOStream::insert(const TagLib::ByteVector &data,
 #endif
 )
 {
-  if (openFileHandle()) {
+  if (openFileStream()) {
     m_fileStream->insert(data, start, replace);
   }
 }
@@ -543,7 +730,7 @@ void FileIOStream::removeBlock(taglib_uoffset_t start,
 #endif
 )
 {
-  if (openFileHandle()) {
+  if (openFileStream()) {
     m_fileStream->removeBlock(start, length);
   }
 }
@@ -551,6 +738,9 @@ void FileIOStream::removeBlock(taglib_uoffset_t start,
 bool FileIOStream::readOnly() const
 {
   if (openFileHandle()) {
+    if (m_mappedFile) {
+      return m_mappedReadOnly;
+    }
     return m_fileStream->readOnly();
   }
   return true;
@@ -567,13 +757,23 @@ bool FileIOStream::isOpen() const
 void FileIOStream::seek(taglib_offset_t offset, Position p)
 {
   if (openFileHandle()) {
+    if (m_mappedFile) {
+      qint64 pos = offset;
+      if (p == Current) {
+        pos += m_mappedPos;
+      } else if (p == End) {
+        pos += m_mappedSize;
+      }
+      m_mappedPos = qMax<qint64>(pos, 0);
+      return;
+    }
     m_fileStream->seek(offset, p);
   }
 }
 
 void FileIOStream::clear()
 {
-  if (openFileHandle()) {
+  if (openFileHandle() && m_fileStream) {
     m_fileStream->clear();
   }
 }
@@ -581,6 +781,9 @@ void FileIOStream::clear()
 taglib_offset_t FileIOStream::tell() const
 {
   if (openFileHandle()) {
+    if (m_mappedFile) {
+      return static_cast<taglib_offset_t>(m_mappedPos);
+    }
     return m_fileStream->tell();
   }
   return 0;
@@ -589,6 +792,9 @@ taglib_offset_t FileIOStream::tell() const
 taglib_offset_t FileIOStream::length()
 {
   if (openFileHandle()) {
+    if (m_mappedFile) {
+      return static_cast<taglib_offset_t>(m_mappedSize);
+    }
     return m_fileStream->length();
   }
   return 0;
@@ -596,7 +802,7 @@ taglib_offset_t FileIOStream::length()
 
 void FileIOStream::truncate(taglib_offset_t length)
 {
-  if (openFileHandle()) {
+  if (openFileStream()) {
     m_fileStream->truncate(length);
   }
 }
@@ -733,13 +939,14 @@ TagLib::File* FileIOStream::createFromContents(TagLib::IOStream* stream)
     { "video/mp4", "MP4" }
 };
 
-  static QMap<QString, TagLib::String> mimeExtMap;
-  if (mimeExtMap.empty()) {
-    // first time initialization
+  // Initialized in a thread-safe way, files are also read in worker threads.
+  static const QMap<QString, TagLib::String> mimeExtMap = [] {
+    QMap<QString, TagLib::String> map;
     for (const auto& [mime, ext] : extensionForMimeType) {
-      mimeExtMap.insert(QString::fromLatin1(mime), ext);
+      map.insert(QString::fromLatin1(mime), ext);
     }
-  }
+    return map;
+  }();
 
   stream->seek(0);
   TagLib::ByteVector bv = stream->readBlock(4096);
@@ -755,19 +962,37 @@ TagLib::File* FileIOStream::createFromContents(TagLib::IOStream* stream)
 
 void FileIOStream::registerOpenFile(FileIOStream* stream)
 {
-  if (s_openFiles.contains(stream))
-    return;
+  QVarLengthArray<FileIOStream*, 8> filesToClose;
+  {
+    QMutexLocker locker(&s_openFilesMutex);
+    if (stream->m_registered)
+      return;
 
-  if (int numberOfFilesToClose = s_openFiles.size() - 15;
-      numberOfFilesToClose > 5) {
-    for (auto it = s_openFiles.begin(); it != s_openFiles.end(); ++it) { // clazy:exclude=detaching-member
-      (*it)->closeFileHandle();
-      if (--numberOfFilesToClose <= 0) {
-        break;
+    if (stream->m_openedBefore) {
+      ++s_numReopens;
+    } else {
+      stream->m_openedBefore = true;
+      ++s_numOpens;
+    }
+    stream->m_threadId = QThread::currentThreadId();
+    // Close the least recently used files, files opened by another thread
+    // could be in use right now.
+    int numberOfFilesToClose = s_numOpenFiles + 1 - s_maxOpenFiles;
+    for (FileIOStream* openFile = s_lruLast;
+         openFile && numberOfFilesToClose > 0;
+         openFile = openFile->m_lruPrev) {
+      if (openFile->m_threadId == stream->m_threadId) {
+        filesToClose.append(openFile);
+        --numberOfFilesToClose;
       }
     }
+    s_numEvictions += filesToClose.size();
+    linkOpenFile(stream);
+  }
+  // Closing deregisters the files, so this must be done without the lock.
+  for (FileIOStream* openFile : std::as_const(filesToClose)) {
+    openFile->closeFileHandle();
   }
-  s_openFiles.append(stream);
 }
 
 /**
@@ -777,7 +1002,83 @@ void FileIOStream::registerOpenFile(FileIOStream* stream)
  */
 void FileIOStream::deregisterOpenFile(FileIOStream* stream)
 {
-  s_openFiles.removeAll(stream);
+  QMutexLocker locker(&s_openFilesMutex);
+  if (stream->m_registered) {
+    unlinkOpenFile(stream);
+  }
+}
+
+/**
+ * Remove stream from LRU list of open files.
+ * Must be called with s_openFilesMutex locked.
+ * @param stream registered open file
+ */
+void FileIOStream::unlinkOpenFile(FileIOStream* stream)
+{
+  if (stream->m_lruPrev) {
+    stream->m_lruPrev->m_lruNext = stream->m_lruNext;
+  } else {
+    s_lruFirst = stream->m_lruNext;
+  }
+  if (stream->m_lruNext) {
+    stream->m_lruNext->m_lruPrev = stream->m_lruPrev;
+  } else {
+    s_lruLast = stream->m_lruPrev;
+  }
+  stream->m_lruPrev = nullptr;
+  stream->m_lruNext = nullptr;
+  stream->m_registered = false;
+  --s_numOpenFiles;
+}
+
+/**
+ * Insert stream as most recently used into LRU list of open files.
+ * Must be called with s_openFilesMutex locked.
+ * @param stream open file which is not in the list
+ */
+void FileIOStream::linkOpenFile(FileIOStream* stream)
+{
+  stream->m_lruPrev = nullptr;
+  stream->m_lruNext = s_lruFirst;
+  if (s_lruFirst) {
+    s_lruFirst->m_lruPrev = stream;
+  } else {
+    s_lruLast = stream;
+  }
+  s_lruFirst = stream;
+  stream->m_registered = true;
+  ++s_numOpenFiles;
+}
+
+/**
+ * Set the maximum number of file handles kept open.
+ * If more files are opened, the least recently used files are closed.
+ * @param maxOpenFiles maximum number of open files
+ */
+void FileIOStream::setMaximumOpenFiles(int maxOpenFiles)
+{
+  QMutexLocker locker(&s_openFilesMutex);
+  s_maxOpenFiles = qMax(maxOpenFiles, 1);
+}
+
+/**
+ * Get statistics about the usage of file handles.
+ * @return map with number of "openFiles", "maximumOpenFiles", "hits"
+ * (accesses with open handle), "opens" (first opens), "reopens" (opens
+ * after the handle has been closed) and "evictions" (closed because the
+ * maximum was exceeded).
+ */
+QVariantMap FileIOStream::statistics()
+{
+  QMutexLocker locker(&s_openFilesMutex);
+  return {
+    {QLatin1String("openFiles"), s_numOpenFiles},
+    {QLatin1String("maximumOpenFiles"), s_maxOpenFiles},
+    {QLatin1String("hits"), s_numHits.loadRelaxed()},
+    {QLatin1String("opens"), s_numOpens},
+    {QLatin1String("reopens"), s_numReopens},
+    {QLatin1String("evictions"), s_numEvictions}
+  };
 }
 
 namespace {
@@ -820,6 +1121,7 @@ public:
    * @param encodingName encoding, empty for default behavior (ISO 8859-1)
    */
   static void setStringDecoder(const QString& encodingName) {
+    QMutexLocker locker(&s_mutex);
     if (auto encoding = QStringConverter::encodingForName(encodingName.toLatin1())) {
       s_encoder = QStringEncoder(*encoding);
       s_decoder = QStringDecoder(*encoding);
@@ -840,6 +1142,7 @@ private:
 #if QT_VERSION >= 0x060000
   static QStringDecoder s_decoder;
   static QStringEncoder s_encoder;
+  static QMutex s_mutex;
 #else
   static const QTextCodec* s_codec;
 #endif
@@ -848,6 +1151,7 @@ private:
 #if QT_VERSION >= 0x060000
 QStringDecoder TextCodecStringHandler::s_decoder;
 QStringEncoder TextCodecStringHandler::s_encoder;
+QMutex TextCodecStringHandler::s_mutex;
 #else
 const QTextCodec* TextCodecStringHandler::s_codec = nullptr;
 #endif
@@ -860,6 +1164,8 @@ const QTextCodec* TextCodecStringHandler::s_codec = nullptr;
 TagLib::String TextCodecStringHandler::parse(const TagLib::ByteVector& data) const
 {
 #if QT_VERSION >= 0x060000
+  // The decoder is stateful and ID3v1 tags are also parsed in worker threads.
+  QMutexLocker locker(&s_mutex);
   return s_decoder.isValid()
       ? toTString(s_decoder(QByteArray(data.data(), data.size()))).stripWhiteSpace()
       : TagLib::String(data, TagLib::String::Latin1).stripWhiteSpace();
@@ -878,6 +1184,7 @@ TagLib::String TextCodecStringHandler::parse(const TagLib::ByteVector& data) con
 TagLib::ByteVector TextCodecStringHandler::render(const TagLib::String& s) const
 {
 #if QT_VERSION >= 0x060000
+  QMutexLocker locker(&s_mutex);
   if (s_encoder.isValid()) {
     QByteArray ba = s_encoder(toQString(s));
     return TagLib::ByteVector(ba.data(), ba.size());
@@ -985,6 +1292,8 @@ void TagLibFile::clearTags(bool force)
 
   bool priorIsTagInformationRead = isTagInformationRead();
   closeFile(true);
+  m_cacheEntry.reset();
+  clearCachedFrames();
   m_pictures.clear();
   m_pictures.setRead(false);
   m_tagInformationRead = false;
@@ -999,15 +1308,188 @@ void TagLibFile::clearTags(bool force)
   notifyModelDataChanged(priorIsTagInformationRead);
 }
 
+/**
+ * Check if readTags() can be called from a worker thread.
+ * TagLib files are independent of each other, the shared state of the
+ * file streams and the ID3v1 string handler is protected.
+ * @return true.
+ */
+bool TagLibFile::isReadTagsReentrant() const
+{
+  return true;
+}
+
+/**
+ * Check if writeTags() can be called from a worker thread.
+ * Without renaming, writing only uses the state of this file and the
+ * protected shared state also used by readTags().
+ * @return true.
+ */
+bool TagLibFile::isWriteTagsReentrant() const
+{
+  return true;
+}
+
+/**
+ * Read tags from the persistent tag cache without accessing the file.
+ *
+ * @return true if the tags were read from the cache.
+ */
+bool TagLibFile::readTagsFromCache()
+{
+  if (m_cacheEntry) {
+    return true;
+  }
+  if (!m_fileRef.isNull() || isChanged() || !TagCache::isEnabled()) {
+    return false;
+  }
+  QScopedPointer<TagCache::Entry> entry(new TagCache::Entry);
+  if (!TagCache::instance().lookup(currentFilePath(), tagCacheContext(),
+                                   *entry)) {
+    return false;
+  }
+
+  bool priorIsTagInformationRead = isTagInformationRead();
+  m_fileExtension = entry->fileExtension;
+  m_detailInfo = entry->detailInfo;
+  FOR_TAGLIB_TAGS(tagNr) {
+    const TagCache::Tag& tag = entry->tags[tagNr];
+    m_isTagSupported[tagNr] = tag.supported;
+    m_hasTag[tagNr] = tag.hasTag;
+    m_tagFormat[tagNr] = tag.format;
+    m_tagType[tagNr] = tag.type;
+  }
+  m_tagInformationRead = true;
+  m_cacheEntry.reset(entry.take());
+  notifyModelDataChanged(priorIsTagInformationRead);
+  return true;
+}
+
+/**
+ * Store the tags which have just been read from the file in the tag cache.
+ */
+void TagLibFile::storeInTagCache()
+{
+  const QString filePath = currentFilePath();
+  const QString context = tagCacheContext();
+  TagCache& tagCache = TagCache::instance();
+  if (m_fileRef.isNull() || tagCache.contains(filePath, context)) {
+    return;
+  }
+
+  TagCache::Entry entry;
+  createCacheEntry(entry);
+  tagCache.store(filePath, entry);
+}
+
+/**
+ * Create a cache entry with the tags which have been read from the file.
+ * @param entry the tag information and values are stored here
+ */
+void TagLibFile::createCacheEntry(TagCache::Entry& entry)
+{
+  // Serialized frames larger than this are not cached, so that the cache
+  // does not grow too much with embedded pictures. getAllFrames() will then
+  // read the file.
+  constexpr int maxFramesSize = 65536;
+
+  entry.context = tagCacheContext();
+  entry.fileExtension = m_fileExtension;
+  entry.detailInfo = m_detailInfo;
+  FOR_TAGLIB_TAGS(tagNr) {
+    TagCache::Tag& tag = entry.tags[tagNr];
+    tag.format = m_tagFormat[tagNr];
+    tag.type = m_tagType[tagNr];
+    tag.supported = m_isTagSupported[tagNr];
+    tag.hasTag = m_hasTag[tagNr];
+    for (int type = Frame::FT_FirstFrame; type <= Frame::FT_LastV1Frame;
+         ++type) {
+      Frame frame;
+      getFrame(tagNr, static_cast<Frame::Type>(type), frame);
+      tag.values.append(frame.getValue());
+    }
+    if (tagNr != Frame::Tag_Id3v1) {
+      FrameCollection frames;
+      getAllFrames(tagNr, frames);
+      tag.frames = TagCache::framesToData(frames, maxFramesSize);
+    }
+  }
+}
+
+/**
+ * Replace the parsed file by a snapshot of its tags.
+ * The TagLib objects and pictures are freed, the file is parsed again when
+ * the tags are modified or frames are requested which are not contained in
+ * the snapshot. Nothing is done if the file has unsaved changes.
+ *
+ * @param snapshot snapshot to use, ownership is transferred, if null,
+ * a snapshot of the tags which have been read is created
+ */
+void TagLibFile::replaceFileBySnapshot(TagCache::Entry* snapshot)
+{
+  QScopedPointer<TagCache::Entry> entry(snapshot);
+  if (m_fileRef.isNull() || isChanged()) {
+    return;
+  }
+  if (!entry) {
+    entry.reset(new TagCache::Entry);
+    createCacheEntry(*entry);
+  }
+  closeFile(true);
+  m_pictures.clear();
+  m_pictures.setRead(false);
+  m_cacheEntry.reset(entry.take());
+}
+
+/**
+ * Get context of the tag cache entries created by this class.
+ * @return backend and settings affecting the cached information.
+ */
+QString TagLibFile::tagCacheContext()
+{
+  // Settings which change how the tags are converted to frames.
+  const TagConfig& tagCfg = TagConfig::instance();
+  const QStringList settings = QStringList{
+    tagCfg.textEncodingV1(), tagCfg.riffTrackName()
+  } + Frame::getNamesForCustomFrames();
+  return QLatin1String("TaglibMetadata ") +
+      QString::number(TAGLIB_VERSION, 16) + QLatin1Char(' ') +
+      QString::fromLatin1(QCryptographicHash::hash(
+          settings.join(QLatin1Char('\n')).toUtf8(),
+          QCryptographicHash::Md5).toHex());
+}
+
 /**
  * Read tags from file.
+ * If the tag cache is enabled and contains an up-to-date entry for the file,
+ * the file is not read until its tags are accessed in a way which is not
+ * supported by the cache. If tag snapshots are enabled, the file is replaced
+ * by a snapshot of its tags after it has been read.
  *
  * @param force true to force reading even if tags were already read.
  */
 void TagLibFile::readTags(bool force)
+{
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::ReadTags);
+  if (!force && m_fileRef.isNull() && readTagsFromCache()) {
+    return;
+  }
+  readTagsFromFile(force);
+  if (TagConfig::instance().tagSnapshotsEnabled()) {
+    replaceFileBySnapshot(nullptr);
+  }
+}
+
+/**
+ * Read tags from file without using the tag cache.
+ *
+ * @param force true to force reading even if tags were already read.
+ */
+void TagLibFile::readTagsFromFile(bool force)
 {
   bool priorIsTagInformationRead = isTagInformationRead();
   QString fileName = currentFilePath();
+  m_cacheEntry.reset();
 
   if (force || m_fileRef.isNull()) {
     delete m_stream;
@@ -1297,6 +1779,15 @@ void TagLibFile::readTags(bool force)
     setFilename(currentFilename());
   }
 
+  if (!isChanged() && TagCache::isEnabled()) {
+    storeInTagCache();
+  }
+
+  if (m_stream) {
+    // Parsing is finished, do not keep the file mapped while it can be
+    // modified by other programs.
+    m_stream->disableMapping();
+  }
   closeFile(false);
 
   notifyModelDataChanged(priorIsTagInformationRead);
@@ -1337,7 +1828,7 @@ void TagLibFile::closeFile(bool force)
 void TagLibFile::makeFileOpen(bool force) const
 {
   if (!m_fileRead || force) {
-    const_cast<TagLibFile*>(this)->readTags(force);
+    const_cast<TagLibFile*>(this)->readTagsFromFile(force);
   }
 }
 
@@ -1381,6 +1872,7 @@ bool TagLibFile::writeTags(bool force, bool* renamed, bool preserve)
 bool TagLibFile::writeTags(bool force, bool* renamed, bool preserve,
                            int id3v2Version)
 {
+  PerformanceStatistics::ScopedTimer timer(PerformanceStatistics::WriteTags);
   QString fnStr(currentFilePath());
   if (isChanged() && !QFileInfo(fnStr).isWritable()) {
     closeFile(false);
@@ -2612,12 +3104,13 @@ const struct TypeStrOfId {
 void getTypeStringForFrameId(const TagLib::ByteVector& id, Frame::Type& type,
                              const char*& str)
 {
-  static TagLib::Map<TagLib::ByteVector, unsigned> idIndexMap;
-  if (idIndexMap.isEmpty()) {
+  static const TagLib::Map<TagLib::ByteVector, unsigned> idIndexMap = [] {
+    TagLib::Map<TagLib::ByteVector, unsigned> map;
     for (unsigned i = 0; i < std::size(typeStrOfId); ++i) {
-      idIndexMap.insert(TagLib::ByteVector(typeStrOfId[i].str, 4), i);
+      map.insert(TagLib::ByteVector(typeStrOfId[i].str, 4), i);
     }
-  }
+    return map;
+  }();
   if (idIndexMap.contains(id)) {
     const auto& [s, t, supported] = typeStrOfId[idIndexMap[id]];
     type = t;
@@ -4354,16 +4847,16 @@ const char* getVorbisNameFromType(Frame::Type type)
  */
 Frame::Type getTypeFromVorbisName(QString name)
 {
-  static QMap<QString, int> strNumMap;
-  if (strNumMap.empty()) {
-    // first time initialization
+  static const QMap<QString, int> strNumMap = [] {
+    QMap<QString, int> map;
     for (int i = 0; i < Frame::FT_Custom1; ++i) {
       auto type = static_cast<Frame::Type>(i);
-      strNumMap.insert(QString::fromLatin1(getVorbisNameFromType(type)), type);
+      map.insert(QString::fromLatin1(getVorbisNameFromType(type)), type);
     }
-    strNumMap.insert(QLatin1String("COVERART"), Frame::FT_Picture);
-    strNumMap.insert(QLatin1String("METADATA_BLOCK_PICTURE"), Frame::FT_Picture);
-  }
+    map.insert(QLatin1String("COVERART"), Frame::FT_Picture);
+    map.insert(QLatin1String("METADATA_BLOCK_PICTURE"), Frame::FT_Picture);
+    return map;
+  }();
   if (auto it = strNumMap.constFind(name.remove(QLatin1Char('=')).toUpper());
       it != strNumMap.constEnd()) {
     return static_cast<Frame::Type>(*it);
@@ -4586,15 +5079,15 @@ const Mp4NameTypeValue mp4NameTypeValues[] = {
 void getMp4NameForType(Frame::Type type, TagLib::String& name,
                        Mp4ValueType& value)
 {
-  static QMap<Frame::Type, unsigned> typeNameMap;
-  if (typeNameMap.empty()) {
-    // first time initialization
+  static const QMap<Frame::Type, unsigned> typeNameMap = [] {
+    QMap<Frame::Type, unsigned> map;
     for (unsigned i = 0; i < std::size(mp4NameTypeValues); ++i) {
       if (mp4NameTypeValues[i].type != Frame::FT_Other) {
-        typeNameMap.insert(mp4NameTypeValues[i].type, i);
+        map.insert(mp4NameTypeValues[i].type, i);
       }
     }
-  }
+    return map;
+  }();
   name = "";
   value = MVT_String;
   if (type != Frame::FT_Other) {
@@ -4622,13 +5115,13 @@ void getMp4NameForType(Frame::Type type, TagLib::String& name,
 bool getMp4TypeForName(const TagLib::String& name, Frame::Type& type,
                        Mp4ValueType& value)
 {
-  static QMap<TagLib::String, unsigned> nameTypeMap;
-  if (nameTypeMap.empty()) {
-    // first time initialization
+  static const QMap<TagLib::String, unsigned> nameTypeMap = [] {
+    QMap<TagLib::String, unsigned> map;
     for (unsigned i = 0; i < std::size(mp4NameTypeValues); ++i) {
-      nameTypeMap.insert(mp4NameTypeValues[i].name, i);
+      map.insert(mp4NameTypeValues[i].name, i);
     }
-  }
+    return map;
+  }();
   if (auto it = nameTypeMap.constFind(name); it != nameTypeMap.constEnd()) {
     type = mp4NameTypeValues[*it].type;
     value = mp4NameTypeValues[*it].value;
@@ -4930,16 +5423,16 @@ const AsfNameTypeValue asfNameTypeValues[] = {
 void getAsfNameForType(Frame::Type type, TagLib::String& name,
                        TagLib::ASF::Attribute::AttributeTypes& value)
 {
-  static QMap<Frame::Type, unsigned> typeNameMap;
-  if (typeNameMap.empty()) {
-    // first time initialization
+  static const QMap<Frame::Type, unsigned> typeNameMap = [] {
+    QMap<Frame::Type, unsigned> map;
     for (unsigned i = 0; i < std::size(asfNameTypeValues); ++i) {
       if (asfNameTypeValues[i].type != Frame::FT_Other &&
-          !typeNameMap.contains(asfNameTypeValues[i].type)) {
-        typeNameMap.insert(asfNameTypeValues[i].type, i);
+          !map.contains(asfNameTypeValues[i].type)) {
+        map.insert(asfNameTypeValues[i].type, i);
       }
     }
-  }
+    return map;
+  }();
   name = "";
   value = TagLib::ASF::Attribute::UnicodeType;
   if (type != Frame::FT_Other) {
@@ -4965,13 +5458,13 @@ void getAsfNameForType(Frame::Type type, TagLib::String& name,
 void getAsfTypeForName(const TagLib::String& name, Frame::Type& type,
                        TagLib::ASF::Attribute::AttributeTypes& value)
 {
-  static QMap<TagLib::String, unsigned> nameTypeMap;
-  if (nameTypeMap.empty()) {
-    // first time initialization
+  static const QMap<TagLib::String, unsigned> nameTypeMap = [] {
+    QMap<TagLib::String, unsigned> map;
     for (unsigned i = 0; i < std::size(asfNameTypeValues); ++i) {
-      nameTypeMap.insert(asfNameTypeValues[i].name, i);
+      map.insert(asfNameTypeValues[i].name, i);
     }
-  }
+    return map;
+  }();
   if (auto it = nameTypeMap.constFind(name); it != nameTypeMap.constEnd()) {
     type = asfNameTypeValues[*it].type;
     value = asfNameTypeValues[*it].value;
@@ -5241,27 +5734,30 @@ TagLib::ByteVector getInfoNameFromType(Frame::Type type)
  */
 Frame::Type getTypeFromInfoName(const TagLib::ByteVector& id)
 {
-  static QMap<TagLib::ByteVector, int> strNumMap;
-  if (strNumMap.isEmpty()) {
-    // first time initialization
+  static const QMap<TagLib::ByteVector, int> strNumMap = [] {
+    QMap<TagLib::ByteVector, int> map;
     for (int i = 0; i < Frame::FT_Custom1; ++i) {
       auto type = static_cast<Frame::Type>(i);
-      if (TagLib::ByteVector str = getInfoNameFromType(type); !str.isEmpty()) {
-        strNumMap.insert(str, type);
+      if (TagLib::ByteVector str = getInfoNameFromType(type);
+          type != Frame::FT_Track && !str.isEmpty()) {
+        map.insert(str, type);
       }
     }
-    QStringList riffTrackNames = TagConfig::getRiffTrackNames();
-    riffTrackNames.append(TagConfig::instance().riffTrackName());
-    const auto constRiffTrackNames = riffTrackNames;
-    for (const QString& str : constRiffTrackNames) {
+    const QStringList riffTrackNames = TagConfig::getRiffTrackNames();
+    for (const QString& str : riffTrackNames) {
       QByteArray ba = str.toLatin1();
-      strNumMap.insert(TagLib::ByteVector(ba.constData(), ba.size()),
-                       Frame::FT_Track);
+      map.insert(TagLib::ByteVector(ba.constData(), ba.size()),
+                 Frame::FT_Track);
     }
-  }
+    return map;
+  }();
   if (auto it = strNumMap.constFind(id); it != strNumMap.constEnd()) {
     return static_cast<Frame::Type>(*it);
   }
+  // The configured track name can be changed at run time.
+  if (id == getInfoNameFromType(Frame::FT_Track)) {
+    return Frame::FT_Track;
+  }
   return Frame::getTypeFromCustomFrameName(
         QByteArray(id.data(), id.size()));
 }
@@ -5305,6 +5801,17 @@ bool TagLibFile::getFrame(Frame::TagNumber tagNr, Frame::Type type, Frame& frame
   if (tagNr >= NUM_TAGS)
     return false;
 
+  if (m_cacheEntry) {
+    const QStringList& values = m_cacheEntry->tags[tagNr].values;
+    if (type < Frame::FT_FirstFrame || type > Frame::FT_LastV1Frame ||
+        type - Frame::FT_FirstFrame >= values.size()) {
+      return false;
+    }
+    frame.setValue(values.at(type - Frame::FT_FirstFrame));
+    frame.setType(type);
+    return true;
+  }
+
   makeFileOpen();
   if (TagLib::Tag* tag = m_tag[tagNr]) {
     TagLib::String tstr;
@@ -5765,13 +6272,14 @@ bool TagLibFile::setFrame(Frame::TagNumber tagNr, const Frame& frame)
                     { "Synth-Pop", "Synthpop" },
                     { "Worldbeat", "Negerpunk" }
                   };
-                static TagLib::Map<TagLib::String, TagLib::String> genreNameMap;
-                if (genreNameMap.isEmpty()) {
-                  // first time initialization
+                using StringMap = TagLib::Map<TagLib::String, TagLib::String>;
+                static const StringMap genreNameMap = [] {
+                  StringMap map;
                   for (const auto& [newName, oldName] : alternativeGenreNames) {
-                    genreNameMap.insert(newName, oldName);
+                    map.insert(newName, oldName);
                   }
-                }
+                  return map;
+                }();
                 if (auto it = genreNameMap.find(tstr);
                   it != genreNameMap.end()) {
                   tstr = it->second;
@@ -6646,6 +7154,17 @@ void TagLibFile::getAllFrames(Frame::TagNumber tagNr, FrameCollection& frames)
     return;
 
   if (tagNr != Frame::Tag_Id3v1) {
+    if (m_cacheEntry &&
+        TagCache::framesFromData(m_cacheEntry->tags[tagNr].frames, frames)) {
+      updateMarkedState(tagNr, frames);
+      return;
+    }
+    // With snapshots enabled, the file is only kept open to get the frames
+    // which are missing in the snapshot.
+    QScopedPointer<TagCache::Entry> snapshot;
+    if (m_cacheEntry && TagConfig::instance().tagSnapshotsEnabled()) {
+      snapshot.reset(m_cacheEntry.take());
+    }
     makeFileOpen();
     frames.clear();
     if (m_tag[tagNr]) {
@@ -6895,6 +7414,9 @@ void TagLibFile::getAllFrames(Frame::TagNumber tagNr, FrameCollection& frames)
     if (tagNr <= Frame::Tag_2) {
       frames.addMissingStandardFrames();
     }
+    if (snapshot) {
+      replaceFileBySnapshot(snapshot.take());
+    }
     return;
   }
 
@@ -6919,6 +7441,9 @@ void TagLibFile::closeFileHandle()
  */
 void TagLibFile::addFieldList(Frame::TagNumber tagNr, Frame& frame) const
 {
+  if (m_cacheEntry) {
+    makeFileOpen();
+  }
   if (dynamic_cast<TagLib::ID3v2::Tag*>(m_tag[tagNr]) != nullptr &&
       frame.fieldList().isEmpty()) {
     TagLib::ID3v2::Frame* id3Frame = createId3FrameFromFrame(this, frame);
@@ -7098,6 +7623,18 @@ void TagLibFile::notifyConfigurationChange()
   setDefaultTextEncoding(
     static_cast<TagConfig::TextEncoding>(TagConfig::instance().textEncoding()));
   setTextEncodingV1(TagConfig::instance().textEncodingV1());
+  FileIOStream::setMaximumOpenFiles(
+        TagConfig::instance().effectiveMaximumOpenFiles());
+}
+
+/**
+ * Get statistics about the file handles used to access files.
+ * @return map with number of "openFiles", "maximumOpenFiles", "hits",
+ * "opens", "reopens" and "evictions".
+ */
+QVariantMap TagLibFile::getFileHandleStatistics()
+{
+  return FileIOStream::statistics();
 }
 
 namespace {
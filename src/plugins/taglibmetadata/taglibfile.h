@@ -27,8 +27,11 @@
 #pragma once
 
 #include <QtGlobal>
+#include <QScopedPointer>
+#include <QVariantMap>
 #include "taggedfile.h"
 #include "tagconfig.h"
+#include "tagcache.h"
 #include <taglib.h>
 #include <fileref.h>
 #include <id3v2frame.h>
@@ -107,6 +110,25 @@ public:
    */
   void readTags(bool force) override;
 
+  /**
+   * Check if readTags() can be called from a worker thread.
+   * @return true.
+   */
+  bool isReadTagsReentrant() const override;
+
+  /**
+   * Check if writeTags() can be called from a worker thread.
+   * @return true.
+   */
+  bool isWriteTagsReentrant() const override;
+
+  /**
+   * Read tags from the persistent tag cache without accessing the file.
+   *
+   * @return true if the tags were read from the cache.
+   */
+  bool readTagsFromCache() override;
+
   /**
    * Write tags to file and rename it if necessary.
    *
@@ -298,6 +320,19 @@ public:
    */
   static void notifyConfigurationChange();
 
+  /**
+   * Get statistics about the file handles used to access files.
+   * The number of open file handles is limited by
+   * TagConfig::effectiveMaximumOpenFiles(), the least recently used handles
+   * are closed and reopened when they are accessed again.
+   *
+   * @return map with number of "openFiles", "maximumOpenFiles", "hits"
+   * (accesses with open handle), "opens" (first opens), "reopens" (opens
+   * after the handle has been closed) and "evictions" (closed because the
+   * maximum was exceeded).
+   */
+  static QVariantMap getFileHandleStatistics();
+
 private:
   friend void TagLibFileInternal::fixUpTagLibFrameValue(
       const TagLibFile* self, Frame::Type frameType, QString& value);
@@ -326,6 +361,41 @@ private:
    */
   void makeFileOpen(bool force = false) const;
 
+  /**
+   * Read tags from file without using the tag cache.
+   *
+   * @param force true to force reading even if tags were already read.
+   */
+  void readTagsFromFile(bool force);
+
+  /**
+   * Store the tags which have just been read from the file in the tag cache.
+   */
+  void storeInTagCache();
+
+  /**
+   * Create a cache entry with the tags which have been read from the file.
+   * @param entry the tag information and values are stored here
+   */
+  void createCacheEntry(TagCache::Entry& entry);
+
+  /**
+   * Replace the parsed file by a snapshot of its tags.
+   * The TagLib objects and pictures are freed, the file is parsed again when
+   * the tags are modified or frames are requested which are not contained in
+   * the snapshot. Nothing is done if the file has unsaved changes.
+   *
+   * @param snapshot snapshot to use, ownership is transferred, if null,
+   * a snapshot of the tags which have been read is created
+   */
+  void replaceFileBySnapshot(TagCache::Entry* snapshot);
+
+  /**
+   * Get context of the tag cache entries created by this class.
+   * @return backend and settings affecting the cached information.
+   */
+  static QString tagCacheContext();
+
   /**
    * Create tag if it does not already exist so that it can be set.
    *
@@ -422,6 +492,11 @@ private:
   QString m_tagFormat[NUM_TAGS];
   QString m_fileExtension;
   DetailInfo m_detailInfo;
+  /**
+   * Tags read from the tag cache or snapshot of the tags, null if file has
+   * been read
+   */
+  QScopedPointer<TagCache::Entry> m_cacheEntry;
 
   class Pictures : public QList<Frame> {
   public:
@@ -26,6 +26,7 @@
 
 #include "taglibmetadataplugin.h"
 #include "taglibfile.h"
+#include "performancestatistics.h"
 
 namespace {
 
@@ -86,6 +87,8 @@ void TaglibMetadataPlugin::initialize(const QString& key)
 {
   if (key == TAGGEDFILE_KEY) {
     TagLibFile::staticInit();
+    PerformanceStatistics::addCounters(QLatin1String("fileHandles"),
+                                       TagLibFile::getFileHandleStatistics);
   }
 }
 
@@ -123,6 +123,16 @@ AbstractSettingsPage {
           onActivated: function() { value = tagCfg.maximumPictureSize; }
           onDeactivated: function() { tagCfg.maximumPictureSize = value; }
         },
+        SettingsElement {
+          name: qsTr("Cache tags of unchanged files")
+          onActivated: function() { value = tagCfg.tagCacheEnabled; }
+          onDeactivated: function() { tagCfg.tagCacheEnabled = value; }
+        },
+        SettingsElement {
+          name: qsTr("Keep only compact copies of read tags in memory")
+          onActivated: function() { value = tagCfg.tagSnapshotsEnabled; }
+          onDeactivated: function() { tagCfg.tagSnapshotsEnabled = value; }
+        },
         SettingsElement {
           name: qsTr("Show only custom genres")
           onActivated: function() { value = tagCfg.onlyCustomGenres; }
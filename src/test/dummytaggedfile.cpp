@@ -0,0 +1,286 @@
+/**
+ * \file dummytaggedfile.cpp
+ * Tagged file stub with frames kept in memory for tests.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "dummytaggedfile.h"
+
+/**
+ * Constructor.
+ *
+ * @param idx index in tagged file system model
+ */
+DummyTaggedFile::DummyTaggedFile(const QPersistentModelIndex& idx)
+  : TaggedFile(idx), m_nextIndex(0), m_getAllFramesCount(0),
+    m_tagsRead(false)
+{
+}
+
+/**
+ * Get key of tagged file format.
+ * @return "DummyMetadata".
+ */
+QString DummyTaggedFile::taggedFileKey() const
+{
+  return QLatin1String("DummyMetadata");
+}
+
+/**
+ * Mark tags as read.
+ * @param force not used
+ */
+void DummyTaggedFile::readTags(bool force)
+{
+  Q_UNUSED(force)
+  m_tagsRead = true;
+  FOR_ALL_TAGS(tagNr) {
+    markTagUnchanged(tagNr);
+  }
+}
+
+/**
+ * Mark tags as unchanged, nothing is written.
+ *
+ * @param force not used
+ * @param renamed not used
+ * @param preserve not used
+ *
+ * @return true.
+ */
+bool DummyTaggedFile::writeTags(bool force, bool* renamed, bool preserve)
+{
+  Q_UNUSED(force)
+  Q_UNUSED(renamed)
+  Q_UNUSED(preserve)
+  FOR_ALL_TAGS(tagNr) {
+    markTagUnchanged(tagNr);
+  }
+  return true;
+}
+
+/**
+ * Mark tags as not read.
+ * @param force not used
+ */
+void DummyTaggedFile::clearTags(bool force)
+{
+  Q_UNUSED(force)
+  m_tagsRead = false;
+  clearCachedFrames();
+}
+
+/**
+ * Check if tag information has already been read.
+ * @return true if readTags() has been called.
+ */
+bool DummyTaggedFile::isTagInformationRead() const
+{
+  return m_tagsRead;
+}
+
+/**
+ * Check if file has a tag.
+ * @param tagNr tag number
+ * @return true if the tag contains frames.
+ */
+bool DummyTaggedFile::hasTag(Frame::TagNumber tagNr) const
+{
+  return tagNr < Frame::Tag_NumValues && !m_frames[tagNr].empty();
+}
+
+/**
+ * Check if tags are supported by the format of this file.
+ * @param tagNr tag number
+ * @return true for tag 1 and tag 2.
+ */
+bool DummyTaggedFile::isTagSupported(Frame::TagNumber tagNr) const
+{
+  return tagNr == Frame::Tag_1 || tagNr == Frame::Tag_2;
+}
+
+/**
+ * Get technical detail information.
+ * @param info invalid information is returned here
+ */
+void DummyTaggedFile::getDetailInfo(DetailInfo& info) const
+{
+  info = DetailInfo();
+}
+
+/**
+ * Get duration of file.
+ * @return 0.
+ */
+unsigned DummyTaggedFile::getDuration() const
+{
+  return 0;
+}
+
+/**
+ * Get file extension including the dot.
+ * @return ".mp3".
+ */
+QString DummyTaggedFile::getFileExtension() const
+{
+  return QLatin1String(".mp3");
+}
+
+/**
+ * Get the format of tag.
+ * @param tagNr tag number
+ * @return "ID3v1.1" for tag 1, "ID3v2.4.0" for tag 2, else null.
+ */
+QString DummyTaggedFile::getTagFormat(Frame::TagNumber tagNr) const
+{
+  if (tagNr == Frame::Tag_1) {
+    return QLatin1String("ID3v1.1");
+  }
+  if (tagNr == Frame::Tag_2) {
+    return QLatin1String("ID3v2.4.0");
+  }
+  return QString();
+}
+
+/**
+ * Get a specific frame from the tags.
+ *
+ * @param tagNr tag number
+ * @param type  frame type
+ * @param frame the frame is returned here
+ *
+ * @return true if ok.
+ */
+bool DummyTaggedFile::getFrame(Frame::TagNumber tagNr, Frame::Type type,
+                               Frame& frame) const
+{
+  if (!isTagSupported(tagNr)) {
+    return false;
+  }
+  const FrameCollection& frames = m_frames[tagNr];
+  Frame key(Frame::ExtendedType(type), QLatin1String(""), -1);
+  auto it = frames.find(key);
+  frame = it != frames.cend() ? *it : key;
+  return true;
+}
+
+/**
+ * Set a frame in the tags.
+ * The frame is looked up by its index, or by its type if it does not have
+ * an index. A new frame is added if not found.
+ *
+ * @param tagNr tag number
+ * @param frame frame to set.
+ *
+ * @return true if ok.
+ */
+bool DummyTaggedFile::setFrame(Frame::TagNumber tagNr, const Frame& frame)
+{
+  if (!isTagSupported(tagNr)) {
+    return false;
+  }
+  FrameCollection& frames = m_frames[tagNr];
+  FrameCollection::const_iterator it = frames.find(frame);
+  if (frame.getIndex() != -1) {
+    it = frames.findByIndex(frame.getIndex());
+  }
+  if (it == frames.cend()) {
+    Frame newFrame(frame);
+    return addFrame(tagNr, newFrame);
+  }
+  const int index = it->getIndex();
+  frames.erase(it);
+  Frame newFrame(frame);
+  newFrame.setIndex(index);
+  frames.insert(newFrame);
+  markTagChanged(tagNr, frame.getExtendedType());
+  return true;
+}
+
+/**
+ * Add a frame in the tags.
+ *
+ * @param tagNr tag number
+ * @param frame frame to add, its index is set
+ *
+ * @return true if ok.
+ */
+bool DummyTaggedFile::addFrame(Frame::TagNumber tagNr, Frame& frame)
+{
+  if (!isTagSupported(tagNr)) {
+    return false;
+  }
+  frame.setIndex(m_nextIndex++);
+  m_frames[tagNr].insert(frame);
+  markTagChanged(tagNr, frame.getExtendedType());
+  return true;
+}
+
+/**
+ * Delete a frame from the tags.
+ *
+ * @param tagNr tag number
+ * @param frame frame to delete
+ *
+ * @return true if ok.
+ */
+bool DummyTaggedFile::deleteFrame(Frame::TagNumber tagNr, const Frame& frame)
+{
+  if (!isTagSupported(tagNr)) {
+    return false;
+  }
+  FrameCollection& frames = m_frames[tagNr];
+  auto it = frames.findByIndex(frame.getIndex());
+  if (it == frames.cend()) {
+    return false;
+  }
+  frames.erase(it);
+  markTagChanged(tagNr, frame.getExtendedType());
+  return true;
+}
+
+/**
+ * Get a list of frame IDs which can be added.
+ * @param tagNr tag number
+ * @return empty list.
+ */
+QStringList DummyTaggedFile::getFrameIds(Frame::TagNumber tagNr) const
+{
+  Q_UNUSED(tagNr)
+  return QStringList();
+}
+
+/**
+ * Get all frames in tag.
+ * The marked state is updated as done by the real implementations.
+ *
+ * @param tagNr tag number
+ * @param frames frame collection to set.
+ */
+void DummyTaggedFile::getAllFrames(Frame::TagNumber tagNr,
+                                   FrameCollection& frames)
+{
+  ++m_getAllFramesCount;
+  frames = tagNr < Frame::Tag_NumValues ? m_frames[tagNr] : FrameCollection();
+  updateMarkedState(tagNr, frames);
+}
@@ -0,0 +1,198 @@
+/**
+ * \file dummytaggedfile.h
+ * Tagged file stub with frames kept in memory for tests.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "taggedfile.h"
+
+/**
+ * Tagged file stub for tests.
+ * The frames are kept in memory, the file is never accessed. Tag 1 and tag 2
+ * are supported, tag 2 has the format "ID3v2.4.0".
+ */
+class DummyTaggedFile : public TaggedFile {
+public:
+  /**
+   * Constructor.
+   *
+   * @param idx index in tagged file system model
+   */
+  explicit DummyTaggedFile(const QPersistentModelIndex& idx);
+
+  /**
+   * Destructor.
+   */
+  ~DummyTaggedFile() override = default;
+
+  DummyTaggedFile(const DummyTaggedFile& other) = delete;
+  DummyTaggedFile &operator=(const DummyTaggedFile& other) = delete;
+
+  /**
+   * Get key of tagged file format.
+   * @return "DummyMetadata".
+   */
+  QString taggedFileKey() const override;
+
+  /**
+   * Mark tags as read.
+   * @param force not used
+   */
+  void readTags(bool force) override;
+
+  /**
+   * Mark tags as unchanged, nothing is written.
+   *
+   * @param force not used
+   * @param renamed not used
+   * @param preserve not used
+   *
+   * @return true.
+   */
+  bool writeTags(bool force, bool* renamed, bool preserve) override;
+
+  /**
+   * Mark tags as not read.
+   * @param force not used
+   */
+  void clearTags(bool force) override;
+
+  /**
+   * Check if tag information has already been read.
+   * @return true if readTags() has been called.
+   */
+  bool isTagInformationRead() const override;
+
+  /**
+   * Check if file has a tag.
+   * @param tagNr tag number
+   * @return true if the tag contains frames.
+   */
+  bool hasTag(Frame::TagNumber tagNr) const override;
+
+  /**
+   * Check if tags are supported by the format of this file.
+   * @param tagNr tag number
+   * @return true for tag 1 and tag 2.
+   */
+  bool isTagSupported(Frame::TagNumber tagNr) const override;
+
+  /**
+   * Get technical detail information.
+   * @param info invalid information is returned here
+   */
+  void getDetailInfo(DetailInfo& info) const override;
+
+  /**
+   * Get duration of file.
+   * @return 0.
+   */
+  unsigned getDuration() const override;
+
+  /**
+   * Get file extension including the dot.
+   * @return ".mp3".
+   */
+  QString getFileExtension() const override;
+
+  /**
+   * Get the format of tag.
+   * @param tagNr tag number
+   * @return "ID3v1.1" for tag 1, "ID3v2.4.0" for tag 2, else null.
+   */
+  QString getTagFormat(Frame::TagNumber tagNr) const override;
+
+  /**
+   * Get a specific frame from the tags.
+   *
+   * @param tagNr tag number
+   * @param type  frame type
+   * @param frame the frame is returned here
+   *
+   * @return true if ok.
+   */
+  bool getFrame(Frame::TagNumber tagNr, Frame::Type type,
+                Frame& frame) const override;
+
+  /**
+   * Set a frame in the tags.
+   * The frame is looked up by its index, or by its type if it does not have
+   * an index. A new frame is added if not found.
+   *
+   * @param tagNr tag number
+   * @param frame frame to set.
+   *
+   * @return true if ok.
+   */
+  bool setFrame(Frame::TagNumber tagNr, const Frame& frame) override;
+
+  /**
+   * Add a frame in the tags.
+   *
+   * @param tagNr tag number
+   * @param frame frame to add, its index is set
+   *
+   * @return true if ok.
+   */
+  bool addFrame(Frame::TagNumber tagNr, Frame& frame) override;
+
+  /**
+   * Delete a frame from the tags.
+   *
+   * @param tagNr tag number
+   * @param frame frame to delete
+   *
+   * @return true if ok.
+   */
+  bool deleteFrame(Frame::TagNumber tagNr, const Frame& frame) override;
+
+  /**
+   * Get a list of frame IDs which can be added.
+   * @param tagNr tag number
+   * @return empty list.
+   */
+  QStringList getFrameIds(Frame::TagNumber tagNr) const override;
+
+  /**
+   * Get all frames in tag.
+   * The marked state is updated as done by the real implementations.
+   *
+   * @param tagNr tag number
+   * @param frames frame collection to set.
+   */
+  void getAllFrames(Frame::TagNumber tagNr, FrameCollection& frames) override;
+
+  /**
+   * Get number of calls to getAllFrames().
+   * @return number of calls.
+   */
+  int getAllFramesCount() const { return m_getAllFramesCount; }
+
+private:
+  FrameCollection m_frames[Frame::Tag_NumValues];
+  int m_nextIndex;
+  int m_getAllFramesCount;
+  bool m_tagsRead;
+};
@@ -0,0 +1,615 @@
+/**
+ * \file kid3bench.cpp
+ * Benchmark for reading and writing tags with the metadata plugins.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QTemporaryDir>
+#include <QEventLoop>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QDir>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QTextStream>
+#include <QSettings>
+#include <functional>
+#include "config.h"
+#include "coreplatformtools.h"
+#include "kid3application.h"
+#include "taggedfilesystemmodel.h"
+#include "tagconfig.h"
+#include "itaggedfilefactory.h"
+#include "taggedfile.h"
+#include "trackdata.h"
+#include "filefilter.h"
+#include "pictureframe.h"
+
+namespace {
+
+/** Size and content of the tags written to the fixtures. */
+struct TagVariant {
+  const char* name;  /**< name used in results */
+  int numFrames;     /**< number of additional text frames */
+  int valueLength;   /**< length of values of additional frames */
+  int pictureSize;   /**< size of embedded picture, 0 for none */
+};
+
+const TagVariant tagVariants[] = {
+  { "small", 0, 0, 0 },
+  { "medium", 10, 64, 16 * 1024 },
+  { "large", 20, 1024, 256 * 1024 }
+};
+
+/** Additional frame types used for the frame count of a variant. */
+const Frame::Type extraFrameTypes[] = {
+  Frame::FT_AlbumArtist, Frame::FT_Composer, Frame::FT_Conductor,
+  Frame::FT_Copyright, Frame::FT_Disc, Frame::FT_EncodedBy,
+  Frame::FT_Grouping, Frame::FT_Isrc, Frame::FT_Language, Frame::FT_Lyricist,
+  Frame::FT_Lyrics, Frame::FT_Mood, Frame::FT_OriginalAlbum,
+  Frame::FT_OriginalArtist, Frame::FT_Publisher, Frame::FT_Remixer,
+  Frame::FT_Subtitle, Frame::FT_Website, Frame::FT_Bpm, Frame::FT_Arranger
+};
+
+void appendLE(QByteArray& ba, quint64 value, int numBytes)
+{
+  for (int i = 0; i < numBytes; ++i) {
+    ba.append(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+void appendBE(QByteArray& ba, quint64 value, int numBytes)
+{
+  for (int i = numBytes - 1; i >= 0; --i) {
+    ba.append(static_cast<char>((value >> (8 * i)) & 0xff));
+  }
+}
+
+/** MPEG-1 Layer III frames with silence. */
+QByteArray createMp3()
+{
+  QByteArray ba;
+  // 128 kbit/s, 44100 Hz, stereo: 417 bytes per frame
+  for (int i = 0; i < 40; ++i) {
+    ba.append("\xff\xfb\x90\x00", 4);
+    ba.append(QByteArray(413, '\0'));
+  }
+  return ba;
+}
+
+/** FLAC stream with only the STREAMINFO block. */
+QByteArray createFlac()
+{
+  QByteArray ba("fLaC");
+  appendBE(ba, 0x80, 1); // last metadata block, STREAMINFO
+  appendBE(ba, 34, 3);
+  appendBE(ba, 4096, 2); // minimum block size
+  appendBE(ba, 4096, 2); // maximum block size
+  appendBE(ba, 0, 3);    // minimum frame size
+  appendBE(ba, 0, 3);    // maximum frame size
+  // 44100 Hz, 2 channels, 16 bits per sample, 441000 samples
+  appendBE(ba, (Q_UINT64_C(44100) << 44) | (Q_UINT64_C(1) << 41) |
+           (Q_UINT64_C(15) << 36) | 441000, 8);
+  ba.append(QByteArray(16, '\0')); // MD5
+  return ba;
+}
+
+/** CRC used in Ogg pages. */
+quint32 oggCrc(const QByteArray& data)
+{
+  quint32 crc = 0;
+  for (char c : data) {
+    crc ^= static_cast<quint32>(static_cast<uchar>(c)) << 24;
+    for (int i = 0; i < 8; ++i) {
+      crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04c11db7 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+QByteArray createOggPage(const QByteArray& packet, int flags,
+                         quint64 granule, quint32 sequenceNr)
+{
+  QByteArray page("OggS", 4);
+  appendLE(page, 0, 1);
+  appendLE(page, flags, 1);
+  appendLE(page, granule, 8);
+  appendLE(page, 0x4b494433, 4); // serial number
+  appendLE(page, sequenceNr, 4);
+  appendLE(page, 0, 4); // CRC
+  const int numSegments = packet.size() / 255 + 1;
+  appendLE(page, numSegments, 1);
+  for (int i = 0; i < numSegments - 1; ++i) {
+    appendLE(page, 255, 1);
+  }
+  appendLE(page, packet.size() % 255, 1);
+  page.append(packet);
+  const quint32 crc = oggCrc(page);
+  for (int i = 0; i < 4; ++i) {
+    page[22 + i] = static_cast<char>((crc >> (8 * i)) & 0xff);
+  }
+  return page;
+}
+
+/** Ogg Opus stream with headers and a single audio packet. */
+QByteArray createOpus()
+{
+  QByteArray head("OpusHead", 8);
+  appendLE(head, 1, 1);     // version
+  appendLE(head, 2, 1);     // channels
+  appendLE(head, 312, 2);   // pre-skip
+  appendLE(head, 48000, 4); // input sample rate
+  appendLE(head, 0, 2);     // output gain
+  appendLE(head, 0, 1);     // channel mapping
+  QByteArray tags("OpusTags", 8);
+  const QByteArray vendor("kid3-bench");
+  appendLE(tags, vendor.size(), 4);
+  tags.append(vendor);
+  appendLE(tags, 0, 4);
+  return createOggPage(head, 0x02, 0, 0) +
+      createOggPage(tags, 0, 0, 1) +
+      createOggPage(QByteArray("\xfc\xff\xfe", 3), 0x04, 48000 + 312, 2);
+}
+
+void appendBox(QByteArray& ba, const char* type, const QByteArray& content)
+{
+  appendBE(ba, 8 + content.size(), 4);
+  ba.append(type, 4);
+  ba.append(content);
+}
+
+/** MP4 file with a movie header. */
+QByteArray createM4a()
+{
+  QByteArray ftyp("M4A ", 4);
+  appendBE(ftyp, 0, 4);
+  ftyp.append("M4A mp42isom", 12);
+  QByteArray mvhd;
+  appendBE(mvhd, 0, 4);      // version and flags
+  appendBE(mvhd, 0, 4);      // creation time
+  appendBE(mvhd, 0, 4);      // modification time
+  appendBE(mvhd, 1000, 4);   // time scale
+  appendBE(mvhd, 10000, 4);  // duration
+  appendBE(mvhd, 0x00010000, 4); // rate
+  appendBE(mvhd, 0x0100, 2); // volume
+  mvhd.append(QByteArray(10, '\0'));
+  const quint32 matrix[] = {
+    0x00010000, 0, 0, 0, 0x00010000, 0, 0, 0, 0x40000000
+  };
+  for (quint32 value : matrix) {
+    appendBE(mvhd, value, 4);
+  }
+  mvhd.append(QByteArray(24, '\0'));
+  appendBE(mvhd, 2, 4);      // next track ID
+  QByteArray moov;
+  appendBox(moov, "mvhd", mvhd);
+  QByteArray ba;
+  appendBox(ba, "ftyp", ftyp);
+  appendBox(ba, "moov", moov);
+  appendBox(ba, "mdat", QByteArray(1024, '\0'));
+  return ba;
+}
+
+/** RIFF WAVE file with 16 bit stereo silence. */
+QByteArray createWav()
+{
+  const int dataSize = 44100 * 4 / 2;
+  QByteArray ba("RIFF", 4);
+  appendLE(ba, 4 + 8 + 16 + 8 + dataSize, 4);
+  ba.append("WAVEfmt ", 8);
+  appendLE(ba, 16, 4);
+  appendLE(ba, 1, 2);          // PCM
+  appendLE(ba, 2, 2);          // channels
+  appendLE(ba, 44100, 4);      // sample rate
+  appendLE(ba, 44100 * 4, 4);  // byte rate
+  appendLE(ba, 4, 2);          // block align
+  appendLE(ba, 16, 2);         // bits per sample
+  ba.append("data", 4);
+  appendLE(ba, dataSize, 4);
+  ba.append(QByteArray(dataSize, '\0'));
+  return ba;
+}
+
+/** DSD stream file with silence. */
+QByteArray createDsf()
+{
+  const int blockSize = 4096;
+  const int numChannels = 2;
+  const int dataSize = blockSize * numChannels;
+  QByteArray ba("DSD ", 4);
+  appendLE(ba, 28, 8);
+  appendLE(ba, 28 + 52 + 12 + dataSize, 8); // total file size
+  appendLE(ba, 0, 8);                       // metadata pointer
+  ba.append("fmt ", 4);
+  appendLE(ba, 52, 8);
+  appendLE(ba, 1, 4);               // format version
+  appendLE(ba, 0, 4);               // DSD raw
+  appendLE(ba, 2, 4);               // stereo
+  appendLE(ba, numChannels, 4);
+  appendLE(ba, 2822400, 4);         // sampling frequency
+  appendLE(ba, 1, 4);               // bits per sample
+  appendLE(ba, blockSize * 8, 8);   // sample count
+  appendLE(ba, blockSize, 4);
+  appendLE(ba, 0, 4);
+  ba.append("data", 4);
+  appendLE(ba, 12 + dataSize, 8);
+  ba.append(QByteArray(dataSize, '\0'));
+  return ba;
+}
+
+/** Container format of fixtures. */
+struct ContainerFormat {
+  const char* extension;         /**< file extension */
+  QByteArray (*create)();        /**< creates file without tags */
+};
+
+const ContainerFormat containerFormats[] = {
+  { ".mp3", createMp3 },
+  { ".flac", createFlac },
+  { ".opus", createOpus },
+  { ".m4a", createM4a },
+  { ".wav", createWav },
+  { ".dsf", createDsf }
+};
+
+/**
+ * Runs the benchmarks and collects the results.
+ */
+class Benchmark {
+public:
+  /**
+   * Constructor.
+   * @param app application with loaded plugins
+   * @param dir directory for fixtures
+   * @param iterations number of iterations per measurement
+   */
+  Benchmark(Kid3Application* app, const QString& dir, int iterations)
+    : m_app(app), m_dir(dir), m_iterations(iterations) {
+  }
+
+  /**
+   * Create fixtures for all formats and tag variants.
+   * @return true if ok.
+   */
+  bool createFixtures();
+
+  /**
+   * Measure all operations for all fixtures and plugins.
+   */
+  void run();
+
+  /**
+   * Get results.
+   * @return JSON object with results.
+   */
+  QJsonObject results() const;
+
+  /**
+   * Get backends which have not been measured.
+   * @return names of plugins which are not loaded and keys of tagged file
+   * formats without supported fixtures.
+   */
+  QStringList skippedBackends() const { return m_skipped; }
+
+private:
+  QPersistentModelIndex indexOf(const QString& fileName) const;
+  void measure(const QString& plugin, const QString& fileName,
+               const char* operation, const std::function<void()>& func);
+
+  Kid3Application* m_app;
+  QString m_dir;
+  int m_iterations;
+  QStringList m_fixtures;
+  QStringList m_skipped;
+  QJsonArray m_results;
+};
+
+QPersistentModelIndex Benchmark::indexOf(const QString& fileName) const
+{
+  return QPersistentModelIndex(m_app->getFileSystemModel()->index(
+                                 QDir(m_dir).filePath(fileName)));
+}
+
+bool Benchmark::createFixtures()
+{
+  for (const auto& [extension, create] : containerFormats) {
+    const QByteArray data = create();
+    for (const auto& variant : tagVariants) {
+      const QString fileName = QLatin1String(variant.name) +
+          QLatin1String(extension);
+      QFile file(QDir(m_dir).filePath(fileName));
+      if (!file.open(QIODevice::WriteOnly) ||
+          file.write(data) != data.size()) {
+        return false;
+      }
+      m_fixtures.append(fileName);
+    }
+  }
+
+  QEventLoop eventLoop;
+  QObject::connect(m_app, &Kid3Application::directoryOpened,
+                   &eventLoop, &QEventLoop::quit);
+  if (!m_app->openDirectory({m_dir})) {
+    return false;
+  }
+  eventLoop.exec();
+
+  // The tags are written with the first plugin supporting the format.
+  for (const QString& fileName : std::as_const(m_fixtures)) {
+    const TagVariant* variant = tagVariants;
+    while (!fileName.startsWith(QLatin1String(variant->name))) {
+      ++variant;
+    }
+    QScopedPointer<TaggedFile> taggedFile(
+          TaggedFileSystemModel::createTaggedFile(fileName,
+                                                  indexOf(fileName)));
+    if (!taggedFile) {
+      continue;
+    }
+    taggedFile->readTags(false);
+    FrameCollection frames;
+    frames.setValue(Frame::FT_Title, QLatin1String("Title"));
+    frames.setValue(Frame::FT_Artist, QLatin1String("Artist"));
+    frames.setValue(Frame::FT_Album, QLatin1String("Album"));
+    frames.setValue(Frame::FT_Comment, QLatin1String("Comment"));
+    frames.setValue(Frame::FT_Date, QLatin1String("2026"));
+    frames.setValue(Frame::FT_Track, QLatin1String("1"));
+    frames.setValue(Frame::FT_Genre, QLatin1String("Pop"));
+    for (int i = 0; i < variant->numFrames; ++i) {
+      frames.setValue(extraFrameTypes[i % std::size(extraFrameTypes)],
+                      QString(variant->valueLength, QLatin1Char('a' + i % 26)));
+    }
+    if (variant->pictureSize > 0) {
+      frames.insert(PictureFrame(QByteArray(variant->pictureSize, '\x55')));
+    }
+    FOR_ALL_TAGS(tagNr) {
+      if (tagNr != Frame::Tag_1 && taggedFile->isTagSupported(tagNr)) {
+        taggedFile->setFrames(tagNr, frames, false);
+        break;
+      }
+    }
+    bool renamed = false;
+    taggedFile->writeTags(false, &renamed, false);
+  }
+  return true;
+}
+
+void Benchmark::measure(const QString& plugin, const QString& fileName,
+                        const char* operation,
+                        const std::function<void()>& func)
+{
+  QElapsedTimer timer;
+  timer.start();
+  for (int i = 0; i < m_iterations; ++i) {
+    func();
+  }
+  const qint64 ns = timer.nsecsElapsed();
+  const int dotPos = fileName.indexOf(QLatin1Char('.'));
+  m_results.append(QJsonObject{
+    {QLatin1String("plugin"), plugin},
+    {QLatin1String("format"), fileName.mid(dotPos + 1)},
+    {QLatin1String("variant"), fileName.left(dotPos)},
+    {QLatin1String("operation"), QLatin1String(operation)},
+    {QLatin1String("iterations"), m_iterations},
+    {QLatin1String("nsPerOperation"),
+     static_cast<double>(ns) / m_iterations},
+    {QLatin1String("operationsPerSecond"),
+     ns > 0 ? 1.0e9 * m_iterations / ns : 0.0}
+  });
+}
+
+void Benchmark::run()
+{
+  FileFilter fileFilter;
+  fileFilter.setFilterExpression(QLatin1String(
+      "%{artist} contains \"Art\" and not %{title} equals \"x\""));
+  fileFilter.initParser();
+  const QString format(QLatin1String("%{artist} - %{album}/%{track} %{title}"));
+
+  // Plugins which are available but not loaded, e.g. because they are
+  // disabled.
+  QStringList loadedPlugins;
+  const auto factories = TaggedFileSystemModel::taggedFileFactories();
+  for (ITaggedFileFactory* factory : factories) {
+    loadedPlugins.append(factory->name());
+  }
+  const QStringList availablePlugins = TagConfig::instance().availablePlugins();
+  for (const QString& plugin : availablePlugins) {
+    if (!loadedPlugins.contains(plugin)) {
+      m_skipped.append(plugin);
+    }
+  }
+
+  for (ITaggedFileFactory* factory : factories) {
+    const auto keys = factory->taggedFileKeys();
+    for (const QString& key : keys) {
+      const QStringList extensions = factory->supportedFileExtensions(key);
+      bool measured = false;
+      for (const QString& fileName : std::as_const(m_fixtures)) {
+        const QString extension = fileName.mid(fileName.indexOf(QLatin1Char('.')));
+        if (!extensions.contains(extension)) {
+          continue;
+        }
+        const QPersistentModelIndex index = indexOf(fileName);
+        QScopedPointer<TaggedFile> taggedFile(
+              factory->createTaggedFile(key, fileName, index));
+        if (!taggedFile) {
+          continue;
+        }
+        measured = true;
+        measure(key, fileName, "readTags", [factory, &key, &fileName, &index] {
+          QScopedPointer<TaggedFile> file(
+                factory->createTaggedFile(key, fileName, index));
+          file->readTags(false);
+        });
+
+        taggedFile->readTags(false);
+        measure(key, fileName, "getAllFrames", [&taggedFile] {
+          FrameCollection frames;
+          taggedFile->getAllFrames(Frame::Tag_2, frames);
+        });
+        measure(key, fileName, "filter", [&taggedFile, &fileFilter] {
+          fileFilter.filter(*taggedFile);
+        });
+        measure(key, fileName, "formatString", [&taggedFile, &format] {
+          ImportTrackData(*taggedFile, Frame::TagV2V1).formatString(format);
+        });
+
+        FrameCollection tagFrames;
+        taggedFile->getAllFrames(Frame::Tag_2, tagFrames);
+        measure(key, fileName, "mergeFrames", [&tagFrames] {
+          FrameCollection frames;
+          frames.setValue(Frame::FT_Title, QLatin1String("Title"));
+          frames.merge(tagFrames);
+        });
+        measure(key, fileName, "filterDifferentFrames", [&tagFrames] {
+          FrameCollection frames(tagFrames);
+          FrameCollection others(tagFrames);
+          others.setValue(Frame::FT_Artist, QLatin1String("Other"));
+          frames.filterDifferent(others);
+        });
+        int found = 0;
+        measure(key, fileName, "findFramesByName", [&tagFrames, &found] {
+          for (const char* name : {"Artist", "track", "Missing"}) {
+            if (tagFrames.findByName(QLatin1String(name)) != tagFrames.cend()) {
+              ++found;
+            }
+          }
+        });
+        qint64 valueLength = 0;
+        measure(key, fileName, "iterateFrames", [&tagFrames, &valueLength] {
+          for (const Frame& frame : tagFrames) {
+            valueLength += frame.getValue().length();
+          }
+        });
+
+        int nr = 0;
+        measure(key, fileName, "writeTags", [&taggedFile, &nr] {
+          FrameCollection frames;
+          frames.setValue(Frame::FT_Title,
+                          QLatin1String("Title ") + QString::number(++nr % 2));
+          taggedFile->setFrames(Frame::Tag_2, frames, false);
+          bool renamed = false;
+          taggedFile->writeTags(true, &renamed, false);
+        });
+        taggedFile->closeFileHandle();
+      }
+      if (!measured) {
+        m_skipped.append(key);
+      }
+    }
+  }
+}
+
+QJsonObject Benchmark::results() const
+{
+  return QJsonObject{
+    {QLatin1String("version"), QLatin1String(VERSION)},
+    {QLatin1String("qtVersion"), QLatin1String(qVersion())},
+    {QLatin1String("iterations"), m_iterations},
+    {QLatin1String("skippedBackends"), QJsonArray::fromStringList(m_skipped)},
+    {QLatin1String("results"), m_results}
+  };
+}
+
+}
+
+/**
+ * Main program for benchmark.
+ *
+ * @param argc number of arguments including command name
+ * @param argv arguments, argv[0] is command name
+ *
+ * @return 0 if ok.
+ */
+int main(int argc, char* argv[])
+{
+  QCoreApplication app(argc, argv);
+  QCoreApplication::setApplicationName(QLatin1String("kid3-bench"));
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription(QLatin1String(
+      "Measure tag read and write throughput of the metadata plugins."));
+  parser.addHelpOption();
+  QCommandLineOption iterationsOption(
+        {QLatin1String("n"), QLatin1String("iterations")},
+        QLatin1String("Number of iterations per measurement."),
+        QLatin1String("count"), QLatin1String("20"));
+  QCommandLineOption outputOption(
+        {QLatin1String("o"), QLatin1String("output")},
+        QLatin1String("Write JSON results to file instead of stdout."),
+        QLatin1String("file"));
+  parser.addOption(iterationsOption);
+  parser.addOption(outputOption);
+  parser.process(app);
+  const int iterations = qMax(parser.value(iterationsOption).toInt(), 1);
+
+  QTemporaryDir tempDir;
+  if (!tempDir.isValid()) {
+    qCritical("Could not create temporary directory");
+    return 1;
+  }
+  // Use default settings which are not stored in the user configuration.
+  const QString configFile = tempDir.filePath(QLatin1String("kid3.ini"));
+  qputenv("KID3_CONFIG_FILE", QFile::encodeName(configFile));
+  {
+    // Load all metadata plugins, some are disabled by default.
+    QSettings settings(configFile, QSettings::IniFormat);
+    settings.setValue(QLatin1String("Tags/DisabledPlugins"), QStringList());
+  }
+  const QString fixtureDir = tempDir.filePath(QLatin1String("fixtures"));
+  QDir().mkpath(fixtureDir);
+
+  CorePlatformTools platformTools;
+  auto kid3App = new Kid3Application(&platformTools);
+  int rc = 0;
+  {
+    Benchmark benchmark(kid3App, fixtureDir, iterations);
+    if (benchmark.createFixtures()) {
+      benchmark.run();
+      const QStringList skipped = benchmark.skippedBackends();
+      for (const QString& backend : skipped) {
+        qWarning("Backend %s was not measured", qPrintable(backend));
+      }
+      const QByteArray json =
+          QJsonDocument(benchmark.results()).toJson(QJsonDocument::Indented);
+      if (parser.isSet(outputOption)) {
+        QFile file(parser.value(outputOption));
+        if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size()) {
+          qCritical("Could not write %s", qPrintable(file.fileName()));
+          rc = 1;
+        }
+      } else {
+        QTextStream(stdout) << json;
+      }
+    } else {
+      qCritical("Could not create fixtures in %s", qPrintable(fixtureDir));
+      rc = 1;
+    }
+  }
+  delete kid3App;
+  return rc;
+}
@@ -145,6 +145,14 @@ def create_test_file(filename):
             b'\xe3#\xe4\xe2\xe3f\xe4\x0f\xe4\xb0\xe4O\xe4!\xe5o\xe4\x94\xe5\xa3\xe4\x07\xe6\xbc\xe4X\xe6\xd2\xe4' \
             b'\xc3\xe6\xd6\xe4\x18\xe7\xf1\xe4\x83\xe7\t\xe5\xed\xe7 \xe5_\xe88\xe5\xce\xe8r\xe5C\xe9\xae\xe5\xc9' \
             b'\xe9\xe9\xe5o\xea(\xe6\x06\xeb\x82\xe6\xac\xeb'
+    elif ext == '.ogg':
+        d = b'OggS\x00\x02\x00\x00\x00\x00\x00\x00\x00\x00DI3K\x00\x00\x00\x00\\\xea\x99\xac\x01\x1e\x01vorbis\x00' \
+            b'\x00\x00\x00\x01D\xac\x00\x00\x00\x00\x00\x00\x00\xfa\x00\x00\x00\x00\x00\x00\x88\x01OggS\x00\x00\x00' \
+            b'\x00\x00\x00\x00\x00\x00\x00DI3K\x01\x00\x00\x00O\xc6h\x8e\x02D4\x03vorbis4\x00\x00\x00Xiph.Org libVorbi' \
+            b's I 20200704 (Reducing Environment)\x00\x00\x00\x00\x01\x05vorbis\x00BCV\x01\x00\x02\x00\x00\x00\x00\x00' \
+            b'\x00\x00\x10\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00' \
+            b'\x00\x00\x00\x00\x00\x00\x01OggS\x00\x04\x80\x00\x00\x00\x00\x00\x00\x00DI3K\x02\x00\x00\x00\xefT\xc2' \
+            b'\xa6\x02\x02\x02\x00\x00\x00\x00'
     elif ext == '.opus':
         d = b'OggS\x00\x02\x00\x00\x00\x00\x00\x00\x00\x00\x91d\x87S\x00\x00\x00\x00\xfb\x1f\xdfC\x01\x13OpusHead' \
             b'\x01\x01d\x01D\xac\x00\x00\x00\x00\x00OggS\x00\x00\x00\x00\x00\x00\x00\x00\x00\x00\x91d\x87S\x01\x00' \
@@ -33,6 +33,12 @@
 #include "testmusicbrainzreleaseimporter.h"
 #include "testdiscogsimporter.h"
 #include "testamazonimporter.h"
+#include "testfilefilter.h"
+#include "testframecollection.h"
+#include "testtagcache.h"
+#include "testtagsearchindex.h"
+#include "testhttprequestscheduler.h"
+#include "testhttpresponsecache.h"
 
 /**
  * Main routine for test runner.
@@ -52,6 +58,12 @@ int main(int argc, char *argv[])
     new TestMusicBrainzReleaseImporter,
     new TestDiscogsImporter,
     new TestAmazonImporter,
+    new TestFileFilter,
+    new TestFrameCollection,
+    new TestTagCache,
+    new TestTagSearchIndex,
+    new TestHttpRequestScheduler,
+    new TestHttpResponseCache,
     nullptr
   };
 
@@ -7,6 +7,8 @@ import subprocess
 import tempfile
 import platform
 import json
+import socket
+import time
 from kid3testsupport import kid3_cli_path, call_kid3_cli, create_test_file
 
 
@@ -18,6 +20,51 @@ def setUpModule():
     os.environ['LANG'] = 'en_US.UTF-8'
 
 
+def ogg_crc(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 24
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x04c11db7 if crc & 0x80000000
+                   else crc << 1) & 0xffffffff
+    return crc
+
+
+def read_ogg_pages(filename):
+    """Read the pages of an Ogg file, their checksums are verified.
+
+    Returns the list of pages as (header, body) byte tuples and the list of
+    packets.
+    """
+    with open(filename, 'rb') as fh:
+        data = fh.read()
+    pages = []
+    packets = []
+    packet = b''
+    pos = 0
+    while pos < len(data):
+        if data[pos:pos + 4] != b'OggS':
+            raise ValueError('no Ogg page at %d' % pos)
+        num_segments = data[pos + 26]
+        lacing = data[pos + 27:pos + 27 + num_segments]
+        header = data[pos:pos + 27 + num_segments]
+        body = data[pos + 27 + num_segments:
+                    pos + 27 + num_segments + sum(lacing)]
+        if ogg_crc(header[:22] + b'\0\0\0\0' + header[26:] + body) != \
+                int.from_bytes(header[22:26], 'little'):
+            raise ValueError('invalid checksum of page at %d' % pos)
+        start = 0
+        for length in lacing:
+            packet += body[start:start + length]
+            start += length
+            if length < 255:
+                packets.append(packet)
+                packet = b''
+        pages.append((header, body))
+        pos += len(header) + len(body)
+    return pages, packets
+
+
 class CliFunctionsTestCase(unittest.TestCase):
     def test_help(self):
         full_help = call_kid3_cli('-h')
@@ -400,6 +447,66 @@ class CliFunctionsTestCase(unittest.TestCase):
                 ba = jpgfh.read()
                 self.assertEqual(ba, jpg_bytes)
 
+    def test_ogg_vorbis_in_place(self):
+        plugins_dir = os.path.join(os.path.dirname(os.path.dirname(
+            os.path.dirname(kid3_cli_path()))), 'plugins')
+        if not os.path.isdir(plugins_dir) or not any(
+                'oggflacmetadata' in name.lower()
+                for name in os.listdir(plugins_dir)):
+            self.skipTest('OggFlacMetadata plugin not found')
+        with tempfile.TemporaryDirectory() as tmpdir:
+            oggpath = os.path.join(tmpdir, 'test.ogg')
+            create_test_file(oggpath)
+            # The comment header of the test file has no padding, so it has
+            # to be written by vcedit, which adds padding.
+            call_kid3_cli(['-c', 'set title "First Title"', oggpath])
+            pages, packets = read_ogg_pages(oggpath)
+            self.assertEqual(len(packets), 5)
+            self.assertTrue(packets[1].startswith(b'\x03vorbis'))
+            self.assertTrue(packets[1].endswith(b'\x01' + bytes(1024)))
+            audio_page = pages[-1]
+            # The padded vcedit output has to be readable by libvorbisfile.
+            self.assertRegex(
+                call_kid3_cli(['-c', 'get', oggpath]),
+                'File: Ogg Vorbis [^\\n]+ kbps 44100 Hz 1 Channels\n'
+                '  Name: test\\.ogg\n'
+                'Tag 2: Vorbis\n'
+                '  Title                   First Title\n')
+
+            # The second write fits into the padding and is done in place.
+            stat_before = os.stat(oggpath)
+            call_kid3_cli(['-c', 'set title "Second Title"',
+                           '-c', 'set artist "An Artist"', oggpath])
+            stat_after = os.stat(oggpath)
+            self.assertEqual(stat_after.st_ino, stat_before.st_ino)
+            self.assertEqual(stat_after.st_size, stat_before.st_size)
+            pages, in_place_packets = read_ogg_pages(oggpath)
+            self.assertEqual(len(in_place_packets[1]), len(packets[1]))
+            self.assertEqual(in_place_packets[0], packets[0])
+            self.assertEqual(in_place_packets[2:], packets[2:])
+            self.assertEqual(pages[-1], audio_page)
+            self.assertRegex(
+                call_kid3_cli(['-c', 'get', oggpath]),
+                'File: Ogg Vorbis [^\\n]+ kbps 44100 Hz 1 Channels\n'
+                '  Name: test\\.ogg\n'
+                'Tag 2: Vorbis\n'
+                '  Title                   Second Title\n'
+                '  Artist                  An Artist\n')
+
+            # A comment larger than the packet with its padding falls back
+            # to vcedit, which writes a new file.
+            long_comment = 'x' * 3000
+            call_kid3_cli(['-c', 'set comment "%s"' % long_comment, oggpath])
+            self.assertNotEqual(os.stat(oggpath).st_ino, stat_before.st_ino)
+            pages, packets = read_ogg_pages(oggpath)
+            self.assertGreater(len(packets[1]), len(in_place_packets[1]))
+            self.assertTrue(packets[1].endswith(b'\x01' + bytes(1024)))
+            self.assertEqual(packets[3:], in_place_packets[3:])
+            self.assertEqual(call_kid3_cli(['-c', 'get title',
+                                            '-c', 'get artist',
+                                            '-c', 'get comment', oggpath]),
+                             'Second Title\nAn Artist\n%s\n' % long_comment)
+
     def test_frame_selection(self):
         with tempfile.TemporaryDirectory() as tmpdir:
             test1path = os.path.join(tmpdir, 'test1.mp3')
@@ -860,6 +967,175 @@ class CliFunctionsTestCase(unittest.TestCase):
                 ['-c', 'get', os.path.join(albumdir, '*.mp3')]),
                 expected)
 
+    def test_stats(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            mp3path = os.path.join(tmpdir, 'test.mp3')
+            create_test_file(mp3path)
+            lines = call_kid3_cli(
+                ['-c', 'stats off', '-c', 'stats on', '-c', 'stats reset',
+                 '-c', 'stats', '-c', 'stats off', mp3path]).splitlines()
+            self.assertEqual(
+                [line for line in lines if not line.startswith('  ')],
+                ['Statistics: off', 'Statistics: on', 'Statistics: on',
+                 'Statistics: on', 'Statistics: off'])
+
+    def test_replace(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            mp3path = os.path.join(tmpdir, 'test.mp3')
+            create_test_file(mp3path)
+            other_path = os.path.join(tmpdir, 'other.mp3')
+            create_test_file(other_path)
+            call_kid3_cli(['-c', 'set title "Foo Bar Foo" 2', mp3path])
+            call_kid3_cli(['-c', 'set title "Other" 2', other_path])
+            self.assertEqual(call_kid3_cli(
+                ['-c', 'replace foo Baz',
+                 '-c', 'get title', mp3path]),
+                'Replaced: 2, Files: 1\n'
+                'Baz Bar Baz\n')
+            self.assertEqual(call_kid3_cli(
+                ['-c', 'replace baz Qux case',
+                 '-c', 'replace "^Baz" Start regexp',
+                 '-c', 'get title', mp3path]),
+                'Replaced: 0, Files: 0\n'
+                'Replaced: 1, Files: 1\n'
+                'Start Bar Baz\n')
+            self.assertEqual(call_kid3_cli(['-c', 'get title', other_path]),
+                             'Other\n')
+
+    def test_json_lines(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            self.assertEqual(
+                [json.loads(line) for line in call_kid3_cli(
+                    ['--json-lines', '-c', 'ls', tmpdir]).splitlines()],
+                [{'count': 0, 'done': True}])
+            apath = os.path.join(tmpdir, 'a.mp3')
+            bpath = os.path.join(tmpdir, 'b.mp3')
+            create_test_file(apath)
+            create_test_file(bpath)
+            call_kid3_cli(['-c', 'set title "A Title" 2', apath])
+
+            def parse_lines(output):
+                results = []
+                for line in output.splitlines():
+                    result = json.loads(line)
+                    if 'path' in result:
+                        self.assertEqual(os.path.basename(result['path']),
+                                         result['fileName'])
+                        del result['path']
+                    results.append(result)
+                return results
+
+            self.assertEqual(parse_lines(call_kid3_cli(
+                ['--json-lines', '-c', 'ls', apath])),
+                [{'changed': False, 'fileName': 'a.mp3', 'selected': True,
+                  'tags': [2]},
+                 {'changed': False, 'fileName': 'b.mp3', 'selected': False,
+                  'tags': []},
+                 {'count': 2, 'done': True}])
+            self.assertEqual(parse_lines(call_kid3_cli(
+                ['--json-lines', '-c', 'get title 2', tmpdir])),
+                [{'fileName': 'a.mp3', 'value': 'A Title'},
+                 {'fileName': 'b.mp3'},
+                 {'count': 2, 'done': True}])
+            # All lines of a JSON request contain its ID.
+            self.assertEqual(parse_lines(call_kid3_cli(
+                ['--json-lines',
+                 '-c', '{"jsonrpc":"2.0","id":"7","method":"get",'
+                       '"params":["title",2]}', tmpdir])),
+                [{'fileName': 'a.mp3', 'id': '7', 'value': 'A Title'},
+                 {'fileName': 'b.mp3', 'id': '7'},
+                 {'count': 2, 'done': True, 'id': '7'},
+                 {'id': '7', 'jsonrpc': '2.0', 'result': None}])
+
+    @unittest.skipIf(platform.system() == 'Windows' or
+                     not hasattr(socket, 'AF_UNIX'),
+                     'local server does not use Unix domain sockets')
+    def test_serve(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            mp3path = os.path.join(tmpdir, 'test.mp3')
+            create_test_file(mp3path)
+            call_kid3_cli(['-c', 'set title "A Title" 2', mp3path])
+            sockpath = os.path.join(tmpdir, 'kid3.sock')
+            p = subprocess.Popen([kid3_cli_path(), '--serve', sockpath,
+                                  '--json-lines', mp3path],
+                                 stdout=subprocess.PIPE,
+                                 stderr=subprocess.PIPE)
+            try:
+                def connect():
+                    for _ in range(100):
+                        sock = socket.socket(socket.AF_UNIX,
+                                             socket.SOCK_STREAM)
+                        try:
+                            sock.connect(sockpath)
+                            return sock
+                        except OSError:
+                            sock.close()
+                            time.sleep(0.1)
+                    self.fail('Server not listening on ' + sockpath)
+
+                def request(fh, line):
+                    # Read the lines of the response up to the one with the
+                    # result of the request.
+                    fh.write(line + '\n')
+                    fh.flush()
+                    results = []
+                    while True:
+                        rsp = fh.readline()
+                        self.assertTrue(rsp)
+                        result = json.loads(rsp)
+                        if 'path' in result:
+                            self.assertEqual(
+                                os.path.realpath(result.pop('path')),
+                                os.path.realpath(mp3path))
+                        results.append(result)
+                        if 'result' in result or 'error' in result:
+                            return results
+
+                with connect() as sock1, connect() as sock2:
+                    fh1 = sock1.makefile('rw', encoding='utf-8')
+                    fh2 = sock2.makefile('rw', encoding='utf-8')
+                    self.assertEqual(
+                        request(fh1, '{"method":"get","params":["title",2]}'),
+                        [{'fileName': 'test.mp3', 'value': 'A Title'},
+                         {'count': 1, 'done': True},
+                         {'result': None}])
+                    # Changes are kept by the server for the next requests.
+                    self.assertEqual(
+                        request(fh2, '{"jsonrpc":"2.0","id":"2",'
+                                '"method":"set",'
+                                '"params":["title","New Title",2]}'),
+                        [{'id': '2', 'jsonrpc': '2.0', 'result': None}])
+                    self.assertEqual(
+                        request(fh1, '{"jsonrpc":"2.0","id":"3",'
+                                '"method":"get","params":["title",2]}'),
+                        [{'fileName': 'test.mp3', 'id': '3',
+                          'value': 'New Title'},
+                         {'count': 1, 'done': True, 'id': '3'},
+                         {'id': '3', 'jsonrpc': '2.0', 'result': None}])
+                    self.assertEqual(
+                        request(fh2, '{"method":"revert"}'),
+                        [{'result': None}])
+                    fh2.write('exit\n')
+                    fh2.flush()
+                p.wait(timeout=10)
+            finally:
+                if p.poll() is None:
+                    p.kill()
+                p.communicate()
+            self.assertEqual(p.returncode, 0)
+            self.assertEqual(call_kid3_cli(['-c', 'get title', mp3path]),
+                             'A Title\n')
+
+    def test_serve_without_socket(self):
+        for args in (['--serve'], ['--serve', '-c', 'ls'],
+                     ['--serve', '--json-lines']):
+            p = subprocess.Popen([kid3_cli_path()] + args,
+                                 stdout=subprocess.PIPE,
+                                 stderr=subprocess.PIPE)
+            stdout, stderr = p.communicate(timeout=10)
+            self.assertIn(b'kid3-cli --serve socket', stderr)
+            self.assertEqual(p.returncode, 1)
+
 
 class CliFunctionsJsonTestCase(unittest.TestCase):
     def test_invalid(self):
@@ -958,6 +1234,45 @@ class CliFunctionsJsonTestCase(unittest.TestCase):
                 '{"result":{"files":[{"changed":true,"fileName":"test.mp3",'
                 '"selected":true,"tags":[2]}]}}\n')
 
+    def test_stats(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            mp3path = os.path.join(tmpdir, 'test.mp3')
+            create_test_file(mp3path)
+            env = dict(os.environ)
+            env['KID3_STATISTICS'] = '1'
+            out = subprocess.check_output(
+                [kid3_cli_path(),
+                 '-c', '{"method":"stats"}',
+                 '-c', '{"method":"stats","params":["reset"]}',
+                 '-c', '{"method":"stats","params":["off"]}',
+                 mp3path], env=env, universal_newlines=True)
+            results = [json.loads(line) for line in out.splitlines()]
+            self.assertEqual(len(results), 3)
+            stats = results[0]['result']['statistics']
+            self.assertTrue(stats['enabled'])
+            read_tags = stats['operations']['readTags']
+            self.assertGreaterEqual(read_tags['count'], 1)
+            for key in ('totalMs', 'meanUs', 'maxUs', 'p50Us', 'p90Us',
+                        'p99Us', 'histogram'):
+                self.assertIn(key, read_tags)
+            self.assertIsInstance(stats['counters'], dict)
+            stats = results[1]['result']['statistics']
+            self.assertTrue(stats['enabled'])
+            self.assertNotIn('readTags', stats['operations'])
+            self.assertFalse(results[2]['result']['statistics']['enabled'])
+
+    def test_replace(self):
+        with tempfile.TemporaryDirectory() as tmpdir:
+            mp3path = os.path.join(tmpdir, 'test.mp3')
+            create_test_file(mp3path)
+            self.assertEqual(call_kid3_cli(
+                ['-c', '{"method":"set","params":["title","Foo Bar",2]}',
+                 '-c', '{"method":"replace","params":["Bar","Baz"]}',
+                 '-c', '{"method":"get","params":["title",2]}', mp3path]),
+                '{"result":null}\n'
+                '{"result":{"replaced":{"count":1,"files":1}}}\n'
+                '{"result":"Foo Baz"}\n')
+
 
 if __name__ == '__main__':
     unittest.main()
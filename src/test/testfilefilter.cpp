@@ -0,0 +1,198 @@
+/**
+ * \file testfilefilter.cpp
+ * Test filtering files with filter expressions.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testfilefilter.h"
+#include <QTest>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+#include <QScopedPointer>
+#include "dummysettings.h"
+#include "dummytaggedfile.h"
+#include "configstore.h"
+#include "tagconfig.h"
+#include "coretaggedfileiconprovider.h"
+#include "taggedfilesystemmodel.h"
+#include "filefilter.h"
+#include "pictureframe.h"
+
+TestFileFilter::TestFileFilter(QObject* parent)
+  : QObject(parent), m_settings(nullptr), m_configStore(nullptr),
+    m_dir(nullptr), m_iconProvider(nullptr), m_model(nullptr)
+{
+  if (!ConfigStore::instance()) {
+    m_settings = new DummySettings;
+    m_configStore = new ConfigStore(m_settings);
+  }
+}
+
+TestFileFilter::~TestFileFilter()
+{
+  delete m_configStore;
+  delete m_settings;
+}
+
+void TestFileFilter::initTestCase()
+{
+  m_dir = new QTemporaryDir;
+  QVERIFY(m_dir->isValid());
+  m_iconProvider = new CoreTaggedFileIconProvider;
+  m_model = new TaggedFileSystemModel(m_iconProvider);
+  m_model->setRootPath(m_dir->path());
+}
+
+void TestFileFilter::cleanupTestCase()
+{
+  delete m_model;
+  m_model = nullptr;
+  delete m_iconProvider;
+  m_iconProvider = nullptr;
+  delete m_dir;
+  m_dir = nullptr;
+}
+
+DummyTaggedFile* TestFileFilter::createTaggedFile(const QString& fileName)
+{
+  const QString filePath = QDir(m_dir->path()).filePath(fileName);
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return nullptr;
+  }
+  file.close();
+  auto taggedFile = new DummyTaggedFile(
+        QPersistentModelIndex(m_model->index(filePath)));
+  taggedFile->readTags(false);
+  return taggedFile;
+}
+
+void TestFileFilter::testMarked()
+{
+  TagConfig& tagCfg = TagConfig::instance();
+  const bool markOversizedPictures = tagCfg.markOversizedPictures();
+  const int maximumPictureSize = tagCfg.maximumPictureSize();
+  tagCfg.setMarkOversizedPictures(true);
+  tagCfg.setMaximumPictureSize(100);
+
+  // The marked state is only known after the frames have been fetched,
+  // so an expression using only %w must still fetch them.
+  int fileNr = 0;
+  for (const char* expression : {"%{marked} equals 1", "%w equals 1"}) {
+    ++fileNr;
+    QScopedPointer<DummyTaggedFile> largeFile(createTaggedFile(
+        QString(QLatin1String("large%1.mp3")).arg(fileNr)));
+    QScopedPointer<DummyTaggedFile> smallFile(createTaggedFile(
+        QString(QLatin1String("small%1.mp3")).arg(fileNr)));
+    QVERIFY(largeFile && smallFile);
+    PictureFrame largePicture(QByteArray(1000, 'x'));
+    largeFile->addFrame(Frame::Tag_2, largePicture);
+    PictureFrame smallPicture(QByteArray(10, 'x'));
+    smallFile->addFrame(Frame::Tag_2, smallPicture);
+    QVERIFY(!largeFile->isMarked());
+
+    FileFilter fileFilter;
+    fileFilter.setFilterExpression(QLatin1String(expression));
+    fileFilter.initParser();
+    bool ok = false;
+    QVERIFY(fileFilter.filter(*largeFile, &ok));
+    QVERIFY(ok);
+    QVERIFY(largeFile->isMarked());
+    QVERIFY(!fileFilter.filter(*smallFile, &ok));
+    QVERIFY(ok);
+  }
+
+  tagCfg.setMarkOversizedPictures(markOversizedPictures);
+  tagCfg.setMaximumPictureSize(maximumPictureSize);
+}
+
+void TestFileFilter::testExpressions_data()
+{
+  QTest::addColumn<QString>("expression");
+  QTest::addColumn<bool>("result");
+  QTest::addColumn<bool>("ok");
+
+  QTest::newRow("empty") << QString() << true << true;
+  QTest::newRow("constant") << "1" << true << true;
+  QTest::newRow("tag2 or tag1") << "%{title} equals Two" << true << true;
+  QTest::newRow("tag1") << "%1{title} equals One" << true << true;
+  QTest::newRow("tag2") << "%2{title} equals One" << false << true;
+  QTest::newRow("fallback to tag1") << "%{artist} equals Art1" << true << true;
+  QTest::newRow("no fallback") << "%2{artist} equals Art1" << false << true;
+  QTest::newRow("short code") << "%t equals Two" << true << true;
+  QTest::newRow("quoted") << "%{title} equals \"Two\"" << true << true;
+  QTest::newRow("literal text") << "\"%1{title}-%2{title}\" equals One-Two"
+                                << true << true;
+  QTest::newRow("contains") << "%{title} contains w" << true << true;
+  QTest::newRow("contained") << "w contains %{title}" << false << true;
+  QTest::newRow("matches") << "%{title} matches ^T.o$" << true << true;
+  QTest::newRow("does not match") << "%1{title} matches ^T" << false << true;
+  QTest::newRow("pattern from tag") << "Two matches %{title}" << true << true;
+  QTest::newRow("file name") << "%f contains .mp3" << true << true;
+  QTest::newRow("not") << "not (%1{title} equals One)" << false << true;
+  QTest::newRow("and")
+      << "%1{title} equals One and %2{title} equals Two" << true << true;
+  QTest::newRow("and false")
+      << "%1{title} equals One and %2{title} equals One" << false << true;
+  QTest::newRow("or")
+      << "%1{title} equals Two or %2{title} equals Two" << true << true;
+  QTest::newRow("or false")
+      << "%1{title} equals Two or %2{title} equals One" << false << true;
+  QTest::newRow("parentheses")
+      << "not (%{title} equals One or %1{title} equals Two) and 1"
+      << true << true;
+  QTest::newRow("missing operand") << "%{title} equals" << false << false;
+  QTest::newRow("string operand of and") << "%{title} and 1" << false << false;
+  QTest::newRow("string operand of not") << "not %{title}" << false << false;
+}
+
+void TestFileFilter::testExpressions()
+{
+  QFETCH(QString, expression);
+  QFETCH(bool, result);
+  QFETCH(bool, ok);
+
+  QScopedPointer<DummyTaggedFile> taggedFile(
+        createTaggedFile(QLatin1String("expressions.mp3")));
+  QVERIFY(taggedFile);
+  Frame title1(Frame::FT_Title, QLatin1String("One"), QString(), -1);
+  taggedFile->addFrame(Frame::Tag_1, title1);
+  Frame artist1(Frame::FT_Artist, QLatin1String("Art1"), QString(), -1);
+  taggedFile->addFrame(Frame::Tag_1, artist1);
+  Frame title2(Frame::FT_Title, QLatin1String("Two"), QString(), -1);
+  taggedFile->addFrame(Frame::Tag_2, title2);
+
+  // The results are the same as with the evaluation of the RPN stack
+  // used before the expressions were compiled.
+  FileFilter fileFilter;
+  fileFilter.setFilterExpression(expression);
+  fileFilter.initParser();
+  bool filterOk = !ok;
+  QCOMPARE(fileFilter.filter(*taggedFile, &filterOk), result);
+  QCOMPARE(filterOk, ok);
+
+  // The compiled expression can be evaluated repeatedly.
+  QCOMPARE(fileFilter.filter(*taggedFile, &filterOk), result);
+  QCOMPARE(filterOk, ok);
+}
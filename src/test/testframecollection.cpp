@@ -0,0 +1,233 @@
+/**
+ * \file testframecollection.cpp
+ * Test searching and merging frames in a frame collection.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testframecollection.h"
+#include <QTest>
+#include "frame.h"
+
+namespace {
+
+/**
+ * Search for a frame by name as done by FrameCollection::findByName()
+ * before the name comparison was optimized.
+ *
+ * @param frames frame collection
+ * @param name the name of the frame to find
+ *
+ * @return iterator or end() if not found.
+ */
+FrameCollection::const_iterator oldFindByName(const FrameCollection& frames,
+                                              const QString& name)
+{
+  Frame frame(Frame::ExtendedType(name), QLatin1String(""), -1);
+  auto it = frames.find(frame);
+  if (it != frames.cend() || name.isEmpty()) {
+    return it;
+  }
+  QString ucName = name.toUpper().remove(QLatin1Char('/'));
+  int len = ucName.length();
+  for (it = frames.cbegin(); it != frames.cend(); ++it) {
+    const QStringList names{it->getName(), it->getInternalName()};
+    for (const QString& frameName : names) {
+      QString ucFrameName(frameName.toUpper().remove(QLatin1Char('/')));
+#if QT_VERSION >= 0x060000
+      if (ucName == ucFrameName.left(len))
+#else
+      if (ucName == ucFrameName.leftRef(len) &&
+          !(ucName == QLatin1String("RATING") &&
+            ucFrameName == QLatin1String("RATING INFORMATION")))
+#endif
+      {
+        return it;
+      }
+      int nlPos = ucFrameName.indexOf(QLatin1Char('\n'));
+      if (nlPos > 0 && ucName == ucFrameName.mid(nlPos + 1, len)) {
+        return it;
+      }
+    }
+  }
+  return it;
+}
+
+/**
+ * Merge frames as done by FrameCollection::merge() before the insertion
+ * hint was used.
+ *
+ * @param dest frames to merge into
+ * @param frames frames to merge
+ */
+void oldMerge(FrameCollection& dest, const FrameCollection& frames)
+{
+  for (auto otherIt = frames.cbegin(); otherIt != frames.cend(); ++otherIt) {
+    if (auto it = dest.find(*otherIt); it != dest.end()) {
+      QString value(otherIt->getValue());
+      if (auto& frameFound = const_cast<Frame&>(*it);
+          frameFound.getValue().isEmpty() && !value.isEmpty()) {
+        frameFound.setValueIfChanged(value);
+      }
+    } else {
+      Frame frame(*otherIt);
+      frame.setIndex(-1);
+      frame.setValueChanged(true);
+      dest.insert(frame);
+    }
+  }
+}
+
+/**
+ * Get string representation of frames to compare them.
+ * @param frames frame collection
+ * @return one line per frame with name, value, index and changed flag.
+ */
+QStringList framesToStringList(const FrameCollection& frames)
+{
+  QStringList lst;
+  for (const Frame& frame : frames) {
+    lst.append(QString(QLatin1String("%1|%2|%3|%4|%5"))
+               .arg(static_cast<int>(frame.getType()))
+               .arg(frame.getInternalName(), frame.getValue())
+               .arg(frame.getIndex())
+               .arg(frame.isValueChanged() ? 1 : 0));
+  }
+  return lst;
+}
+
+/**
+ * Create frames with standard and other types.
+ * @return frame collection.
+ */
+FrameCollection createFrames()
+{
+  FrameCollection frames;
+  int index = 0;
+  auto add = [&frames, &index](const Frame::ExtendedType& type,
+                               const char* value) {
+    frames.insert(Frame(type, QString::fromUtf8(value), index++));
+  };
+  add(Frame::ExtendedType(Frame::FT_Title, QLatin1String("TIT2")), "Title");
+  add(Frame::ExtendedType(Frame::FT_Artist, QLatin1String("TPE1")), "Artist");
+  add(Frame::ExtendedType(Frame::FT_AlbumArtist, QLatin1String("TPE2")), "");
+  add(Frame::ExtendedType(Frame::FT_Comment, QLatin1String("COMM")), "Comment");
+  add(Frame::ExtendedType(Frame::FT_Track, QLatin1String("TRCK")), "1/2");
+  add(Frame::ExtendedType(Frame::FT_Rating, QLatin1String("POPM")), "3");
+  add(Frame::ExtendedType(Frame::FT_Other,
+                          QLatin1String("TXXX\nCATALOGNUMBER")), "cat");
+  add(Frame::ExtendedType(Frame::FT_Other,
+                          QLatin1String("PRIV\nwww.example.com")), "priv");
+  add(Frame::ExtendedType(Frame::FT_Other,
+                          QLatin1String("Rating Information")), "info");
+  add(Frame::ExtendedType(Frame::FT_Other, QLatin1String("AC/DC Live")), "x");
+  add(Frame::ExtendedType(Frame::FT_Other, QLatin1String("/\nDescr")), "y");
+  add(Frame::ExtendedType(Frame::FT_Other,
+                          QString::fromUtf8("Stra\xc3\x9f" "e")), "z");
+  add(Frame::ExtendedType(Frame::FT_Other,
+                          QString::fromUtf8("WXXX\n\xc3\xa4nderung")), "u");
+  return frames;
+}
+
+}
+
+TestFrameCollection::TestFrameCollection(QObject* parent) : QObject(parent)
+{
+}
+
+void TestFrameCollection::testFindByName_data()
+{
+  QTest::addColumn<QString>("name");
+
+  // None of these names is a display name of an ID3v2 frame, so that
+  // findByName() does not search for the ID of the frame.
+  const char* const names[] = {
+    "Title", "title", "TIT", "tit2", "Artist", "art", "Album Artist",
+    "albumartist", "ALBUM/ARTIST", "Comm", "track", "Track Number", "TRCK",
+    "Rating", "rat", "Rating Info", "popm", "TXXX", "txxx\ncatalog",
+    "CATALOGNUMBER", "catalog", "www.example", "priv", "ACDC", "ac/dc live",
+    "Descr", "DESCR", "STRASSE", "stra\xc3\x9f", "\xc3\x84nderung",
+    "wxxx", "/", "xyzzy", "Title and more"
+  };
+  for (const char* name : names) {
+    QTest::newRow(name) << QString::fromUtf8(name);
+  }
+}
+
+void TestFrameCollection::testFindByName()
+{
+  QFETCH(QString, name);
+
+  const FrameCollection frames = createFrames();
+  auto expected = oldFindByName(frames, name);
+  auto it = frames.findByName(name);
+  if (expected == frames.cend()) {
+    QVERIFY(it == frames.cend());
+  } else {
+    QVERIFY(it != frames.cend());
+    QCOMPARE(it->getIndex(), expected->getIndex());
+  }
+}
+
+void TestFrameCollection::testMerge()
+{
+  const FrameCollection frames = createFrames();
+
+  // Frames with empty values, frames only in the merged collection and
+  // frames with the same type, but a different name.
+  FrameCollection other;
+  int index = 100;
+  for (const Frame& frame : frames) {
+    Frame otherFrame(frame);
+    otherFrame.setIndex(index++);
+    otherFrame.setValue(QLatin1String("other"));
+    other.insert(otherFrame);
+  }
+  other.insert(Frame(Frame::FT_Album, QLatin1String("Album"),
+                     QLatin1String("TALB"), index++));
+  other.insert(Frame(Frame::FT_Genre, QLatin1String("Genre"),
+                     QLatin1String("TCON"), index++));
+  other.insert(Frame(Frame::ExtendedType(Frame::FT_Other,
+                                         QLatin1String("TXXX\nBARCODE")),
+                     QLatin1String("123"), index++));
+  other.insert(Frame(Frame::ExtendedType(Frame::FT_Other,
+                                         QLatin1String("TXXX\nBARCODE")),
+                     QLatin1String("456"), index++));
+
+  FrameCollection expected(frames);
+  oldMerge(expected, other);
+  FrameCollection merged(frames);
+  merged.merge(other);
+  QCOMPARE(framesToStringList(merged), framesToStringList(expected));
+
+  FrameCollection emptyExpected;
+  oldMerge(emptyExpected, other);
+  FrameCollection emptyMerged;
+  emptyMerged.merge(other);
+  QCOMPARE(framesToStringList(emptyMerged), framesToStringList(emptyExpected));
+
+  expected = other;
+  oldMerge(expected, frames);
+  merged = other;
+  merged.merge(frames);
+  QCOMPARE(framesToStringList(merged), framesToStringList(expected));
+}
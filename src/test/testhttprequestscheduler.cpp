@@ -0,0 +1,295 @@
+/**
+ * \file testhttprequestscheduler.cpp
+ * Test scheduling of HTTP requests.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testhttprequestscheduler.h"
+#include <QTest>
+#include <QNetworkAccessManager>
+#include <QNetworkRequest>
+#include <QNetworkReply>
+#include <QStandardPaths>
+#include <QElapsedTimer>
+#include <QTimer>
+#include <QScopedPointer>
+#include "dummysettings.h"
+#include "configstore.h"
+#include "networkconfig.h"
+#include "httpclient.h"
+#include "httprequestscheduler.h"
+#include "httpresponsecache.h"
+
+namespace {
+
+/**
+ * Network reply which returns its URL as the body after a delay.
+ */
+class FakeNetworkReply : public QNetworkReply {
+public:
+  FakeNetworkReply(const QNetworkRequest& request, int delayMs,
+                   QObject* parent)
+    : QNetworkReply(parent), m_data(request.url().toEncoded()), m_pos(0)
+  {
+    setRequest(request);
+    setUrl(request.url());
+    setOperation(QNetworkAccessManager::GetOperation);
+    open(QIODevice::ReadOnly);
+    setAttribute(QNetworkRequest::HttpStatusCodeAttribute, 200);
+    setHeader(QNetworkRequest::ContentTypeHeader, QLatin1String("text/plain"));
+    setHeader(QNetworkRequest::ContentLengthHeader, m_data.size());
+    QTimer::singleShot(delayMs, this, [this]() {
+      setFinished(true);
+      emit finished();
+    });
+  }
+
+  void abort() override {}
+
+  qint64 bytesAvailable() const override {
+    return m_data.size() - m_pos + QIODevice::bytesAvailable();
+  }
+
+  bool isSequential() const override { return true; }
+
+protected:
+  qint64 readData(char* data, qint64 maxSize) override {
+    const qint64 len = qMin(maxSize, m_data.size() - m_pos);
+    if (len <= 0) {
+      return -1;
+    }
+    memcpy(data, m_data.constData() + m_pos, static_cast<size_t>(len));
+    m_pos += len;
+    return len;
+  }
+
+private:
+  QByteArray m_data;
+  qint64 m_pos;
+};
+
+/**
+ * Network access manager which records the requests and answers them
+ * with FakeNetworkReply.
+ */
+class FakeNetworkAccessManager : public QNetworkAccessManager {
+public:
+  explicit FakeNetworkAccessManager(int replyDelayMs)
+    : m_replyDelayMs(replyDelayMs), m_active(0), m_maxActive(0)
+  {
+    m_elapsed.start();
+  }
+
+  /** Start times of the requests in ms after construction. */
+  QList<qint64> startTimes() const { return m_startTimes; }
+  /** URLs of the requests. */
+  QStringList urls() const { return m_urls; }
+  /** Number of requests. */
+  int numRequests() const { return m_urls.size(); }
+  /** Number of unfinished requests. */
+  int active() const { return m_active; }
+  /** Maximum number of concurrent requests. */
+  int maxActive() const { return m_maxActive; }
+
+protected:
+  QNetworkReply* createRequest(Operation op, const QNetworkRequest& request,
+                               QIODevice* outgoingData) override {
+    Q_UNUSED(op)
+    Q_UNUSED(outgoingData)
+    m_startTimes.append(m_elapsed.elapsed());
+    m_urls.append(request.url().toString());
+    if (++m_active > m_maxActive) {
+      m_maxActive = m_active;
+    }
+    auto reply = new FakeNetworkReply(request, m_replyDelayMs, this);
+    connect(reply, &QNetworkReply::finished, this, [this]() { --m_active; });
+    return reply;
+  }
+
+private:
+  QElapsedTimer m_elapsed;
+  QList<qint64> m_startTimes;
+  QStringList m_urls;
+  int m_replyDelayMs;
+  int m_active;
+  int m_maxActive;
+};
+
+/**
+ * Send requests to a server, each with a separate client.
+ * @param netMgr network access manager
+ * @param host host name of server
+ * @param numRequests number of requests
+ */
+void sendRequests(QNetworkAccessManager* netMgr, const QString& host,
+                  int numRequests)
+{
+  for (int i = 0; i < numRequests; ++i) {
+    auto client = new HttpClient(netMgr);
+    client->sendRequest(QUrl(QString(QLatin1String("http://%1/%2"))
+                             .arg(host).arg(i)));
+  }
+}
+
+}
+
+TestHttpRequestScheduler::TestHttpRequestScheduler(QObject* parent)
+  : QObject(parent), m_settings(nullptr), m_configStore(nullptr)
+{
+  if (!ConfigStore::instance()) {
+    m_settings = new DummySettings;
+    m_configStore = new ConfigStore(m_settings);
+  }
+}
+
+TestHttpRequestScheduler::~TestHttpRequestScheduler()
+{
+  delete m_configStore;
+  delete m_settings;
+}
+
+void TestHttpRequestScheduler::initTestCase()
+{
+  // Do not touch the response cache of the user.
+  QStandardPaths::setTestModeEnabled(true);
+}
+
+void TestHttpRequestScheduler::testRateLimit()
+{
+  const QString host = QLatin1String("rate.example.com");
+  HttpRequestScheduler::setHostLimits(host, 200);
+  QScopedPointer<FakeNetworkAccessManager> netMgr(
+        new FakeNetworkAccessManager(10));
+  sendRequests(netMgr.data(), host, 3);
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->numRequests(), 3, 5000);
+  const QList<qint64> startTimes = netMgr->startTimes();
+  QVERIFY(startTimes.at(1) - startTimes.at(0) >= 190);
+  QVERIFY(startTimes.at(2) - startTimes.at(1) >= 190);
+  QCOMPARE(netMgr->maxActive(), 1);
+}
+
+void TestHttpRequestScheduler::testBurst()
+{
+  const QString host = QLatin1String("burst.example.com");
+  HttpRequestScheduler::setHostLimits(host, 300, 3, 3);
+  QScopedPointer<FakeNetworkAccessManager> netMgr(
+        new FakeNetworkAccessManager(10));
+  sendRequests(netMgr.data(), host, 5);
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->numRequests(), 5, 5000);
+  const QList<qint64> startTimes = netMgr->startTimes();
+  QVERIFY(startTimes.at(2) - startTimes.at(0) < 150);
+  QVERIFY(startTimes.at(3) - startTimes.at(0) >= 290);
+  QVERIFY(startTimes.at(4) - startTimes.at(3) >= 290);
+}
+
+void TestHttpRequestScheduler::testMaxConcurrent()
+{
+  const QString host = QLatin1String("concurrent.example.com");
+  HttpRequestScheduler::setHostLimits(host, 0, 1, 2);
+  QScopedPointer<FakeNetworkAccessManager> netMgr(
+        new FakeNetworkAccessManager(100));
+  sendRequests(netMgr.data(), host, 5);
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->numRequests(), 5, 5000);
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->active(), 0, 5000);
+  QCOMPARE(netMgr->maxActive(), 2);
+}
+
+void TestHttpRequestScheduler::testIndependentHosts()
+{
+  const QString slowHost = QLatin1String("slow.example.com");
+  const QString fastHost = QLatin1String("fast.example.com");
+  HttpRequestScheduler::setHostLimits(slowHost, 1000);
+  QScopedPointer<FakeNetworkAccessManager> netMgr(
+        new FakeNetworkAccessManager(10));
+  sendRequests(netMgr.data(), slowHost, 2);
+  sendRequests(netMgr.data(), fastHost, 1);
+
+  // The request to the other server does not wait for the queued request.
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->numRequests(), 2, 500);
+  QVERIFY(netMgr->urls().at(1).contains(fastHost));
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->numRequests(), 3, 5000);
+  QVERIFY(netMgr->urls().at(2).contains(slowHost));
+}
+
+void TestHttpRequestScheduler::testReplaceQueuedRequest()
+{
+  const QString host = QLatin1String("replace.example.com");
+  HttpRequestScheduler::setHostLimits(host, 300);
+  QScopedPointer<FakeNetworkAccessManager> netMgr(
+        new FakeNetworkAccessManager(10));
+  auto client1 = new HttpClient(netMgr.data());
+  auto client2 = new HttpClient(netMgr.data());
+  const QUrl url1(QLatin1String("http://replace.example.com/1"));
+  const QUrl url2(QLatin1String("http://replace.example.com/2"));
+  const QUrl url3(QLatin1String("http://replace.example.com/3"));
+  client1->sendRequest(url1);
+  client2->sendRequest(url2);
+  client2->sendRequest(url3);
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->numRequests(), 2, 5000);
+  QTest::qWait(400);
+  QCOMPARE(netMgr->urls(), QStringList({url1.toString(), url3.toString()}));
+}
+
+void TestHttpRequestScheduler::testCachedResponse()
+{
+  NetworkConfig& networkCfg = NetworkConfig::instance();
+  const bool cacheEnabled = networkCfg.responseCacheEnabled();
+  const int cacheDays = networkCfg.responseCacheDays();
+  const int cacheSize = networkCfg.responseCacheSize();
+  networkCfg.setResponseCacheEnabled(true);
+  networkCfg.setResponseCacheDays(1);
+  networkCfg.setResponseCacheSize(10);
+  HttpResponseCache::instance().clear();
+
+  QScopedPointer<FakeNetworkAccessManager> netMgr(
+        new FakeNetworkAccessManager(10));
+  const QUrl url(QLatin1String("http://cached.example.com/release?id=1"));
+  QByteArray received1, received2;
+  auto client1 = new HttpClient(netMgr.data());
+  client1->setResponseCacheEnabled(true);
+  connect(client1, &HttpClient::bytesReceived,
+          this, [&received1](const QByteArray& data) { received1 = data; });
+  client1->sendRequest(url);
+  QTRY_COMPARE_WITH_TIMEOUT(received1, url.toEncoded(), 5000);
+  QCOMPARE(netMgr->numRequests(), 1);
+
+  // The same request is answered from the cache without being sent.
+  auto client2 = new HttpClient(netMgr.data());
+  client2->setResponseCacheEnabled(true);
+  connect(client2, &HttpClient::bytesReceived,
+          this, [&received2](const QByteArray& data) { received2 = data; });
+  client2->sendRequest(url);
+  QTRY_COMPARE_WITH_TIMEOUT(received2, url.toEncoded(), 5000);
+  QCOMPARE(netMgr->numRequests(), 1);
+
+  // Clients which do not use the cache send the request.
+  auto client3 = new HttpClient(netMgr.data());
+  client3->sendRequest(url);
+  QTRY_COMPARE_WITH_TIMEOUT(netMgr->numRequests(), 2, 5000);
+
+  netMgr.reset();
+  HttpResponseCache::instance().clear();
+  networkCfg.setResponseCacheEnabled(cacheEnabled);
+  networkCfg.setResponseCacheDays(cacheDays);
+  networkCfg.setResponseCacheSize(cacheSize);
+}
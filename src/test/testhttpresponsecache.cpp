@@ -0,0 +1,239 @@
+/**
+ * \file testhttpresponsecache.cpp
+ * Test the disk cache for responses of import servers.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testhttpresponsecache.h"
+#include <QTest>
+#include <QUrl>
+#include <QDir>
+#include <QFile>
+#include <QStandardPaths>
+#include "dummysettings.h"
+#include "configstore.h"
+#include "networkconfig.h"
+#include "httpresponsecache.h"
+
+namespace {
+
+/**
+ * Get paths of the files in the cache directory.
+ * @return absolute file paths.
+ */
+QStringList cacheFilePaths()
+{
+  QStringList paths;
+  const QDir dir(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+        QLatin1String("/responses"));
+  const QFileInfoList fileInfos = dir.entryInfoList(QDir::Files);
+  for (const QFileInfo& fi : fileInfos) {
+    paths.append(fi.absoluteFilePath());
+  }
+  return paths;
+}
+
+/**
+ * Enable or disable the cache.
+ * @param enable true to enable
+ */
+void setCacheEnabled(bool enable)
+{
+  NetworkConfig& networkCfg = NetworkConfig::instance();
+  networkCfg.setResponseCacheEnabled(enable);
+  networkCfg.setResponseCacheDays(7);
+  networkCfg.setResponseCacheSize(10);
+}
+
+}
+
+TestHttpResponseCache::TestHttpResponseCache(QObject* parent)
+  : QObject(parent), m_settings(nullptr), m_configStore(nullptr),
+    m_cacheEnabled(false), m_cacheDays(0), m_cacheSize(0)
+{
+  if (!ConfigStore::instance()) {
+    m_settings = new DummySettings;
+    m_configStore = new ConfigStore(m_settings);
+  }
+}
+
+TestHttpResponseCache::~TestHttpResponseCache()
+{
+  delete m_configStore;
+  delete m_settings;
+}
+
+void TestHttpResponseCache::initTestCase()
+{
+  // Do not touch the cache of the user.
+  QStandardPaths::setTestModeEnabled(true);
+  const NetworkConfig& networkCfg = NetworkConfig::instance();
+  m_cacheEnabled = networkCfg.responseCacheEnabled();
+  m_cacheDays = networkCfg.responseCacheDays();
+  m_cacheSize = networkCfg.responseCacheSize();
+}
+
+void TestHttpResponseCache::cleanupTestCase()
+{
+  HttpResponseCache::instance().clear();
+  NetworkConfig& networkCfg = NetworkConfig::instance();
+  networkCfg.setResponseCacheEnabled(m_cacheEnabled);
+  networkCfg.setResponseCacheDays(m_cacheDays);
+  networkCfg.setResponseCacheSize(m_cacheSize);
+}
+
+void TestHttpResponseCache::init()
+{
+  setCacheEnabled(true);
+  HttpResponseCache::instance().clear();
+}
+
+void TestHttpResponseCache::testCacheKey()
+{
+  const QUrl url(QLatin1String("https://api.discogs.com/releases/1"));
+  QMap<QByteArray, QByteArray> headers;
+  const QByteArray key = HttpResponseCache::cacheKey(url, headers);
+  QCOMPARE(key.size(), 64);
+  QCOMPARE(QByteArray::fromHex(key).toHex(), key);
+
+  // The user agent does not change the response.
+  headers.insert("User-Agent", "Kid3/3.9");
+  QCOMPARE(HttpResponseCache::cacheKey(url, headers), key);
+  headers.insert("Authorization", "Discogs token=secret");
+  const QByteArray authKey = HttpResponseCache::cacheKey(url, headers);
+  QVERIFY(authKey != key);
+  headers.insert("Authorization", "Discogs token=other");
+  QVERIFY(HttpResponseCache::cacheKey(url, headers) != authKey);
+  QVERIFY(HttpResponseCache::cacheKey(
+            QUrl(QLatin1String("https://api.discogs.com/releases/2")),
+            QMap<QByteArray, QByteArray>()) != key);
+}
+
+void TestHttpResponseCache::testDisabled()
+{
+  setCacheEnabled(false);
+  QVERIFY(!HttpResponseCache::isEnabled());
+  HttpResponseCache& cache = HttpResponseCache::instance();
+  const QByteArray key = HttpResponseCache::cacheKey(
+        QUrl(QLatin1String("http://example.com/disabled")),
+        QMap<QByteArray, QByteArray>());
+  cache.insert(key, "data", QLatin1String("text/plain"));
+  QVERIFY(cacheFilePaths().isEmpty());
+  QByteArray data;
+  QString contentType;
+  QVERIFY(!cache.find(key, data, contentType));
+
+  // A maximum size of 0 also disables the cache.
+  setCacheEnabled(true);
+  NetworkConfig::instance().setResponseCacheSize(0);
+  QVERIFY(!HttpResponseCache::isEnabled());
+}
+
+void TestHttpResponseCache::testInsertAndFind()
+{
+  QVERIFY(HttpResponseCache::isEnabled());
+  HttpResponseCache& cache = HttpResponseCache::instance();
+  const QByteArray key = HttpResponseCache::cacheKey(
+        QUrl(QLatin1String("http://example.com/found")),
+        QMap<QByteArray, QByteArray>());
+  const QByteArray otherKey = HttpResponseCache::cacheKey(
+        QUrl(QLatin1String("http://example.com/not-found")),
+        QMap<QByteArray, QByteArray>());
+  const QByteArray stored("{\"releases\": []}");
+  cache.insert(key, stored, QLatin1String("application/json"));
+
+  QByteArray data;
+  QString contentType;
+  QVERIFY(cache.find(key, data, contentType));
+  QCOMPARE(data, stored);
+  QCOMPARE(contentType, QLatin1String("application/json"));
+  QVERIFY(!cache.find(otherKey, data, contentType));
+
+  // A stored response is replaced.
+  cache.insert(key, "{}", QLatin1String("application/json"));
+  QVERIFY(cache.find(key, data, contentType));
+  QCOMPARE(data, QByteArray("{}"));
+  QCOMPARE(cacheFilePaths().size(), 1);
+}
+
+void TestHttpResponseCache::testNoCredentialsStored()
+{
+  QMap<QByteArray, QByteArray> headers;
+  headers.insert("Authorization", "Discogs token=verysecrettoken");
+  const QByteArray key = HttpResponseCache::cacheKey(
+        QUrl(QLatin1String("https://api.discogs.com/database/search")),
+        headers);
+  HttpResponseCache::instance().insert(key, "response",
+                                       QLatin1String("text/plain"));
+  const QStringList paths = cacheFilePaths();
+  QCOMPARE(paths.size(), 1);
+  QFile file(paths.first());
+  QVERIFY(file.open(QIODevice::ReadOnly));
+  const QByteArray contents = file.readAll();
+  QVERIFY(contents.contains("response"));
+  QVERIFY(!contents.contains("verysecrettoken"));
+}
+
+void TestHttpResponseCache::testClear()
+{
+  HttpResponseCache& cache = HttpResponseCache::instance();
+  const QByteArray key = HttpResponseCache::cacheKey(
+        QUrl(QLatin1String("http://example.com/clear")),
+        QMap<QByteArray, QByteArray>());
+  cache.insert(key, "data", QLatin1String("text/plain"));
+  QByteArray data;
+  QString contentType;
+  QVERIFY(cache.find(key, data, contentType));
+  cache.clear();
+  QVERIFY(!cache.find(key, data, contentType));
+  QVERIFY(cacheFilePaths().isEmpty());
+}
+
+void TestHttpResponseCache::testLimitSize()
+{
+  NetworkConfig::instance().setResponseCacheSize(1);
+  HttpResponseCache& cache = HttpResponseCache::instance();
+  const QByteArray data(600 * 1024, 'x');
+  QList<QByteArray> keys;
+  for (int i = 0; i < 3; ++i) {
+    const QByteArray key = HttpResponseCache::cacheKey(
+          QUrl(QString(QLatin1String("http://example.com/large/%1")).arg(i)),
+          QMap<QByteArray, QByteArray>());
+    cache.insert(key, data, QLatin1String("text/plain"));
+    keys.append(key);
+  }
+
+  // The size is limited to 1 MB, so only one response is kept.
+  int numFound = 0;
+  for (const QByteArray& key : std::as_const(keys)) {
+    QByteArray foundData;
+    QString contentType;
+    if (cache.find(key, foundData, contentType)) {
+      QCOMPARE(foundData, data);
+      ++numFound;
+    }
+  }
+  QCOMPARE(numFound, 1);
+  QCOMPARE(cacheFilePaths().size(), 1);
+}
@@ -0,0 +1,60 @@
+/**
+ * \file testhttpresponsecache.h
+ * Test the disk cache for responses of import servers.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+
+class ISettings;
+class ConfigStore;
+
+/**
+ * Test the disk cache for responses of import servers.
+ */
+class TestHttpResponseCache : public QObject {
+  Q_OBJECT
+public:
+  explicit TestHttpResponseCache(QObject* parent = nullptr);
+  ~TestHttpResponseCache() override;
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void init();
+  void testCacheKey();
+  void testDisabled();
+  void testInsertAndFind();
+  void testNoCredentialsStored();
+  void testClear();
+  void testLimitSize();
+
+private:
+  ISettings* m_settings;
+  ConfigStore* m_configStore;
+  bool m_cacheEnabled;
+  int m_cacheDays;
+  int m_cacheSize;
+};
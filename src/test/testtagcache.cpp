@@ -0,0 +1,324 @@
+/**
+ * \file testtagcache.cpp
+ * Test the persistent tag cache.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testtagcache.h"
+#include <QTest>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QFile>
+#include <QDir>
+#include "tagcache.h"
+#include "pictureframe.h"
+
+namespace {
+
+/**
+ * Create a cache entry with information for all tags.
+ * @return cache entry.
+ */
+TagCache::Entry createEntry()
+{
+  TagCache::Entry entry;
+  entry.context = QLatin1String("TaglibMetadata 1");
+  entry.fileExtension = QLatin1String(".mp3");
+  TaggedFile::DetailInfo& info = entry.detailInfo;
+  info.format = QLatin1String("MPEG 1 Layer 3");
+  info.channelMode = TaggedFile::DetailInfo::CM_JointStereo;
+  info.channels = 2;
+  info.sampleRate = 44100;
+  info.bitrate = 192;
+  info.duration = 245;
+  info.valid = true;
+  info.vbr = true;
+  TagCache::Tag& tag1 = entry.tags[Frame::Tag_1];
+  tag1.format = QLatin1String("ID3v1.1");
+  tag1.type = TaggedFile::TT_Id3v1;
+  tag1.supported = true;
+  tag1.hasTag = true;
+  tag1.values = QStringList{
+    QLatin1String("Title"), QLatin1String("Artist"), QLatin1String("Album"),
+    QString(), QLatin1String("2026"), QLatin1String("3"),
+    QLatin1String("Rock")
+  };
+  TagCache::Tag& tag2 = entry.tags[Frame::Tag_2];
+  tag2.format = QLatin1String("ID3v2.4.0");
+  tag2.type = TaggedFile::TT_Id3v2;
+  tag2.supported = true;
+  tag2.hasTag = true;
+  tag2.values = QStringList{QString::fromUtf8("T\xc3\xadtulo")};
+  tag2.frames = QByteArray("\x00\x01\x02", 3);
+  return entry;
+}
+
+/**
+ * Compare two frame collections including their fields.
+ * @param frames1 frames
+ * @param frames2 frames
+ * @return true if equal.
+ */
+bool framesEqual(const FrameCollection& frames1,
+                 const FrameCollection& frames2)
+{
+  if (frames1.size() != frames2.size()) {
+    return false;
+  }
+  for (auto it1 = frames1.cbegin(), it2 = frames2.cbegin();
+       it1 != frames1.cend(); ++it1, ++it2) {
+    if (!(it1->getExtendedType() == it2->getExtendedType()) ||
+        it1->getInternalName() != it2->getInternalName() ||
+        it1->getIndex() != it2->getIndex() ||
+        it1->getValue() != it2->getValue() ||
+        !(it1->getFieldList() == it2->getFieldList())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+}
+
+TestTagCache::TestTagCache(QObject* parent)
+  : QObject(parent), m_dir(nullptr)
+{
+}
+
+TestTagCache::~TestTagCache()
+{
+  delete m_dir;
+}
+
+void TestTagCache::initTestCase()
+{
+  // Do not touch the cache of the user.
+  QStandardPaths::setTestModeEnabled(true);
+  m_dir = new QTemporaryDir;
+  QVERIFY(m_dir->isValid());
+  TagCache::instance().clear();
+}
+
+void TestTagCache::cleanupTestCase()
+{
+  TagCache::instance().clear();
+  delete m_dir;
+  m_dir = nullptr;
+}
+
+QString TestTagCache::createFile(const QString& fileName)
+{
+  const QString filePath = QDir(m_dir->path()).filePath(fileName);
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return QString();
+  }
+  file.write("audio data");
+  file.close();
+  return filePath;
+}
+
+void TestTagCache::testStoreAndLookup()
+{
+  const QString filePath = createFile(QLatin1String("lookup.mp3"));
+  QVERIFY(!filePath.isEmpty());
+  TagCache& cache = TagCache::instance();
+  const TagCache::Entry stored = createEntry();
+  QVERIFY(!cache.contains(filePath, stored.context));
+  cache.store(filePath, stored);
+  QVERIFY(cache.contains(filePath, stored.context));
+
+  TagCache::Entry entry;
+  QVERIFY(cache.lookup(filePath, stored.context, entry));
+  QCOMPARE(entry.context, stored.context);
+  QCOMPARE(entry.fileExtension, stored.fileExtension);
+  QCOMPARE(entry.detailInfo.format, stored.detailInfo.format);
+  QCOMPARE(entry.detailInfo.channelMode, stored.detailInfo.channelMode);
+  QCOMPARE(entry.detailInfo.channels, stored.detailInfo.channels);
+  QCOMPARE(entry.detailInfo.sampleRate, stored.detailInfo.sampleRate);
+  QCOMPARE(entry.detailInfo.bitrate, stored.detailInfo.bitrate);
+  QCOMPARE(entry.detailInfo.duration, stored.detailInfo.duration);
+  QCOMPARE(entry.detailInfo.valid, stored.detailInfo.valid);
+  QCOMPARE(entry.detailInfo.vbr, stored.detailInfo.vbr);
+  FOR_ALL_TAGS(tagNr) {
+    const TagCache::Tag& tag = entry.tags[tagNr];
+    const TagCache::Tag& storedTag = stored.tags[tagNr];
+    QCOMPARE(tag.format, storedTag.format);
+    QCOMPARE(tag.type, storedTag.type);
+    QCOMPARE(tag.supported, storedTag.supported);
+    QCOMPARE(tag.hasTag, storedTag.hasTag);
+    QCOMPARE(tag.values, storedTag.values);
+    QCOMPARE(tag.frames, storedTag.frames);
+  }
+
+  // An entry created by another backend or with other settings is not used.
+  const QString otherContext = QLatin1String("TaglibMetadata 2");
+  QVERIFY(!cache.contains(filePath, otherContext));
+  QVERIFY(!cache.lookup(filePath, otherContext, entry));
+  QVERIFY(!cache.lookup(filePath + QLatin1String(".none"), stored.context,
+                        entry));
+}
+
+void TestTagCache::testOutdatedEntry()
+{
+  const QString filePath = createFile(QLatin1String("outdated.mp3"));
+  QVERIFY(!filePath.isEmpty());
+  TagCache& cache = TagCache::instance();
+  const TagCache::Entry stored = createEntry();
+  cache.store(filePath, stored);
+  TagCache::Entry entry;
+  QVERIFY(cache.lookup(filePath, stored.context, entry));
+
+  QFile file(filePath);
+  QVERIFY(file.open(QIODevice::Append));
+  file.write("more data");
+  file.close();
+  QVERIFY(!cache.contains(filePath, stored.context));
+  QVERIFY(!cache.lookup(filePath, stored.context, entry));
+
+  // Storing the entry again makes it valid for the changed file.
+  cache.store(filePath, stored);
+  QVERIFY(cache.lookup(filePath, stored.context, entry));
+
+  QVERIFY(QFile::remove(filePath));
+  QVERIFY(!cache.lookup(filePath, stored.context, entry));
+}
+
+void TestTagCache::testFramesRoundTrip()
+{
+  FrameCollection frames;
+  frames.insert(Frame(Frame::FT_Title, QString::fromUtf8("T\xc3\xadtulo"),
+                      QLatin1String("TIT2"), 0));
+  frames.insert(Frame(Frame::FT_Track, QLatin1String("3/12"),
+                      QLatin1String("TRCK"), 1));
+  frames.insert(Frame(Frame::ExtendedType(Frame::FT_Other,
+                                          QLatin1String("TXXX\nBARCODE")),
+                      QLatin1String("123456"), 2));
+  Frame comment(Frame::FT_Comment, QLatin1String("Comment"),
+                QLatin1String("COMM"), 3);
+  Frame::Field field;
+  field.m_id = Frame::ID_Language;
+  field.m_value = QLatin1String("eng");
+  comment.fieldList().append(field);
+  field.m_id = Frame::ID_Description;
+  field.m_value = QLatin1String("");
+  comment.fieldList().append(field);
+  field.m_id = Frame::ID_Text;
+  field.m_value = QLatin1String("Comment");
+  comment.fieldList().append(field);
+  frames.insert(comment);
+  PictureFrame picture(QByteArray(100, '\xff'));
+  picture.setIndex(4);
+  frames.insert(picture);
+
+  const QByteArray data = TagCache::framesToData(frames, 1 << 20);
+  QVERIFY(!data.isEmpty());
+  FrameCollection restored;
+  QVERIFY(TagCache::framesFromData(data, restored));
+  QVERIFY(framesEqual(restored, frames));
+
+  QVERIFY(TagCache::framesFromData(TagCache::framesToData(FrameCollection(),
+                                                          1 << 20),
+                                   restored));
+  QVERIFY(restored.empty());
+
+  // Truncated data is detected.
+  QVERIFY(!TagCache::framesFromData(data.left(data.size() / 2), restored));
+}
+
+void TestTagCache::testFramesMaxSize()
+{
+  FrameCollection frames;
+  PictureFrame picture(QByteArray(1000, 'x'));
+  frames.insert(picture);
+  QVERIFY(!TagCache::framesToData(frames, 2000).isEmpty());
+  QVERIFY(TagCache::framesToData(frames, 500).isEmpty());
+}
+
+void TestTagCache::testClear()
+{
+  const QString filePath = createFile(QLatin1String("clear.mp3"));
+  QVERIFY(!filePath.isEmpty());
+  TagCache& cache = TagCache::instance();
+  const TagCache::Entry stored = createEntry();
+  cache.store(filePath, stored);
+  QVERIFY(cache.contains(filePath, stored.context));
+  cache.clear();
+  QVERIFY(!cache.contains(filePath, stored.context));
+  TagCache::Entry entry;
+  QVERIFY(!cache.lookup(filePath, stored.context, entry));
+}
+
+void TestTagCache::testSharedCacheFile()
+{
+  TagCache& cache = TagCache::instance();
+  cache.clear();
+  const QString filePath1 = createFile(QLatin1String("shared1.mp3"));
+  const QString filePath2 = createFile(QLatin1String("shared2.mp3"));
+  const QString filePath3 = createFile(QLatin1String("shared3.mp3"));
+  QVERIFY(!filePath1.isEmpty() && !filePath2.isEmpty() &&
+          !filePath3.isEmpty());
+  const TagCache::Entry stored = createEntry();
+  const QString& context = stored.context;
+
+  // The cache file is modified like another process would do it.
+  QFile cacheFile(
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) +
+        QLatin1String("/tagcache.dat"));
+  QVERIFY(cacheFile.open(QIODevice::ReadWrite));
+  const qint64 headerSize = cacheFile.size();
+  cache.store(filePath1, stored);
+  const qint64 endOfRecord1 = cacheFile.size();
+  cache.store(filePath2, stored);
+  QVERIFY(cacheFile.seek(0));
+  const QByteArray contents = cacheFile.readAll();
+  const QByteArray record1 =
+      contents.mid(headerSize, endOfRecord1 - headerSize);
+  const QByteArray record2 = contents.mid(endOfRecord1);
+  QCOMPARE(record1.size(), record2.size());
+
+  // Another process clears the cache and stores the second file, its entry
+  // is now at the position of the entry of the first file.
+  QVERIFY(cacheFile.resize(headerSize));
+  QVERIFY(cacheFile.seek(headerSize));
+  QCOMPARE(cacheFile.write(record2), record2.size());
+  QVERIFY(cacheFile.flush());
+  TagCache::Entry entry;
+  QVERIFY(!cache.lookup(filePath1, context, entry));
+
+  // The records of the other process are read before appending.
+  cache.store(filePath3, stored);
+  QVERIFY(cache.lookup(filePath2, context, entry));
+  QVERIFY(cache.lookup(filePath3, context, entry));
+  QVERIFY(!cache.lookup(filePath1, context, entry));
+
+  // Another process appends the first file.
+  QVERIFY(cacheFile.seek(cacheFile.size()));
+  QCOMPARE(cacheFile.write(record1), record1.size());
+  QVERIFY(cacheFile.flush());
+  cache.store(filePath3, stored);
+  QVERIFY(cache.lookup(filePath1, context, entry));
+  QCOMPARE(entry.detailInfo.format, stored.detailInfo.format);
+  QCOMPARE(entry.tags[Frame::Tag_2].values, stored.tags[Frame::Tag_2].values);
+  cacheFile.close();
+}
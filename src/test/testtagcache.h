@@ -0,0 +1,56 @@
+/**
+ * \file testtagcache.h
+ * Test the persistent tag cache.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <QObject>
+
+class QTemporaryDir;
+
+/**
+ * Test the persistent tag cache.
+ */
+class TestTagCache : public QObject {
+  Q_OBJECT
+public:
+  explicit TestTagCache(QObject* parent = nullptr);
+  ~TestTagCache() override;
+
+private slots:
+  void initTestCase();
+  void cleanupTestCase();
+  void testStoreAndLookup();
+  void testOutdatedEntry();
+  void testFramesRoundTrip();
+  void testFramesMaxSize();
+  void testClear();
+  void testSharedCacheFile();
+
+private:
+  QString createFile(const QString& fileName);
+
+  QTemporaryDir* m_dir;
+};
@@ -0,0 +1,206 @@
+/**
+ * \file testtagsearchindex.cpp
+ * Test the trigram index used to skip files when searching.
+ *
+ * \b Project: Kid3
+ * \author Urs Fleisch
+ * \date 16 Oct 2026
+ *
+ * Copyright (C) 2026  Urs Fleisch
+ *
+ * This file is part of Kid3.
+ *
+ * Kid3 is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * Kid3 is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "testtagsearchindex.h"
+#include <QTest>
+#include <QTemporaryDir>
+#include <QStandardPaths>
+#include <QFile>
+#include <QDir>
+#include <QScopedPointer>
+#include "dummysettings.h"
+#include "dummytaggedfile.h"
+#include "configstore.h"
+#include "tagconfig.h"
+#include "coretaggedfileiconprovider.h"
+#include "taggedfilesystemmodel.h"
+#include "tagsearchindex.h"
+
+TestTagSearchIndex::TestTagSearchIndex(QObject* parent)
+  : QObject(parent), m_settings(nullptr), m_configStore(nullptr),
+    m_dir(nullptr), m_iconProvider(nullptr), m_model(nullptr)
+{
+  if (!ConfigStore::instance()) {
+    m_settings = new DummySettings;
+    m_configStore = new ConfigStore(m_settings);
+  }
+}
+
+TestTagSearchIndex::~TestTagSearchIndex()
+{
+  delete m_configStore;
+  delete m_settings;
+}
+
+void TestTagSearchIndex::initTestCase()
+{
+  // The index is only stored if the tag cache is enabled, do not touch the
+  // cache of the user anyway.
+  QStandardPaths::setTestModeEnabled(true);
+  QVERIFY(!TagConfig::instance().tagCacheEnabled());
+  m_dir = new QTemporaryDir;
+  QVERIFY(m_dir->isValid());
+  m_iconProvider = new CoreTaggedFileIconProvider;
+  m_model = new TaggedFileSystemModel(m_iconProvider);
+  m_model->setRootPath(m_dir->path());
+}
+
+void TestTagSearchIndex::cleanupTestCase()
+{
+  delete m_model;
+  m_model = nullptr;
+  delete m_iconProvider;
+  m_iconProvider = nullptr;
+  delete m_dir;
+  m_dir = nullptr;
+}
+
+DummyTaggedFile* TestTagSearchIndex::createTaggedFile(const QString& fileName)
+{
+  const QString filePath = QDir(m_dir->path()).filePath(fileName);
+  QFile file(filePath);
+  if (!file.open(QIODevice::WriteOnly)) {
+    return nullptr;
+  }
+  file.write("audio data");
+  file.close();
+  auto taggedFile = new DummyTaggedFile(
+        QPersistentModelIndex(m_model->index(filePath)));
+  taggedFile->readTags(false);
+  return taggedFile;
+}
+
+void TestTagSearchIndex::testTrigramHashes()
+{
+  QVERIFY(TagSearchIndex::trigramHashes(QString()).isEmpty());
+  QVERIFY(TagSearchIndex::trigramHashes(QLatin1String("ab")).isEmpty());
+  QCOMPARE(TagSearchIndex::trigramHashes(QLatin1String("abc")).size(), 1);
+  QCOMPARE(TagSearchIndex::trigramHashes(QLatin1String("abcde")).size(), 3);
+  QCOMPARE(TagSearchIndex::trigramHashes(QLatin1String("AbC")),
+           TagSearchIndex::trigramHashes(QLatin1String("abc")));
+  QCOMPARE(TagSearchIndex::trigramHashes(QString::fromUtf8("STRA\xc3\x9f")),
+           TagSearchIndex::trigramHashes(QString::fromUtf8("stra\xc3\x9f")));
+  QVERIFY(TagSearchIndex::trigramHashes(QLatin1String("abc")) !=
+          TagSearchIndex::trigramHashes(QLatin1String("abd")));
+}
+
+void TestTagSearchIndex::testNoFalseNegatives()
+{
+  QScopedPointer<DummyTaggedFile> taggedFile(
+        createTaggedFile(QLatin1String("Index Test.mp3")));
+  QVERIFY(taggedFile);
+  const QStringList values{
+    QLatin1String("Stairway to Heaven"), QLatin1String("Led Zeppelin"),
+    QString::fromUtf8("Gr\xc3\xb6\xc3\x9f" "te Hits"),
+    QLatin1String("1971")
+  };
+  const Frame::Type types[] = {
+    Frame::FT_Title, Frame::FT_Artist, Frame::FT_Album, Frame::FT_Date
+  };
+  for (int i = 0; i < values.size(); ++i) {
+    Frame frame(types[i], values.at(i), QString(), -1);
+    taggedFile->addFrame(i % 2 ? Frame::Tag_1 : Frame::Tag_2, frame);
+  }
+  QCOMPARE(taggedFile->writeTags(false, nullptr, false), true);
+
+  TagSearchIndex& index = TagSearchIndex::instance();
+  QCOMPARE(index.check(taggedFile.data(),
+                       TagSearchIndex::trigramHashes(QLatin1String("Stair"))),
+           TagSearchIndex::Unknown);
+  index.update(taggedFile.data());
+
+  // Every text contained in a value or the file name may match.
+  QStringList texts(values);
+  texts.append(taggedFile->getFilename());
+  for (const QString& text : std::as_const(texts)) {
+    for (int len = 3; len <= text.length(); ++len) {
+      for (int pos = 0; pos + len <= text.length(); ++pos) {
+        const QString part = text.mid(pos, len);
+        QVERIFY2(index.check(taggedFile.data(),
+                             TagSearchIndex::trigramHashes(part)) ==
+                 TagSearchIndex::PossibleMatch, qPrintable(part));
+        QVERIFY2(index.check(taggedFile.data(),
+                             TagSearchIndex::trigramHashes(part.toUpper())) ==
+                 TagSearchIndex::PossibleMatch, qPrintable(part));
+      }
+    }
+  }
+
+  QCOMPARE(index.check(taggedFile.data(),
+                       TagSearchIndex::trigramHashes(
+                         QLatin1String("qqqqzzzzxxxx"))),
+           TagSearchIndex::NoMatch);
+  // A text which is too short to use the index must be searched.
+  QCOMPARE(index.check(taggedFile.data(),
+                       TagSearchIndex::trigramHashes(QLatin1String("qz"))),
+           TagSearchIndex::Unknown);
+  index.remove(taggedFile->getAbsFilename());
+}
+
+void TestTagSearchIndex::testOutdatedEntries()
+{
+  QScopedPointer<DummyTaggedFile> taggedFile(
+        createTaggedFile(QLatin1String("outdated.mp3")));
+  QVERIFY(taggedFile);
+  Frame frame(Frame::FT_Title, QLatin1String("Bohemian Rhapsody"), QString(),
+              -1);
+  taggedFile->addFrame(Frame::Tag_2, frame);
+  QCOMPARE(taggedFile->writeTags(false, nullptr, false), true);
+
+  TagSearchIndex& index = TagSearchIndex::instance();
+  const QVector<quint64> hashes =
+      TagSearchIndex::trigramHashes(QLatin1String("xxxyyyzzz"));
+  index.update(taggedFile.data());
+  QCOMPARE(index.check(taggedFile.data(), hashes), TagSearchIndex::NoMatch);
+
+  // The values of a modified file are not in the index.
+  Frame changedFrame(Frame::FT_Title, QLatin1String("xxxyyyzzz"), QString(),
+                     -1);
+  taggedFile->setFrame(Frame::Tag_2, changedFrame);
+  QCOMPARE(index.check(taggedFile.data(), hashes), TagSearchIndex::Unknown);
+  taggedFile->setFrame(Frame::Tag_2, frame);
+  QCOMPARE(taggedFile->writeTags(false, nullptr, false), true);
+  QCOMPARE(index.check(taggedFile.data(), hashes), TagSearchIndex::NoMatch);
+
+  // A file changed on disk is read again.
+  QFile file(taggedFile->getAbsFilename());
+  QVERIFY(file.open(QIODevice::Append));
+  file.write("more data");
+  file.close();
+  QCOMPARE(index.check(taggedFile.data(), hashes), TagSearchIndex::Unknown);
+  index.update(taggedFile.data());
+  QCOMPARE(index.check(taggedFile.data(), hashes), TagSearchIndex::NoMatch);
+
+  // The values of ID3v1 tags depend on the configured text encoding.
+  TagConfig& tagCfg = TagConfig::instance();
+  const QString textEncodingV1 = tagCfg.textEncodingV1();
+  tagCfg.setTextEncodingV1(textEncodingV1 == QLatin1String("ISO-8859-1")
+                           ? QLatin1String("UTF-8")
+                           : QLatin1String("ISO-8859-1"));
+  QCOMPARE(index.check(taggedFile.data(), hashes), TagSearchIndex::Unknown);
+  tagCfg.setTextEncodingV1(textEncodingV1);
+  index.remove(taggedFile->getAbsFilename());
+}